@@ -2,94 +2,175 @@
 #define AVL_TREE_h
 
 #include <Arduino.h>
+#include <Stack.h>
+#include <new>
 
-template <typename T>
+// Entries in the fixed Stack the traversals use instead of recursion. An AVL tree of height 32 holds millions of
+// nodes, so the default covers any tree that fits in memory.
+#ifndef AVLTREE_STACK_DEPTH
+#define AVLTREE_STACK_DEPTH 32
+#endif
+
+// Nodes added to the pool at a time when an insert finds it empty. Call reserve() up front to size the pool exactly.
+#ifndef AVLTREE_POOL_CHUNK
+#define AVLTREE_POOL_CHUNK 8
+#endif
+
+/**
+ * @brief Subtree size kept in each node of an AVLTree<T, true>; empty (and free) otherwise
+ * @private
+*/
+template <bool OrderStatistics>
+struct AVLSubtreeSize {
+    size_t count; // nodes in the subtree rooted here
+};
+
+template <>
+struct AVLSubtreeSize<false> {
+};
+
+/**
+ * @brief An AVL tree
+ *
+ * Insert and delete are iterative: they record the links they walk through on a fixed path stack of AVLTREE_STACK_DEPTH
+ * entries and rebalance on the way back up, so neither recurses. Each node keeps its balance factor (-1, 0 or +1) in
+ * one byte instead of a height. The byte is kept apart from the child pointers for simplicity: rotations and retracing
+ * rewrite it at every step, and plain pointers can be followed anywhere without masking. (IntrusiveRedBlackTree does
+ * pack its one colour bit, because its hooks live inside the user's objects.) Nodes come from a pool: chunks of nodes
+ * are allocated together, a deleted node goes on an intrusive free list for the next insert, and the chunks are only
+ * returned by clear() or the destructor. After reserve(n), up to n inserts and any number of deletes never touch the
+ * heap.
+ *
+ * @tparam T The type of the values
+ * @tparam OrderStatistics If true, every node also counts the nodes below it (kept up to date through rotations),
+ * which enables select(), rank(), countInRange() and size() in O(log n) at the cost of a size_t per node
+*/
+template <typename T, bool OrderStatistics = false>
 class AVLTree {
     private:
-        struct AVLNode {
+        struct AVLNode : AVLSubtreeSize<OrderStatistics> {
             T data;
             AVLNode *left;
             AVLNode *right;
-            int height;
+            int8_t balance; // height(left) - height(right)
         };
-        AVLNode *root;
 
-        AVLNode *insert(AVLNode *node, T data){
-            if(node == NULL){
-                AVLNode *newNode = new AVLNode;
-                newNode->data = data;
-                newNode->left = NULL;
-                newNode->right = NULL;
-                newNode->height = 0;
-                return newNode;
-            }
-            if(data < node->data){
-                node->left = insert(node->left, data);
-            } else if(data > node->data){
-                node->right = insert(node->right, data);
-            }
-            node->height = 1 + max(height(node->left), height(node->right));
-            int balance = getBalance(node);
-            if(balance > 1 && data < node->left->data){
-                return rotateRight(node);
-            }
-            if(balance < -1 && data > node->right->data){
-                return rotateLeft(node);
-            }
-            if(balance > 1 && data > node->left->data){
-                node->left = rotateLeft(node->left);
-                return rotateRight(node);
-            }
-            if(balance < -1 && data < node->right->data){
-                node->right = rotateRight(node->right);
-                return rotateLeft(node);
-            }
-            return node;
+        // A pool chunk: this header, then its nodes
+        struct Chunk {
+            Chunk *next;
+        };
+
+        // What a free node holds: the link to the next free node, written over the destroyed AVLNode
+        struct FreeSlot {
+            FreeSlot *next;
+        };
+
+        template <bool B> struct Tag {};
+
+        static size_t count(AVLNode *node){
+            return node == NULL ? 0 : node->count;
         }
 
-        AVLNode *remove(AVLNode *node, T data){
-            if(node == NULL){
-                return node;
-            }
-            if(data < node->data){
-                node->left = remove(node->left, data);
-            } else if(data > node->data){
-                node->right = remove(node->right, data);
+        static void updateCount(AVLNode *node, Tag<true>){
+            node->count = 1 + count(node->left) + count(node->right);
+        }
+
+        static void updateCount(AVLNode *, Tag<false>){
+        }
+
+        // One node was added to (grow) or removed from the subtree of node
+        static void adjustCount(AVLNode *node, bool grow, Tag<true>){
+            if(grow){
+                node->count++;
             } else {
-                if(node->left == NULL || node->right == NULL){
-                    AVLNode *temp = node->left ? node->left : node->right;
-                    if(temp == NULL){
-                        temp = node;
-                        node = NULL;
-                    } else {
-                        *node = *temp;
-                    }
-                    delete temp;
+                node->count--;
+            }
+        }
+
+        static void adjustCount(AVLNode *, bool, Tag<false>){
+        }
+
+        // Number of values less than x (orEqual: less than or equal to x), walking one path from the root
+        size_t countBelow(const T& x, bool orEqual){
+            size_t result = 0;
+            AVLNode *node = root;
+            while(node != NULL){
+                if(node->data < x || (orEqual && !(x < node->data))){
+                    result += count(node->left) + 1;
+                    node = node->right;
                 } else {
-                    AVLNode *temp = findMin(node->right);
-                    node->data = temp->data;
-                    node->right = remove(node->right, temp->data);
+                    node = node->left;
                 }
             }
-            if(node == NULL){
-                return node;
-            }
-            node->height = 1 + max(height(node->left), height(node->right));
-            int balance = getBalance(node);
-            if(balance > 1 && getBalance(node->left) >= 0){
-                return rotateRight(node);
-            }
-            if(balance > 1 && getBalance(node->left) < 0){
-                node->left = rotateLeft(node->left);
-                return rotateRight(node);
-            }
-            if(balance < -1 && getBalance(node->right) <= 0){
-                return rotateLeft(node);
-            }
-            if(balance < -1 && getBalance(node->right) > 0){
-                node->right = rotateRight(node->right);
-                return rotateLeft(node);
-            }
+            return result;
+        }
+
+        AVLNode *root;
+        Chunk *chunks;      // every chunk of the pool
+        FreeSlot *freeList; // nodes ready for reuse
+        size_t freeCount;
+
+        typedef Stack<AVLNode**, AVLTREE_STACK_DEPTH> PathStack;
+
+        static size_t nodesOffset(){
+            return (sizeof(Chunk) + alignof(AVLNode) - 1) / alignof(AVLNode) * alignof(AVLNode);
+        }
+
+        // Allocate a chunk of n nodes and return the first; the nodes are raw memory
+        AVLNode *addChunk(size_t n){
+            void *memory = ::operator new(nodesOffset() + n * sizeof(AVLNode));
+            if(memory == NULL){
+                return NULL;
+            }
+            Chunk *chunk = static_cast<Chunk*>(memory);
+            chunk->next = chunks;
+            chunks = chunk;
+            return reinterpret_cast<AVLNode*>(static_cast<char*>(memory) + nodesOffset());
+        }
+
+        void pushFree(AVLNode *slot){
+            FreeSlot *free = new (static_cast<void*>(slot)) FreeSlot;
+            free->next = freeList;
+            freeList = free;
+            freeCount++;
+        }
+
+        AVLNode *createNode(const T& data){
+            if(freeList == NULL && !reserve(AVLTREE_POOL_CHUNK)){
+                return NULL;
+            }
+            void *slot = freeList;
+            freeList = freeList->next;
+            freeCount--;
+            AVLNode *node = new (slot) AVLNode();
+            node->data = data;
+            node->left = NULL;
+            node->right = NULL;
+            node->balance = 0;
+            updateCount(node, Tag<OrderStatistics>());
+            return node;
+        }
+
+        void freeNode(AVLNode *node){
+            node->~AVLNode();
+            pushFree(node);
+        }
+
+        // Link nodes[lo, hi) (already in order) into a balanced subtree: the middle node is the root. Recursion
+        // depth is log2(hi - lo).
+        AVLNode *linkBalanced(AVLNode *nodes, size_t lo, size_t hi, int &subtreeHeight){
+            if(lo >= hi){
+                subtreeHeight = -1;
+                return NULL;
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            AVLNode *node = nodes + mid;
+            int leftHeight, rightHeight;
+            node->left = linkBalanced(nodes, lo, mid, leftHeight);
+            node->right = linkBalanced(nodes, mid + 1, hi, rightHeight);
+            node->balance = leftHeight - rightHeight;
+            subtreeHeight = 1 + max(leftHeight, rightHeight);
+            updateCount(node, Tag<OrderStatistics>());
             return node;
         }
 
@@ -115,40 +196,26 @@ class AVLTree {
         }
 
         AVLNode *find(AVLNode *node, T data){
-            if(node == NULL){
-                return node;
-            }
-            if(data < node->data){
-                return find(node->left, data);
-            } else if(data > node->data){
-                return find(node->right, data);
-            } else {
-                return node;
-            }
-        }
-
-        int height(AVLNode *node){
-            if(node == NULL){
-                return -1;
-            }
-            return node->height;
-        }
-
-        int getBalance(AVLNode *node){
-            if(node == NULL){
-                return 0;
+            while(node != NULL){
+                if(data < node->data){
+                    node = node->left;
+                } else if(data > node->data){
+                    node = node->right;
+                } else {
+                    return node;
+                }
             }
-            return height(node->left) - height(node->right);
-        
+            return node;
         }
 
+        // Rotations only move links and recompute subtree sizes; rebalance() sets the balance factors.
         AVLNode *rotateRight(AVLNode *node){
             AVLNode *newRoot = node->left;
             AVLNode *temp = newRoot->right;
             newRoot->right = node;
             node->left = temp;
-            node->height = 1 + max(height(node->left), height(node->right));
-            newRoot->height = 1 + max(height(newRoot->left), height(newRoot->right));
+            updateCount(node, Tag<OrderStatistics>());
+            updateCount(newRoot, Tag<OrderStatistics>());
             return newRoot;
         }
 
@@ -157,116 +224,330 @@ class AVLTree {
             AVLNode *temp = newRoot->left;
             newRoot->left = node;
             node->right = temp;
-            node->height = 1 + max(height(node->left), height(node->right));
-            newRoot->height = 1 + max(height(newRoot->left), height(newRoot->right));
+            updateCount(node, Tag<OrderStatistics>());
+            updateCount(newRoot, Tag<OrderStatistics>());
             return newRoot;
         }
 
-        void inOrder(AVLNode *node){
-            if(node == NULL){
-                return;
-            }
-            inOrder(node->left);
-            Serial.println(node->data);
-            inOrder(node->right);
+        /**
+         * @brief Rotate the subtree at *link, whose balance factor is +2 or -2, back into balance
+         * @return bool - true if the subtree is now one level shorter than before the rotation
+        */
+        bool rebalance(AVLNode **link){
+            AVLNode *node = *link;
+            if(node->balance > 0){
+                AVLNode *left = node->left;
+                if(left->balance >= 0){
+                    bool shorter = left->balance > 0; // an even left child (only after a delete) keeps the height
+                    node->balance = shorter ? 0 : 1;
+                    left->balance = shorter ? 0 : -1;
+                    *link = rotateRight(node);
+                    return shorter;
+                }
+                AVLNode *pivot = left->right;
+                node->balance = pivot->balance > 0 ? -1 : 0;
+                left->balance = pivot->balance < 0 ? 1 : 0;
+                pivot->balance = 0;
+                node->left = rotateLeft(left);
+                *link = rotateRight(node);
+                return true;
+            }
+            AVLNode *right = node->right;
+            if(right->balance <= 0){
+                bool shorter = right->balance < 0;
+                node->balance = shorter ? 0 : -1;
+                right->balance = shorter ? 0 : 1;
+                *link = rotateLeft(node);
+                return shorter;
+            }
+            AVLNode *pivot = right->left;
+            node->balance = pivot->balance < 0 ? 1 : 0;
+            right->balance = pivot->balance > 0 ? -1 : 0;
+            pivot->balance = 0;
+            node->right = rotateRight(right);
+            *link = rotateLeft(node);
+            return true;
         }
-        
-        void preOrder(AVLNode *node){
-            if(node == NULL){
-                return;
+
+        /**
+         * @brief Walk back up the path after the subtree at link gained (grow) or lost a node
+         *
+         * Balance factors are fixed until the change in height is absorbed; after that only subtree sizes still
+         * change, so a tree without order statistics stops there.
+        */
+        void retrace(PathStack &path, AVLNode **link, bool grow){
+            bool heightChanged = true;
+            AVLNode **parentLink;
+            while(path.pop(parentLink)){
+                AVLNode *parent = *parentLink;
+                adjustCount(parent, grow, Tag<OrderStatistics>());
+                if(heightChanged){
+                    bool fromLeft = link == &parent->left;
+                    parent->balance += fromLeft == grow ? 1 : -1;
+                    if(parent->balance == 0){
+                        heightChanged = !grow;
+                    } else if(parent->balance == 1 || parent->balance == -1){
+                        heightChanged = grow;
+                    } else {
+                        heightChanged = rebalance(parentLink) && !grow;
+                    }
+                } else if(!OrderStatistics){
+                    return;
+                }
+                link = parentLink;
             }
-            Serial.println(node->data);
-            preOrder(node->left);
-            preOrder(node->right);
         }
 
-        void postOrder(AVLNode *node){
+        void insertValue(const T& data){
+            PathStack path;
+            AVLNode **link = &root;
+            while(*link != NULL){
+                AVLNode *node = *link;
+                if(data < node->data){
+                    if(!path.push(link)){
+                        return;
+                    }
+                    link = &node->left;
+                } else if(data > node->data){
+                    if(!path.push(link)){
+                        return;
+                    }
+                    link = &node->right;
+                } else {
+                    return;
+                }
+            }
+            AVLNode *node = createNode(data);
             if(node == NULL){
                 return;
             }
-            postOrder(node->left);
-            postOrder(node->right);
-            Serial.println(node->data);
+            *link = node;
+            retrace(path, link, true);
         }
 
-        void printTree(AVLNode *node, int space){
-            if(node == NULL){
+        void removeValue(const T& data){
+            PathStack path;
+            AVLNode **link = &root;
+            while(*link != NULL){
+                AVLNode *node = *link;
+                if(data < node->data){
+                    if(!path.push(link)){
+                        return;
+                    }
+                    link = &node->left;
+                } else if(data > node->data){
+                    if(!path.push(link)){
+                        return;
+                    }
+                    link = &node->right;
+                } else {
+                    break;
+                }
+            }
+            AVLNode *target = *link;
+            if(target == NULL){
                 return;
             }
-            space += 10;
-            printTree(node->right, space);
-            Serial.println();
-            for(int i = 10; i < space; i++){
-                Serial.print(" ");
+            if(target->left != NULL && target->right != NULL){
+                // Two children: take the value of the in-order successor and unlink the successor instead
+                if(!path.push(link)){
+                    return;
+                }
+                link = &target->right;
+                while((*link)->left != NULL){
+                    if(!path.push(link)){
+                        return;
+                    }
+                    link = &(*link)->left;
+                }
+                target->data = (*link)->data;
             }
-            Serial.println(node->data);
-            printTree(node->left, space);
+            AVLNode *node = *link;
+            *link = node->left != NULL ? node->left : node->right;
+            freeNode(node);
+            retrace(path, link, false);
         }
 
-        AVLNode *deleteNode(AVLNode *node, T data){
-            if(node == NULL){
-                return node;
-            }
-            if(data < node->data){
-                node->left = deleteNode(node->left, data);
-            } else if(data > node->data){
-                node->right = deleteNode(node->right, data);
-            } else {
-                if(node->left == NULL){
-                    AVLNode *temp = node->right;
-                    delete node;
-                    return temp;
-                } else if(node->right == NULL){
-                    AVLNode *temp = node->left;
-                    delete node;
-                    return temp;
+        typedef Stack<AVLNode*, AVLTREE_STACK_DEPTH> NodeStack;
+
+        struct Frame {
+            AVLNode *node;
+            int depth; // the root is at depth 0
+        };
+
+        // Visit the nodes in order as visit(node, depth); reverse visits right subtrees first (largest value first).
+        template <typename Visit>
+        void inOrderWalk(AVLNode *node, bool reverse, Visit visit){
+            Stack<Frame, AVLTREE_STACK_DEPTH> pending;
+            int depth = 0;
+            while(node != NULL || !pending.isEmpty()){
+                if(node != NULL){
+                    Frame frame = { node, depth++ };
+                    pending.push(frame);
+                    node = reverse ? node->right : node->left;
+                } else {
+                    Frame frame = pending.pop();
+                    visit(frame.node, frame.depth);
+                    node = reverse ? frame.node->left : frame.node->right;
+                    depth = frame.depth + 1;
                 }
-                AVLNode *temp = findMin(node->right);
-                node->data = temp->data;
-                node->right = deleteNode(node->right, temp->data);
-            }
-            if(node == NULL){
-                return node;
             }
-            node->height = 1 + max(height(node->left), height(node->right));
-            int balance = getBalance(node);
-            if(balance > 1 && getBalance(node->left) >= 0){
-                return rotateRight(node);
-            }
-            if(balance > 1 && getBalance(node->left) < 0){
-                node->left = rotateLeft(node->left);
-                return rotateRight(node);
-            }
-            if(balance < -1 && getBalance(node->right) <= 0){
-                return rotateLeft(node);
+        }
+
+        void preOrder(AVLNode *node){
+            NodeStack pending;
+            if(node != NULL){
+                pending.push(node);
+            }
+            while(pending.pop(node)){
+                Serial.println(node->data);
+                if(node->right != NULL){
+                    pending.push(node->right);
+                }
+                if(node->left != NULL){
+                    pending.push(node->left);
+                }
             }
-            if(balance < -1 && getBalance(node->right) > 0){
-                node->right = rotateRight(node->right);
-                return rotateLeft(node);
+        }
+
+        void postOrder(AVLNode *node){
+            NodeStack pending;
+            AVLNode *last = NULL; // visited last; a node's right subtree is done once its right child was visited
+            while(node != NULL || !pending.isEmpty()){
+                if(node != NULL){
+                    pending.push(node);
+                    node = node->left;
+                } else {
+                    AVLNode *top = pending.peek();
+                    if(top->right != NULL && top->right != last){
+                        node = top->right;
+                    } else {
+                        pending.pop();
+                        Serial.println(top->data);
+                        last = top;
+                    }
+                }
             }
-            return node;
         }
 
+        // Destroy every node without a stack: rotate left children up, then destroy the childless-on-the-left root.
+        // The memory stays with the pool.
+        void destroy(AVLNode *node){
+            while(node != NULL){
+                if(node->left != NULL){
+                    AVLNode *left = node->left;
+                    node->left = left->right;
+                    left->right = node;
+                    node = left;
+                } else {
+                    AVLNode *right = node->right;
+                    node->~AVLNode();
+                    node = right;
+                }
+            }
+        }
 
     public:
         AVLTree(){
             root = NULL;
+            chunks = NULL;
+            freeList = NULL;
+            freeCount = 0;
+        }
+
+        /**
+         * @brief Construct a balanced tree from count values in ascending order
+         * @see buildFromSorted
+        */
+        template <typename Iterator>
+        AVLTree(Iterator first, size_t count){
+            root = NULL;
+            chunks = NULL;
+            freeList = NULL;
+            freeCount = 0;
+            buildFromSorted(first, count);
         }
 
         ~AVLTree(){
-            delete root;
+            clear();
+        }
+
+        AVLTree(const AVLTree&) = delete;
+        AVLTree& operator=(const AVLTree&) = delete;
+
+        /**
+         * @brief Replace the contents with count values read from first, which must be in strictly ascending order
+         *
+         * Builds a perfectly balanced tree in O(n) without a single comparison or rotation: the values are copied
+         * into one chunk of count nodes, then each range of the chunk is linked with its middle node as the root.
+         * The order is not checked.
+         *
+         * @param first - an iterator (or pointer) to the first value; it is read once, front to back
+         * @param count - the number of values
+         * @return bool - false if the chunk could not be allocated (the tree is left empty)
+        */
+        template <typename Iterator>
+        bool buildFromSorted(Iterator first, size_t count){
+            clear();
+            if(count == 0){
+                return true;
+            }
+            AVLNode *nodes = addChunk(count);
+            if(nodes == NULL){
+                return false;
+            }
+            for(size_t i = 0; i < count; i++, ++first){
+                AVLNode *node = new (nodes + i) AVLNode();
+                node->data = *first;
+            }
+            int treeHeight;
+            root = linkBalanced(nodes, 0, count, treeHeight);
+            return true;
+        }
+
+        /**
+         * @brief Make sure the next n inserts take their nodes from the pool without allocating
+         *
+         * @param n - the number of free nodes wanted
+         * @return bool - false if the memory could not be allocated
+        */
+        bool reserve(size_t n){
+            if(freeCount >= n){
+                return true;
+            }
+            size_t extra = n - freeCount;
+            AVLNode *nodes = addChunk(extra);
+            if(nodes == NULL){
+                return false;
+            }
+            for(size_t i = extra; i > 0; i--){
+                pushFree(nodes + i - 1);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Get the number of nodes in the pool ready for the next inserts
+        */
+        size_t available(){
+            return freeCount;
         }
 
+        /**
+         * @brief Insert a value. Duplicates are ignored.
+        */
         void insert(T data){
-            root = insert(root, data);
+            insertValue(data);
         }
 
         void remove(T data){
-            root = remove(root, data);
-        
+            removeValue(data);
         }
+
         void inOrder(){
-            inOrder(root);
+            inOrderWalk(root, false, [](AVLNode *node, int){
+                Serial.println(node->data);
+            });
         }
         void preOrder(){
             preOrder(root);
@@ -289,32 +570,121 @@ class AVLTree {
             return temp->data;
         }
 
+        /**
+         * @brief Get the height of the tree (-1 when empty, 0 for a single node)
+         *
+         * Follows the taller child down from the root, which the balance factors point to, in O(log n).
+        */
         int height(){
-            return height(root);
+            int result = -1;
+            for(AVLNode *node = root; node != NULL; node = node->balance < 0 ? node->right : node->left){
+                result++;
+            }
+            return result;
         }
 
+        /**
+         * @brief Get the balance factor of the root: height(left) - height(right), between -1 and 1
+        */
         int getBalance(){
-            return getBalance(root);
+            return root == NULL ? 0 : root->balance;
         }
         void print(){
             inOrder();
         }
 
+        /**
+         * @brief Remove every value and return the pool's memory
+        */
         void clear(){
-            delete root;
+            destroy(root);
             root = NULL;
+            while(chunks != NULL){
+                Chunk *next = chunks->next;
+                ::operator delete(static_cast<void*>(chunks));
+                chunks = next;
+            }
+            freeList = NULL;
+            freeCount = 0;
         }
 
         bool isEmpty(){
             return root == NULL;
         }
 
+        // Sideways view: the right subtree above, the left below, indented 10 spaces per level
         void printTree(){
-            printTree(root, 0);
+            inOrderWalk(root, true, [](AVLNode *node, int depth){
+                Serial.println();
+                for(int i = 0; i < depth * 10; i++){
+                    Serial.print(" ");
+                }
+                Serial.println(node->data);
+            });
         }
 
         void deleteNode(T data){
-            root = deleteNode(root, data);
+            removeValue(data);
+        }
+
+        /**
+         * @brief Get the number of values in the tree in O(1)
+         * @note Needs AVLTree<T, true>
+        */
+        size_t size(){
+            static_assert(OrderStatistics, "size() needs AVLTree<T, true>");
+            return count(root);
+        }
+
+        /**
+         * @brief Get the k-th smallest value (k = 0 is the minimum) in O(log n)
+         *
+         * select(size() / 2) is the median, select(size() * 9 / 10) the 90th percentile.
+         *
+         * @param k - the 0-based position in sorted order
+         * @param value - receives the value
+         * @return bool - false if k >= size()
+         * @note Needs AVLTree<T, true>
+        */
+        bool select(size_t k, T& value){
+            static_assert(OrderStatistics, "select() needs AVLTree<T, true>");
+            AVLNode *node = root;
+            while(node != NULL){
+                size_t smaller = count(node->left);
+                if(k < smaller){
+                    node = node->left;
+                } else if(k > smaller){
+                    k -= smaller + 1;
+                    node = node->right;
+                } else {
+                    value = node->data;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Get the number of values less than x in O(log n); x does not have to be in the tree
+         *
+         * For a value in the tree this is its 0-based position, so select(rank(x)) gives x back.
+         * @note Needs AVLTree<T, true>
+        */
+        size_t rank(const T& x){
+            static_assert(OrderStatistics, "rank() needs AVLTree<T, true>");
+            return countBelow(x, false);
+        }
+
+        /**
+         * @brief Get the number of values v with lo <= v <= hi in O(log n)
+         * @note Needs AVLTree<T, true>
+        */
+        size_t countInRange(const T& lo, const T& hi){
+            static_assert(OrderStatistics, "countInRange() needs AVLTree<T, true>");
+            if(hi < lo){
+                return 0;
+            }
+            return countBelow(hi, true) - countBelow(lo, false);
         }
 
 };
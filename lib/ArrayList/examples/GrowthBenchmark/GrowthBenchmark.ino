@@ -0,0 +1,103 @@
+/*
+    Example Name: Growth Policy Benchmark For ArrayList Library
+
+    Compares the ArrayList growth policies on insert heavy workloads. For every policy it times appending
+    ITEMS ints, appending ITEMS Strings and inserting ITEMS ints at the front, and prints the time in
+    microseconds and the final capacity (capacity - size is the memory left unused).
+    The last row of each workload uses reserve() first, which is the lower bound: one allocation, no growth.
+
+    The sketch only uses Serial and micros(), so it also runs on host builds of the Arduino core. It is a sketch
+    rather than a test under the native PlatformIO environment because that environment has no Arduino core, and
+    ArrayList needs Arduino.h and String.
+
+    The circuit:
+    This Library does not Require any Circuits to run.
+
+    Created  month day year   // 10/18/2026
+    By author's name braydenanderson2014 (Brayden Anderson)
+    Modified day month year  // 10/18/2026
+    By author's name  braydenanderson2014 (Brayden Anderson)
+
+    https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
+
+*/
+#include <ArrayList.h>
+
+#ifndef ITEMS
+#define ITEMS 400 // Keep ITEMS * sizeof(String) well below the free RAM of the board
+#endif
+
+enum Workload { APPEND_INT, APPEND_STRING, INSERT_FRONT_INT };
+
+const char* workloadNames[] = { "append int", "append String", "insert front int" };
+const char* policyNames[] = { "double", "1.5x", "step 16", "reserve" };
+
+void report(const char* workload, const char* policy, unsigned long elapsed, size_t capacity)
+{
+    Serial.print(workload);
+    Serial.print(" / ");
+    Serial.print(policy);
+    Serial.print(": ");
+    Serial.print(elapsed);
+    Serial.print(" us, capacity ");
+    Serial.println(capacity);
+}
+
+template <typename T>
+void configure(ArrayList<T>& list, int policy)
+{
+    switch (policy) {
+        case 0: list.setGrowthPolicy(ArrayList<T>::GROW_DOUBLE); break;
+        case 1: list.setGrowthPolicy(ArrayList<T>::GROW_ONE_AND_HALF); break;
+        case 2: list.setGrowthPolicy(ArrayList<T>::GROW_FIXED_STEP, 16); break;
+        default: list.reserve(ITEMS); break;
+    }
+}
+
+void run(Workload workload, int policy)
+{
+    unsigned long start = 0;
+    unsigned long elapsed = 0;
+    size_t capacity = 0;
+
+    if (workload == APPEND_STRING) {
+        ArrayList<String> list(ArrayList<String>::DYNAMIC, 4);
+        configure(list, policy);
+        String value = "sensor";
+        start = micros();
+        for (int i = 0; i < ITEMS; i++) {
+            list.add(value);
+        }
+        elapsed = micros() - start;
+        capacity = list.capacity();
+    } else {
+        ArrayList<int> list(ArrayList<int>::DYNAMIC, 4);
+        configure(list, policy);
+        start = micros();
+        for (int i = 0; i < ITEMS; i++) {
+            if (workload == APPEND_INT) {
+                list.add(i);
+            } else {
+                list.insert(0, i);
+            }
+        }
+        elapsed = micros() - start;
+        capacity = list.capacity();
+    }
+    report(workloadNames[workload], policyNames[policy], elapsed, capacity);
+}
+
+void setup()
+{
+    Serial.begin(9600); // initialize serial communication at 9600 bits per second
+    for (int workload = APPEND_INT; workload <= INSERT_FRONT_INT; workload++) {
+        for (int policy = 0; policy < 4; policy++) {
+            run((Workload)workload, policy);
+        }
+    }
+}
+
+void loop()
+{
+    // Nothing to do here
+}
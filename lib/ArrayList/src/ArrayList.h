@@ -3,44 +3,58 @@
 
 #include <Arduino.h>
 
+// Largest scratch buffer (in items) the stable merge sort allocates; longer runs are merged in place.
+#ifndef ARRAYLIST_SORT_BUFFER
+#define ARRAYLIST_SORT_BUFFER 32
+#endif
+
 template <typename T>
 class ArrayList {
 public:
     enum SizeType { FIXED, DYNAMIC, DYNAMIC2 }; // Size type
     enum SortAlgorithm { BUBBLE_SORT, QUICK_SORT, MERGE_SORT }; // Sorting algorithms
+
+    /**
+     * @brief How the capacity grows when the ArrayList is full.
+     *
+     * Growth happens only when an item does not fit. Each growth allocates a new array and moves every item into it,
+     * so the policy trades memory for the number of reallocations:
+     * - GROW_DOUBLE: capacity * 2. About log2(n) reallocations for n adds (each item is moved about once on average),
+     *   but up to half of the capacity can be unused. Default for DYNAMIC and FIXED.
+     * - GROW_ONE_AND_HALF: capacity * 1.5. About 1.7x as many reallocations as doubling (each item is moved about
+     *   twice on average), at most a third of the capacity unused. Default for DYNAMIC2.
+     * - GROW_FIXED_STEP: capacity + growthStep. At most growthStep - 1 unused slots, but n / growthStep reallocations,
+     *   so n adds cost O(n^2 / growthStep) moves. Only suited to lists with a known small bound.
+     */
+    enum GrowthPolicy { GROW_DOUBLE, GROW_ONE_AND_HALF, GROW_FIXED_STEP };
     //Constructor and Destructor
     
     /**
      * @brief Constructs a new ArrayList.
      *
-     * This constructor creates a new ArrayList with the specified size type, initial size, and debug flag.
+     * This constructor creates a new ArrayList with the specified size type and initial size.
      * The size type determines whether the size of the ArrayList is static or dynamic. The initial size specifies
-     * the initial capacity of the ArrayList. The debug flag determines whether debug messages should be printed.
+     * the initial capacity of the ArrayList.
+     * DYNAMIC grows with GROW_DOUBLE and DYNAMIC2 with GROW_ONE_AND_HALF; both are unbounded. FIXED never grows past
+     * its initial size unless a larger ceiling is set with setMaxCapacity().
      *
-     * @param type The size type of the ArrayList. This should be either DYNAMIC or STATIC.
+     * @param type The size type of the ArrayList. This should be either DYNAMIC, DYNAMIC2 or FIXED.
      * @param initialSize The initial capacity of the ArrayList.
-     * @param debug A flag indicating whether debug messages should be printed.
     */
     ArrayList(SizeType type = DYNAMIC2, size_t initialSize = 8)
-        : sizeType(type), arrayCapacity(initialSize), count(0) {
-        array = new T[arrayCapacity];
-    }
+        : array(new T[initialSize]), sizeType(type), arrayCapacity(initialSize), count(0), sortAlgorithm(MERGE_SORT),
+          growthPolicy(type == DYNAMIC2 ? GROW_ONE_AND_HALF : GROW_DOUBLE), growthStep(8),
+          maxCapacity(type == FIXED ? initialSize : static_cast<size_t>(-1)) {}
 
     /**
     * @brief COPY Constructor
+    *
+    * Creates an independent copy with the same size type, growth settings, capacity and items.
     */
-    ArrayList(const ArrayList<T>& list){
-        array = new T[arrayCapacity];
-        this -> type = list.type;
-        this -> initalSize = list.initialSize;
-        this -> arrayCapacity = list.arrayCapacity + this -> arrayCapacity;
-        this -> count = list.count;
-
-        for(int i = 0; i < list.Size(); i++){
-            array.add(list.get(i));
-        }
-        list.clear();
-        list.~ArrayList();
+    ArrayList(const ArrayList<T>& list)
+        : array(new T[list.arrayCapacity]), sizeType(list.sizeType), arrayCapacity(list.arrayCapacity), count(list.count),
+          sortAlgorithm(list.sortAlgorithm), growthPolicy(list.growthPolicy), growthStep(list.growthStep), maxCapacity(list.maxCapacity) {
+        copyItems(array, list.array, count);
     }
 
     /**
@@ -56,30 +70,15 @@ public:
    /**
      * @brief Adds an item to the ArrayList.
      *
-     * This function adds the specified item to the ArrayList. If the size type of the ArrayList is DYNAMIC and the ArrayList is full,
-     * it resizes the ArrayList to accommodate the new item. If the ArrayList is not full, it adds the item to the ArrayList.
-     * If the ArrayList is full and its size type is STATIC, it prints an error message and does not add the item.
-     * (Only if the debug flag is set to true)
+     * This function adds the specified item to the ArrayList. If the ArrayList is full, it grows according to its growth policy
+     * (see GrowthPolicy). If it has already reached its maximum capacity (a FIXED ArrayList by default), the item is not added.
      * @param item The item to add to the ArrayList.
     */
     void add(T item) {
-        if(sizeType == FIXED && count >= arrayCapacity){
+        if (!ensureRoom(count + 1)) {
             return;
         }
-        
-        // Calculate the load factor
-        float loadFactor = (float)count / arrayCapacity;
-
-        // Resize the array if the load factor is greater than or equal to 0.8
-        if (sizeType == DYNAMIC && loadFactor >= 0.8) {
-            resize();
-        } else if(sizeType == DYNAMIC2 && loadFactor >= 0.8) {
-            resize2();
-        }
-        // Add the item to the array
-        if (count < arrayCapacity) {
-            array[count++] = item;
-        }
+        array[count++] = static_cast<T&&>(item);
     }
 
     /**
@@ -94,18 +93,13 @@ public:
      * @return true if the items were added successfully, false otherwise.
     */
     bool addAll(const ArrayList<T>& other) {
-        if (sizeType == DYNAMIC && count + other.count > arrayCapacity) {
-            resize();
-        }
-        if(sizeType == DYNAMIC2 && count + other.count > arrayCapacity){
-            resize2();
-        }
-        if (count + other.count <= arrayCapacity) {
-            memcpy(array + count, other.array, other.count * sizeof(T));
-            count += other.count;
-            return true;
+        size_t length = other.count; // other may be this list
+        if (!ensureRoom(count + length)) {
+            return false;
         }
-        return false;
+        copyItems(array + count, other.array, length);
+        count += length;
+        return true;
     }
 
     /**
@@ -121,18 +115,12 @@ public:
      * @return true if the items were added successfully, false otherwise.
     */
     bool addAll(const T* other, size_t length) {
-        if (sizeType == DYNAMIC && count + length > arrayCapacity) {
-            resize();
-        }
-        if(sizeType == DYNAMIC2 && count + length > arrayCapacity){
-            resize2();
-        }
-        if (count + length <= arrayCapacity) {
-            memcpy(array + count, other, length * sizeof(T));
-            count += length;
-            return true;
+        if (!ensureRoom(count + length)) {
+            return false;
         }
-        return false;
+        copyItems(array + count, other, length);
+        count += length;
+        return true;
     }
 
     /**
@@ -150,19 +138,11 @@ public:
         if (index > count) {
             return false;
         }
-        if (count == arrayCapacity) {
-            if (sizeType == DYNAMIC) {
-                resize();
-            } else if(sizeType == DYNAMIC2){
-                resize2();
-            } else {
-                return false;
-            }
-        }
-        for (size_t i = count; i > index; --i) {
-            array[i] = array[i - 1];
+        if (!ensureRoom(count + 1)) {
+            return false;
         }
-        array[index] = item;
+        shiftRight(index, 1);
+        array[index] = static_cast<T&&>(item);
         ++count;
         return true;
     }
@@ -174,19 +154,18 @@ public:
         if(this == &list){
             return *this;
         }
+        T* newArray = new T[list.arrayCapacity];
+        copyItems(newArray, list.array, list.count);
         delete[] array;
 
-        array = new T[arrayCapacity];
-        array.type= list.type;
-        array.initalSize = list.initialSize;
-        array.arrayCapacity = list.arrayCapacity + array.arrayCapacity;
-        array.count = list.count;
-
-        for(int i = 0; i < list.Size(); i++){
-            array.add(list.get(i));
-        }
-        list.clear();
-        list.~ArrayList();
+        array = newArray;
+        sizeType = list.sizeType;
+        arrayCapacity = list.arrayCapacity;
+        count = list.count;
+        sortAlgorithm = list.sortAlgorithm;
+        growthPolicy = list.growthPolicy;
+        growthStep = list.growthStep;
+        maxCapacity = list.maxCapacity;
 
         return *this;
     }
@@ -197,8 +176,9 @@ public:
      * 
      */
     T& operator [] (size_t index){
-        if(index >= size){
-            return T();
+        if(index >= count){
+            static T dummy; // Out of bounds access returns a dummy item, as in SimpleVector
+            return dummy;
         }
         return array[index];
     }
@@ -218,19 +198,15 @@ public:
         if (index > count) {
             return false;
         }
-        if (count + other.count > arrayCapacity) {
-            if (sizeType == DYNAMIC) {
-                resize();
-            } else if(sizeType == DYNAMIC2) {
-                resize2();
-            } else {
-                return false;
-            }
+        if (&other == this) {
+            ArrayList<T> copy(other); // The shift below would overwrite the source
+            return insertAll(index, copy);
         }
-        for (size_t i = count + other.count - 1; i >= index + other.count; --i) {
-            array[i] = array[i - other.count];
+        if (!ensureRoom(count + other.count)) {
+            return false;
         }
-        memcpy(array + index, other.array, other.count * sizeof(T));
+        shiftRight(index, other.count);
+        copyItems(array + index, other.array, other.count);
         count += other.count;
         return true;
     }
@@ -251,19 +227,11 @@ public:
         if (index > count) {
             return false;
         }
-        if (count + length > arrayCapacity) {
-            if (sizeType == DYNAMIC) {
-                resize();
-            } else if(sizeType == DYNAMIC2) {
-                resize2();  
-            } else {
-                return false;
-            }
-        }
-        for (size_t i = count + length - 1; i >= index + length; --i) {
-            array[i] = array[i - length];
+        if (!ensureRoom(count + length)) {
+            return false;
         }
-        memcpy(array + index, other, length * sizeof(T));
+        shiftRight(index, length);
+        copyItems(array + index, other, length);
         count += length;
         return true;
     }
@@ -298,7 +266,7 @@ public:
     void remove(size_t index) {
         if (index < count) {
             for (size_t i = index; i < count - 1; ++i) {
-                array[i] = array[i + 1];
+                array[i] = static_cast<T&&>(array[i + 1]);
             }
             --count;
         }
@@ -566,13 +534,13 @@ public:
      *
      * This function copies the items from the ArrayList into the specified output array.
      * The output array must be large enough to hold all items in the ArrayList.
-     * The function uses the memcpy function to copy the items, so the type T must be trivially copyable.
+     * Trivially copyable types are copied with memcpy, other types with their assignment operator.
      *
      * @param outputArray The array into which to copy the items.
      * @return The output array.
     */
     T* toArray(T* outputArray) const {
-        memcpy(outputArray, array, count * sizeof(T));
+        copyItems(outputArray, array, count);
         return outputArray;
     }
 
@@ -631,44 +599,105 @@ public:
      * @brief Ensures that the ArrayList can hold at least the specified number of items without needing to resize.
      *
      * This function checks if the ArrayList's current capacity is less than the specified minimum capacity.
-     * If it is, it resizes the ArrayList to the specified minimum capacity.
-     * The function uses the memcpy function to copy the items to the new array, so the type T must be trivially copyable.
+     * If it is, it resizes the ArrayList to the specified minimum capacity. Unlike reserve(), it ignores the maximum capacity.
      *
      * @param minCapacity The minimum capacity that the ArrayList should be able to hold without resizing.
     */
     void ensureCapacity(size_t minCapacity) {
         if (minCapacity > arrayCapacity) {
-            T* newArray = new T[minCapacity];
-            memcpy(newArray, array, count * sizeof(T));
-            delete[] array;
-            array = newArray;
-            arrayCapacity = minCapacity;
+            reallocate(minCapacity);
+        }
+    }
+
+    /**
+     * @brief Reserves room for at least the specified number of items in one allocation.
+     *
+     * Calling this before a known number of adds replaces every intermediate growth step with a single reallocation.
+     *
+     * @param minCapacity The number of items the ArrayList should hold without growing.
+     * @return true if the capacity is now at least minCapacity, false if that would exceed the maximum capacity.
+    */
+    bool reserve(size_t minCapacity) {
+        if (minCapacity <= arrayCapacity) {
+            return true;
+        }
+        if (minCapacity > maxCapacity) {
+            return false;
         }
+        reallocate(minCapacity);
+        return true;
+    }
+
+    /**
+     * @brief Releases unused capacity.
+     *
+     * Moves the items into an array of max(size(), minCapacity) items if that is smaller than the current capacity.
+     *
+     * @param minCapacity The capacity to keep even if the ArrayList holds fewer items.
+     * @return true if the capacity was reduced, false otherwise.
+    */
+    bool shrink(size_t minCapacity = 0) {
+        size_t newCapacity = count > minCapacity ? count : minCapacity;
+        if (newCapacity >= arrayCapacity) {
+            return false;
+        }
+        reallocate(newCapacity);
+        return true;
     }
 
     /**
      * @brief Trims the capacity of the ArrayList to its current size.
      *
      * This function reduces the capacity of the ArrayList to its current size, i.e., the number of items it contains.
-     * If the ArrayList is dynamic and its capacity is greater than its size, it creates a new array with a capacity equal to the size, copies the items to the new array, and deletes the old array.
-     * If the ArrayList is already trimmed or is fixed size, it prints an error message (if debug is true).
+     * Fixed size ArrayLists keep their capacity.
     */
     void trimToSize() {
-        if (sizeType == DYNAMIC && count < arrayCapacity) {
-            T* newArray = new T[count];
-            memcpy(newArray, array, count * sizeof(T));
-            delete[] array;
-            array = newArray;
-            arrayCapacity = count;
-        } else if(sizeType == DYNAMIC2 && count < arrayCapacity){
-            T* newArray = new T[count];
-            memcpy(newArray, array, count * sizeof(T));
-            delete[] array;
-            array = newArray;
-            arrayCapacity = count;
+        if (sizeType != FIXED) {
+            shrink();
         }
     }
 
+    /**
+     * @brief Sets how the capacity grows when the ArrayList is full.
+     *
+     * @param policy The growth policy (see GrowthPolicy for the cost of each).
+     * @param step The number of slots added per growth for GROW_FIXED_STEP.
+    */
+    void setGrowthPolicy(GrowthPolicy policy, size_t step = 8) {
+        growthPolicy = policy;
+        growthStep = step > 0 ? step : 1;
+    }
+
+    /**
+     * @brief Gets the growth policy of the ArrayList.
+     *
+     * @return The growth policy.
+    */
+    GrowthPolicy getGrowthPolicy() const {
+        return growthPolicy;
+    }
+
+    /**
+     * @brief Sets the largest capacity the ArrayList may grow to.
+     *
+     * Adds that would need more room fail instead. A FIXED ArrayList starts with its initial size as the ceiling, so raising it
+     * lets a fixed list grow (with the growth policy) up to a known bound.
+     *
+     * @param ceiling The maximum capacity.
+    */
+    void setMaxCapacity(size_t ceiling) {
+        maxCapacity = ceiling;
+    }
+
+    /**
+     * @brief Gets the largest capacity the ArrayList may grow to.
+     *
+     * @return The maximum capacity.
+    */
+    size_t getMaxCapacity() const {
+        return maxCapacity;
+    }
+
     /**
      * @brief Sets the sorting algorithm to use for sorting the ArrayList.
      *
@@ -693,81 +722,201 @@ public:
         return sortAlgorithm;
     }
 
+    /**
+     * @brief Default comparator: orders items with operator<.
+     *
+     * Any functor, lambda or function taking (const T&, const T&) and returning true when the first item belongs before the
+     * second can be used instead.
+    */
+    struct Less {
+        bool operator()(const T& a, const T& b) const {
+            return a < b;
+        }
+    };
+
     /**
      * @brief Sorts the ArrayList.
      * 
-     * This function sorts the ArrayList using the specified comparator function
-     * Sorting Algorithm is determined by the sortAlgorithm variable (use the sort function to set the sorting algorithm)
+     * This function sorts the ArrayList using the specified comparator.
+     * Sorting Algorithm is determined by the sortAlgorithm variable (use setSortAlgorithm to change it):
+     * QUICK_SORT uses introsort, MERGE_SORT (the default) and BUBBLE_SORT use the stable merge sort.
+     *
+     * @param comparator Returns true if its first argument belongs before the second (for example a < b for ascending order).
+     *                   A functor or lambda taking const T& is inlined and does not copy the items.
     */
-    void sort(bool (*comparator)(T, T)) {
-        switch (sortAlgorithm) {
-            case BUBBLE_SORT:
-                bubbleSort(comparator);
-                break;
-            case QUICK_SORT:
-                quickSort(comparator, 0, count - 1);
-                break;
-            default:
-                mergeSort(*this, 0, count - 1);
-            break;
-        }
+    template <typename Compare>
+    void sort(Compare comparator) {
+        sort(comparator, sortAlgorithm);
+    }
+
+    /**
+     * @brief Sorts the ArrayList in ascending order with operator<.
+    */
+    void sort() {
+        sort(Less(), sortAlgorithm);
     }
 
     /**
      * @brief Sorts the ArrayList.
      *
-     * This function sorts the ArrayList using the specified comparator function and sorting algorithm.
-     * The comparator function is a function that takes two items of type T and returns true if the first item is less than the second item, or false otherwise.
-     * The sorting algorithm is an enum value that specifies the sorting algorithm to use. The available sorting algorithms are BUBBLE_SORT and QUICK_SORT.
-     * The function uses the bubble sort algorithm by default.
-     * The function can use the Predicates library, which can be found at:
+     * This function sorts the ArrayList using the specified comparator and sorting algorithm.
+     * - QUICK_SORT: introsort. Quicksort with a median of three pivot, switching to heapsort when the recursion gets too deep
+     *   (so never worse than O(n log n)) and to insertion sort for partitions of 16 items or fewer. Not stable, no extra memory.
+     * - MERGE_SORT: stable merge sort. Uses a scratch buffer of at most ARRAYLIST_SORT_BUFFER items and merges in place
+     *   (O(n log^2 n)) when a run does not fit, so memory stays bounded on small boards.
+     * - BUBBLE_SORT: kept so existing sketches compile; it runs the stable merge sort.
+     *
+     * @param comparator Returns true if its first argument belongs before the second.
+     * @param algorithm The sorting algorithm to use.
     */ 
-    void sort(bool (*comparator)(T, T), SortAlgorithm algorithm) { 
-        switch (algorithm) { 
-            case BUBBLE_SORT: 
-                bubbleSort(comparator); 
-            break; 
-            case QUICK_SORT: 
-                quickSort(comparator, 0, count - 1); 
-            break; // Add cases for additional sorting algorithms 
-            default:
-                mergeSort(*this, 0, count - 1);
-            break;
-        } 
+    template <typename Compare>
+    void sort(Compare comparator, SortAlgorithm algorithm) { 
+        if (count < 2) {
+            return;
+        }
+        if (algorithm == QUICK_SORT) {
+            introSort(array, array + count, depthLimit(count), comparator);
+        } else {
+            stableSort(comparator);
+        }
     }
 
     /**
-     * @brief Sorts the ArrayList using the bubble sort algorithm.
+     * @brief Sorts the ArrayList with the stable merge sort.
      *
-     * This function sorts the items in the ArrayList using the bubble sort algorithm.
-     * The order of the items is determined by the specified comparator function.
-     * The comparator function should take two items of type T and return true if the first item should come after the second item in the sorted ArrayList, and false otherwise.
+     * Kept for compatibility: older versions ran a bubble sort here. Both are stable.
      *
-     * @param comparator The comparator function that determines the order of the items.
+     * @param comparator Returns true if its first argument belongs before the second.
     */
-    void bubbleSort(bool (*comparator)(T, T)) {
-        for (size_t i = 0; i < count - 1; ++i) {
-            for (size_t j = 0; j < count - i - 1; ++j) {
-                if (comparator(array[j], array[j + 1])) {
-                    T temp = array[j];
-                    array[j] = array[j + 1];
-                    array[j + 1] = temp;
-                }
-            }
+    template <typename Compare>
+    void bubbleSort(Compare comparator) {
+        sort(comparator, MERGE_SORT);
+    }
+
+    /**
+     * @brief Sorts the ArrayList with introsort.
+     *
+     * @param comparator Returns true if its first argument belongs before the second.
+    */
+    template <typename Compare>
+    void quickSort(Compare comparator) {
+        sort(comparator, QUICK_SORT);
+    }
+
+    /**
+     * @brief Sorts the ArrayList with the stable merge sort; items that compare equal keep their order.
+     *
+     * @param comparator Returns true if its first argument belongs before the second.
+    */
+    template <typename Compare>
+    void stableSort(Compare comparator) {
+        if (count < 2) {
+            return;
+        }
+        size_t bufferSize = (count + 1) / 2;
+        if (bufferSize > ARRAYLIST_SORT_BUFFER) {
+            bufferSize = ARRAYLIST_SORT_BUFFER;
+        }
+        T* buffer = new T[bufferSize];
+        if (!buffer) {
+            bufferSize = 0; // Out of memory: every merge runs in place
         }
+        mergeSortRange(array, array + count, buffer, bufferSize, comparator);
+        delete[] buffer;
+    }
+
+    /**
+     * @brief Finds an item in a sorted ArrayList.
+     *
+     * The ArrayList must be sorted with the same comparator.
+     *
+     * @param item The item to find.
+     * @param comparator Returns true if its first argument belongs before the second.
+     * @return The index of a matching item, or -1 (as size_t) if there is none, like indexOf().
+    */
+    template <typename Compare>
+    size_t binarySearch(const T& item, Compare comparator) const {
+        size_t index = lowerBound(item, comparator);
+        if (index < count && !comparator(item, array[index])) {
+            return index;
+        }
+        return static_cast<size_t>(-1);
+    }
+
+    size_t binarySearch(const T& item) const {
+        return binarySearch(item, Less());
+    }
+
+    /**
+     * @brief Finds the first position in a sorted ArrayList where an item could be inserted and keep it sorted.
+     *
+     * @param item The item to look for.
+     * @param comparator Returns true if its first argument belongs before the second.
+     * @return The index of the first item that does not belong before item, or size() if there is none.
+    */
+    template <typename Compare>
+    size_t lowerBound(const T& item, Compare comparator) const {
+        return lowerBoundIn(array, array + count, item, comparator) - array;
+    }
+
+    size_t lowerBound(const T& item) const {
+        return lowerBound(item, Less());
     }
 
     /**
-     * @brief Sorts the ArrayList using the quick sort algorithm.
+     * @brief Finds the first position in a sorted ArrayList whose item belongs after an item.
      *
-     * This function sorts the items in the ArrayList using the quick sort algorithm.
-     * The order of the items is determined by the specified comparator function.
-     * The comparator function should take two items of type T and return true if the first item should come after the second item in the sorted ArrayList, and false otherwise.
+     * @param item The item to look for.
+     * @param comparator Returns true if its first argument belongs before the second.
+     * @return The index of the first item that belongs after item, or size() if there is none.
+    */
+    template <typename Compare>
+    size_t upperBound(const T& item, Compare comparator) const {
+        return upperBoundIn(array, array + count, item, comparator) - array;
+    }
+
+    size_t upperBound(const T& item) const {
+        return upperBound(item, Less());
+    }
+
+    /**
+     * @brief Partially sorts the ArrayList so the item at index n is the one a full sort would put there.
+     *
+     * Every item before n belongs at or before it and every item after n at or after it; neither side is sorted.
+     * Runs in O(n) on average (quickselect, with a heapsort fallback for bad pivots), so it is the cheap way to get a
+     * median or percentile out of a sensor buffer: nthElement(size() * 90 / 100) then get() that index.
      *
-     * @param comparator The comparator function that determines the order of the items.
+     * @param n The index to place.
+     * @param comparator Returns true if its first argument belongs before the second.
+     * @return false if n is out of bounds.
     */
-    void quickSort(bool (*comparator)(T, T)) {
-        quickSortHelper(comparator, 0, count - 1);
+    template <typename Compare>
+    bool nthElement(size_t n, Compare comparator) {
+        if (n >= count) {
+            return false;
+        }
+        T* first = array;
+        T* last = array + count;
+        T* nth = array + n;
+        int depth = depthLimit(count);
+        while (last - first > INSERTION_SORT_THRESHOLD) {
+            if (depth-- == 0) {
+                heapSort(first, last, comparator);
+                return true;
+            }
+            T* cut = partitionRange(first, last, comparator);
+            if (cut <= nth) {
+                first = cut;
+            } else {
+                last = cut;
+            }
+        }
+        insertionSort(first, last, comparator);
+        return true;
+    }
+
+    bool nthElement(size_t n) {
+        return nthElement(n, Less());
     }
 
 
@@ -797,24 +946,26 @@ public:
 
 
     /**
-     * Recursively sorts the elements of an ArrayList using the Merge Sort algorithm.
-     * This function splits the list into two halves, calls itself for the two halves,
-     * and then merges the two sorted halves. The function uses the merge() function
-     * for merging two halves. The recursive sorting continues until the sub-arrays
-     * have only one element each, which are inherently sorted.
-     * 
-     * @param list Reference to an ArrayList of template type T to be sorted.
-     * @param l The starting index of the sub-array to be sorted.
-     * @param r The ending index of the sub-array to be sorted.
-     * @template T The data type of the elements in the ArrayList.
+     * @brief Stable sorts the items from index l to index r (both inclusive) of list in ascending order.
+     *
+     * Kept for compatibility; use stableSort() or sort() to sort a whole ArrayList.
+     *
+     * @param list Reference to the ArrayList to be sorted.
+     * @param l The starting index of the range to be sorted.
+     * @param r The ending index of the range to be sorted.
     */
     void mergeSort(ArrayList<T>& list, int l, int r) {
-        if (l < r) {
-            int m = l + (r - l) / 2;
-            mergeSort(list, l, m);
-            mergeSort(list, m + 1, r);
-            merge(list, l, m, r);
+        if (l < 0 || r < l || (size_t)r >= list.count) {
+            return;
+        }
+        size_t bufferSize = (size_t)(r - l + 2) / 2;
+        if (bufferSize > ARRAYLIST_SORT_BUFFER) {
+            bufferSize = ARRAYLIST_SORT_BUFFER;
         }
+        T* buffer = new T[bufferSize];
+        Less comparator;
+        mergeSortRange(list.array + l, list.array + r + 1, buffer, buffer ? bufferSize : 0, comparator);
+        delete[] buffer;
     }
 
 private:
@@ -823,159 +974,377 @@ private:
     size_t arrayCapacity;
     size_t count;
     SortAlgorithm sortAlgorithm;
+    GrowthPolicy growthPolicy;
+    size_t growthStep;
+    size_t maxCapacity;
+
+    // Types whose copies are plain byte copies (int, float, pointers, plain structs) are moved with memcpy/memmove;
+    // everything else (String, lists of lists) goes through its assignment operators.
+    struct Trivial {
+        static const bool value = __has_trivial_copy(T) && __has_trivial_assign(T);
+    };
+
+    template <bool B> struct Tag {};
+
+    // Copy n items into dest, leaving src untouched.
+    static void copyItems(T* dest, const T* src, size_t n) {
+        copyItems(dest, src, n, Tag<Trivial::value>());
+    }
+
+    static void copyItems(T* dest, const T* src, size_t n, Tag<true>) {
+        if (n) {
+            memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(T));
+        }
+    }
+
+    static void copyItems(T* dest, const T* src, size_t n, Tag<false>) {
+        for (size_t i = 0; i < n; ++i) {
+            dest[i] = src[i];
+        }
+    }
+
+    // Move n items into dest; src is about to be freed.
+    static void moveItems(T* dest, T* src, size_t n) {
+        moveItems(dest, src, n, Tag<Trivial::value>());
+    }
+
+    static void moveItems(T* dest, T* src, size_t n, Tag<true>) {
+        copyItems(dest, src, n, Tag<true>());
+    }
+
+    static void moveItems(T* dest, T* src, size_t n, Tag<false>) {
+        for (size_t i = 0; i < n; ++i) {
+            dest[i] = static_cast<T&&>(src[i]);
+        }
+    }
+
     /**
-     * @brief Resizes the ArrayList.
+     * @brief Moves the items from index to the end by the specified number of slots to open a gap.
      *
-     * This function resizes the ArrayList to 1.5 times its current capacity.
-     * It creates a new array with the new capacity, copies the items to the new array, and deletes the old array.
-     * If the new capacity is greater than the maximum size_t value, it prints an error message (if debug is true) and does not resize the ArrayList.
+     * The caller has already made room for count + by items.
     */
-    void resize() {
-        size_t newCapacity = arrayCapacity * 2;
-        T* newArray = new T[newCapacity];
-        memcpy(newArray, array, count * sizeof(T));
-        delete[] array;
-        array = newArray;
-        size_t tempCapacity = newCapacity;
-        int oldCapacity = arrayCapacity;
-        arrayCapacity = newCapacity;
-        if(tempCapacity != arrayCapacity){
-            arrayCapacity = oldCapacity;
+    void shiftRight(size_t index, size_t by) {
+        shiftRight(index, by, Tag<Trivial::value>());
+    }
+
+    void shiftRight(size_t index, size_t by, Tag<true>) {
+        if (by && index < count) {
+            memmove(static_cast<void*>(array + index + by), static_cast<const void*>(array + index), (count - index) * sizeof(T));
         }
     }
 
-    void resize2(){
-        size_t newCapacity = arrayCapacity * 1.5;
-        T* newArray = new T[newCapacity];
-        for(size_t i = 0; i < count; i++){
-            newArray[i] = array[i];
+    void shiftRight(size_t index, size_t by, Tag<false>) {
+        if (by == 0) {
+            return;
+        }
+        for (size_t i = count; i > index; --i) {
+            array[i - 1 + by] = static_cast<T&&>(array[i - 1]);
         }
+    }
+
+    /**
+     * @brief Moves the items into a new array of the specified capacity.
+    */
+    void reallocate(size_t newCapacity) {
+        T* newArray = new T[newCapacity];
+        moveItems(newArray, array, count);
         delete[] array;
         array = newArray;
-        size_t tempCapacity = newCapacity;
-        int oldCapacity = arrayCapacity;
         arrayCapacity = newCapacity;
-        if(tempCapacity != arrayCapacity){
-            arrayCapacity = oldCapacity;
+    }
+
+    /**
+     * @brief Computes the capacity after one growth step of the current policy.
+    */
+    size_t nextCapacity(size_t capacity) const {
+        size_t next;
+        switch (growthPolicy) {
+            case GROW_ONE_AND_HALF:
+                next = capacity + capacity / 2;
+                break;
+            case GROW_FIXED_STEP:
+                next = capacity + growthStep;
+                break;
+            default:
+                next = capacity * 2;
+                break;
+        }
+        if (next <= capacity) { // A capacity of 0 or 1 does not grow by multiplying
+            next = capacity < 4 ? 4 : capacity + 1;
         }
+        return next;
     }
 
     /**
-     * @brief Sorts the ArrayList using the quick sort algorithm.
+     * @brief Grows the ArrayList, if needed, so it can hold the specified number of items.
      *
-     * This function sorts the items in the ArrayList using the quick sort algorithm.
-     * The order of the items is determined by the specified comparator function.
-     * The comparator function should take two items of type T and return true if the first item should come after the second item in the sorted ArrayList, and false otherwise.
+     * Applies the growth policy until the capacity is large enough, capped at the maximum capacity, then reallocates once.
      *
-     * @param comparator The comparator function that determines the order of the items.
-     * @param low The lowest index of the sublist to sort.
-     * @param high The highest index of the sublist to sort.
+     * @param needed The number of items the ArrayList must be able to hold.
+     * @return true if there is room for needed items, false if that would exceed the maximum capacity.
     */
-    int partition(bool (*comparator)(T, T), int low, int high) { 
-        T pivot = array[high]; 
-        int i = (low - 1); 
-        for (int j = low; j <= high - 1; j++) { 
-            if (comparator(array[j], pivot)) { 
-                i++; 
-                swap(&array[i], &array[j]); 
-            } 
-        } 
-        swap(&array[i + 1], &array[high]); 
-        return (i + 1); 
-    } 
+    bool ensureRoom(size_t needed) {
+        if (needed <= arrayCapacity) {
+            return true;
+        }
+        if (needed > maxCapacity || needed < count) {
+            return false;
+        }
+        size_t newCapacity = arrayCapacity;
+        while (newCapacity < needed) {
+            newCapacity = nextCapacity(newCapacity);
+        }
+        if (newCapacity > maxCapacity) {
+            newCapacity = maxCapacity;
+        }
+        reallocate(newCapacity);
+        return true;
+    }
+
+    static const int INSERTION_SORT_THRESHOLD = 16; // Partitions this small are finished with insertion sort
+
+    // 2 * floor(log2(n)): the quicksort depth after which introsort switches to heapsort.
+    static int depthLimit(size_t n) {
+        int depth = 0;
+        while (n > 1) {
+            n >>= 1;
+            depth += 2;
+        }
+        return depth;
+    }
+
+    static void moveSwap(T* a, T* b) {
+        T t = static_cast<T&&>(*a);
+        *a = static_cast<T&&>(*b);
+        *b = static_cast<T&&>(t);
+    }
 
     /**
-     * @brief Sorts the ArrayList using the quick sort algorithm.
-     *
-     * This function sorts the items in the ArrayList using the quick sort algorithm.
-     * The order of the items is determined by the specified comparator function.
-     * The comparator function should take two items of type T and return true if the first item should come after the second item in the sorted ArrayList, and false otherwise.
-     *
-     * @param comparator The comparator function that determines the order of the items.
-     * @param low The lowest index of the sublist to sort.
-     * @param high The highest index of the sublist to sort.
+     * @brief Sorts [first, last) with insertion sort. Stable, fast for short or nearly sorted ranges.
+    */
+    template <typename Compare>
+    static void insertionSort(T* first, T* last, Compare& comparator) {
+        for (T* i = first + 1; i < last; ++i) {
+            if (!comparator(*i, *(i - 1))) {
+                continue;
+            }
+            T value = static_cast<T&&>(*i);
+            T* j = i;
+            do {
+                *j = static_cast<T&&>(*(j - 1));
+                --j;
+            } while (j > first && comparator(value, *(j - 1)));
+            *j = static_cast<T&&>(value);
+        }
+    }
+
+    template <typename Compare>
+    static void siftDown(T* first, size_t root, size_t length, Compare& comparator) {
+        T value = static_cast<T&&>(first[root]);
+        size_t child;
+        while ((child = 2 * root + 1) < length) {
+            if (child + 1 < length && comparator(first[child], first[child + 1])) {
+                ++child;
+            }
+            if (!comparator(value, first[child])) {
+                break;
+            }
+            first[root] = static_cast<T&&>(first[child]);
+            root = child;
+        }
+        first[root] = static_cast<T&&>(value);
+    }
+
+    /**
+     * @brief Sorts [first, last) with heapsort: O(n log n) worst case, no extra memory.
     */
-    void quickSortHelper(bool (*comparator)(T, T), int low, int high) {
-        if (low < high) { 
-            int pi = partition(comparator, low, high); 
-            quickSortHelper(comparator, low, pi - 1); 
-            quickSortHelper(comparator, pi + 1, high);
-        } 
+    template <typename Compare>
+    static void heapSort(T* first, T* last, Compare& comparator) {
+        size_t length = last - first;
+        for (size_t i = length / 2; i-- > 0;) {
+            siftDown(first, i, length, comparator);
+        }
+        while (length > 1) {
+            --length;
+            moveSwap(first, first + length);
+            siftDown(first, 0, length, comparator);
+        }
     }
- 
+
     /**
-     * Merges two halves of an ArrayList that have been sorted independently.
-     * The function takes three indices, l (left index), m (middle index), and r (right index).
-     * It assumes that the sub-arrays ArrayList[l..m] and ArrayList[m+1..r] are sorted,
-     * and merges them into a single sorted sub-array ArrayList[l..r].
-     * 
-     * @param list Reference to an ArrayList of template type T that is being sorted.
-     * @param l The starting index of the first sub-array.
-     * @param m The ending index of the first sub-array, which also serves as the middle point.
-     * @param r The ending index of the second sub-array.
-    */
-    void merge(ArrayList<T>& list, int l, int m, int r) {
-        int i, j, k;
-        int n1 = m - l + 1;
-        int n2 = r - m;
-
-        // Create temp arrays
-        T* L = new T[n1];
-        T* R = new T[n2];
-
-        // Copy data to temp arrays L[] and R[]
-        for (i = 0; i < n1; i++)
-            L[i] = list[l + i];
-        for (j = 0; j < n2; j++)
-            R[j] = list[m + 1 + j];
-
-        // Merge the temp arrays back into list[l..r]
-        i = 0; // Initial index of first subarray
-        j = 0; // Initial index of second subarray
-        k = l; // Initial index of merged subarray
-        while (i < n1 && j < n2) {
-            if (L[i] <= R[j]) {
-                list[k] = L[i];
-                i++;
+     * @brief Partitions [first, last) around the median of the first, middle and last item.
+     *
+     * @return cut such that no item in [first, cut) belongs after any item in [cut, last); both sides are non empty.
+    */
+    template <typename Compare>
+    static T* partitionRange(T* first, T* last, Compare& comparator) {
+        T* a = first + 1;
+        T* b = first + (last - first) / 2;
+        T* c = last - 1;
+        // Move the median of a, b, c to first so it acts as the pivot (and as a sentinel for both scans).
+        if (comparator(*a, *b)) {
+            if (comparator(*b, *c)) moveSwap(first, b);
+            else if (comparator(*a, *c)) moveSwap(first, c);
+            else moveSwap(first, a);
+        } else if (comparator(*a, *c)) {
+            moveSwap(first, a);
+        } else if (comparator(*b, *c)) {
+            moveSwap(first, c);
+        } else {
+            moveSwap(first, b);
+        }
+        T* left = first + 1;
+        T* right = last;
+        while (true) {
+            while (comparator(*left, *first)) {
+                ++left;
+            }
+            --right;
+            while (comparator(*first, *right)) {
+                --right;
+            }
+            if (!(left < right)) {
+                return left;
+            }
+            moveSwap(left, right);
+            ++left;
+        }
+    }
+
+    template <typename Compare>
+    static void introSort(T* first, T* last, int depth, Compare& comparator) {
+        while (last - first > INSERTION_SORT_THRESHOLD) {
+            if (depth == 0) {
+                heapSort(first, last, comparator);
+                return;
+            }
+            --depth;
+            T* cut = partitionRange(first, last, comparator);
+            // Recurse into the smaller side and loop on the larger one, so the stack stays O(log n).
+            if (cut - first < last - cut) {
+                introSort(first, cut, depth, comparator);
+                first = cut;
             } else {
-                list[k] = R[j];
-                j++;
+                introSort(cut, last, depth, comparator);
+                last = cut;
             }
-            k++;
         }
+        insertionSort(first, last, comparator);
+    }
 
-        // Copy the remaining elements of L[], if there are any
-        while (i < n1) {
-            list[k] = L[i];
-            i++;
-            k++;
+    template <typename Compare>
+    static T* lowerBoundIn(T* first, T* last, const T& item, Compare& comparator) {
+        size_t length = last - first;
+        while (length > 0) {
+            size_t half = length / 2;
+            if (comparator(first[half], item)) {
+                first += half + 1;
+                length -= half + 1;
+            } else {
+                length = half;
+            }
         }
+        return first;
+    }
 
-        // Copy the remaining elements of R[], if there are any
-        while (j < n2) {
-            list[k] = R[j];
-            j++;
-            k++;
+    template <typename Compare>
+    static T* upperBoundIn(T* first, T* last, const T& item, Compare& comparator) {
+        size_t length = last - first;
+        while (length > 0) {
+            size_t half = length / 2;
+            if (!comparator(item, first[half])) {
+                first += half + 1;
+                length -= half + 1;
+            } else {
+                length = half;
+            }
         }
+        return first;
+    }
 
-        delete[] L;
-        delete[] R;
+    static void reverse(T* first, T* last) {
+        while (first < last && first < --last) {
+            moveSwap(first++, last);
+        }
     }
 
+    // Swaps the blocks [first, middle) and [middle, last); returns the new position of *first.
+    static T* rotate(T* first, T* middle, T* last) {
+        reverse(first, middle);
+        reverse(middle, last);
+        reverse(first, last);
+        return first + (last - middle);
+    }
 
     /**
-     * @brief Swaps two items in the ArrayList.
-     *
-     * This function swaps the items at the specified indices in the ArrayList.
+     * @brief Merges the sorted runs [first, middle) and [middle, last), keeping equal items in order.
      *
-     * @param a The index of the first item to swap.
-     * @param b The index of the second item to swap.
+     * Moves the shorter run into the scratch buffer when it fits. Otherwise splits both runs around the median of the longer one,
+     * rotates the middle blocks and merges the two halves recursively.
     */
-    void swap(T* a, T* b) { 
-        T t = *a; 
-        *a = *b; 
-        *b = t; 
-    } 
+    template <typename Compare>
+    static void mergeRuns(T* first, T* middle, T* last, T* buffer, size_t bufferSize, Compare& comparator) {
+        size_t length1 = middle - first;
+        size_t length2 = last - middle;
+        if (length1 == 0 || length2 == 0 || !comparator(*middle, *(middle - 1))) {
+            return; // Already in order
+        }
+        if (length1 <= bufferSize && length1 <= length2) {
+            moveItems(buffer, first, length1);
+            T* left = buffer;
+            T* leftEnd = buffer + length1;
+            T* right = middle;
+            T* out = first;
+            while (left < leftEnd && right < last) {
+                *out++ = comparator(*right, *left) ? static_cast<T&&>(*right++) : static_cast<T&&>(*left++);
+            }
+            while (left < leftEnd) {
+                *out++ = static_cast<T&&>(*left++);
+            }
+            return;
+        }
+        if (length2 <= bufferSize) {
+            moveItems(buffer, middle, length2);
+            T* left = middle;
+            T* right = buffer + length2;
+            T* out = last;
+            while (left > first && right > buffer) {
+                *--out = comparator(*(right - 1), *(left - 1)) ? static_cast<T&&>(*--left) : static_cast<T&&>(*--right);
+            }
+            while (right > buffer) {
+                *--out = static_cast<T&&>(*--right);
+            }
+            return;
+        }
+        if (length1 + length2 == 2) {
+            moveSwap(first, middle);
+            return;
+        }
+        T* cut1;
+        T* cut2;
+        if (length1 > length2) {
+            cut1 = first + length1 / 2;
+            cut2 = lowerBoundIn(middle, last, *cut1, comparator);
+        } else {
+            cut2 = middle + length2 / 2;
+            cut1 = upperBoundIn(first, middle, *cut2, comparator);
+        }
+        T* newMiddle = rotate(cut1, middle, cut2);
+        mergeRuns(first, cut1, newMiddle, buffer, bufferSize, comparator);
+        mergeRuns(newMiddle, cut2, last, buffer, bufferSize, comparator);
+    }
+
+    template <typename Compare>
+    static void mergeSortRange(T* first, T* last, T* buffer, size_t bufferSize, Compare& comparator) {
+        if (last - first <= INSERTION_SORT_THRESHOLD) {
+            insertionSort(first, last, comparator);
+            return;
+        }
+        T* middle = first + (last - first) / 2;
+        mergeSortRange(first, middle, buffer, bufferSize, comparator);
+        mergeSortRange(middle, last, buffer, bufferSize, comparator);
+        mergeRuns(first, middle, last, buffer, bufferSize, comparator);
+    }
 };
 
 #endif // ARRAYLIST_H
\ No newline at end of file
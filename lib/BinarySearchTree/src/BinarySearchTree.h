@@ -1,6 +1,8 @@
 #ifndef BINARYSEARCHTREE_h
 #define BINARYSEARCHTREE_h
 
+#include "EytzingerSnapshot.h"
+
 template <typename T>
     struct BinarySearchNode {
         T data;
@@ -30,9 +32,9 @@ private:
         if(root == NULL){
             return root;
         }
-        if(key < root->key){
+        if(key < root->data){
             root->left = deleteNode(root->left, key);
-        } else if(key > root->key){
+        } else if(key > root->data){
             root->right = deleteNode(root->right, key);
         } else {
             if(root->left == NULL){
@@ -45,8 +47,8 @@ private:
                 return temp;
             }
             BinarySearchNode<T> *temp = minValueNode(root->right);
-            root->key = temp->key;
-            root->right = deleteNode(root->right, temp->key);
+            root->data = temp->data;
+            root->right = deleteNode(root->right, temp->data);
         }
         return root;
     }
@@ -68,6 +70,21 @@ private:
         }
     }
 
+    size_t countNodes(BinarySearchNode<T> *node){
+        if(node == NULL){
+            return 0;
+        }
+        return countNodes(node->left) + 1 + countNodes(node->right);
+    }
+
+    void appendInOrder(BinarySearchNode<T> *node, EytzingerSnapshot<T> &out){
+        if(node != NULL){
+            appendInOrder(node->left, out);
+            out.append(node->data);
+            appendInOrder(node->right, out);
+        }
+    }
+
 
 
 public:
@@ -85,7 +102,7 @@ public:
     }
 
     void deleteNode(const T &data){
-        root = deleteNode(data, root);
+        root = deleteNode(root, data);
     }
 
     void clear(){
@@ -105,6 +122,23 @@ public:
         }
         return NULL;
     }
+
+    /**
+     * @brief Copy the keys into a read-only Eytzinger layout for fast lookups
+     *
+     * The snapshot is independent of the tree: later inserts and deletes do not change it. Take a new snapshot
+     * after the tree changes.
+     *
+     * @param out - the snapshot to fill (its old contents are replaced)
+     * @return bool - false if the snapshot could not be allocated
+    */
+    bool snapshot(EytzingerSnapshot<T> &out){
+        if(!out.begin(countNodes(root))){
+            return false;
+        }
+        appendInOrder(root, out);
+        return true;
+    }
 };
 
 
@@ -0,0 +1,253 @@
+#ifndef EYTZINGER_SNAPSHOT_h
+#define EYTZINGER_SNAPSHOT_h
+
+#include <Arduino.h>
+
+// Ask the cache for the keys a few levels below the one being compared. AVR has no cache, so it is left out there.
+#if defined(__GNUC__) && !defined(__AVR__)
+#define EYTZINGER_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define EYTZINGER_PREFETCH(address)
+#endif
+
+/**
+ * @brief A read-only search tree stored as one array in breadth-first (Eytzinger) order
+ *
+ * keys[1] is the root and the children of keys[k] are keys[2k] and keys[2k + 1], so the tree has no pointers and
+ * is as balanced as a tree can be: every level is full except the last, which fills from the left. A search reads
+ * one array from the front, every step moves to index 2k or 2k + 1 with no unpredictable branch, and the keys four
+ * levels down share cache lines and are prefetched while the current level is compared. That makes lookups in
+ * large, rarely changing tables several times faster than in a pointer tree.
+ *
+ * Because the shape depends only on the number of keys, height(), width() and the leaf counts are arithmetic.
+ *
+ * Fill it with build() from sorted values, or with snapshot() of a BinarySearchTree or BinaryTree.
+ *
+ * @tparam T The type of the keys; needs operator< (and operator== for find())
+*/
+template <typename T>
+class EytzingerSnapshot {
+    private:
+        T *keys;       // keys[1..count]; keys[0] is unused
+        size_t count;
+        size_t next;   // index the next append() writes
+        int levels;
+
+        // Elements per 64 byte cache line: prefetching k * stride reaches the first key four levels down for ints
+        static const size_t prefetchStride = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+        static int log2Floor(size_t value) {
+            int result = -1;
+            while (value != 0) {
+                value >>= 1;
+                result++;
+            }
+            return result;
+        }
+
+        // Index of the leftmost node below k
+        size_t leftmost(size_t k) const {
+            while (2 * k <= count) {
+                k = 2 * k;
+            }
+            return k;
+        }
+
+        /**
+         * @brief Index of the first key that is not less than value, or 0 if there is none
+         *
+         * Walks down to past a leaf, taking the right child when the key is less than value. The bits of k then
+         * record the turns; dropping the trailing right turns and the last left turn gives the lower bound.
+        */
+        size_t lowerBoundIndex(const T &value) const {
+            size_t k = 1;
+            while (k <= count) {
+                EYTZINGER_PREFETCH(keys + k * prefetchStride);
+                k = 2 * k + (keys[k] < value);
+            }
+            while (k & 1) {
+                k >>= 1;
+            }
+            return k >> 1;
+        }
+
+    public:
+        EytzingerSnapshot() : keys(NULL), count(0), next(0), levels(0) {}
+
+        /**
+         * @brief Build from count values in ascending order
+         * @see build
+        */
+        template <typename Iterator>
+        EytzingerSnapshot(Iterator first, size_t count) : keys(NULL), count(0), next(0), levels(0) {
+            build(first, count);
+        }
+
+        ~EytzingerSnapshot() {
+            clear();
+        }
+
+        EytzingerSnapshot(const EytzingerSnapshot&) = delete;
+        EytzingerSnapshot& operator=(const EytzingerSnapshot&) = delete;
+
+        /**
+         * @brief Replace the contents with count values in ascending order, read once from first
+         *
+         * @return bool - false if the array could not be allocated (the snapshot is left empty)
+        */
+        template <typename Iterator>
+        bool build(Iterator first, size_t count) {
+            if (!begin(count)) {
+                return false;
+            }
+            for (size_t i = 0; i < count; i++, ++first) {
+                append(*first);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Start a build of count values that are then passed to append() in ascending order
+         *
+         * Lets a tree stream its in-order traversal straight into the snapshot without an intermediate array.
+         *
+         * @return bool - false if the array could not be allocated (the snapshot is left empty)
+        */
+        bool begin(size_t count) {
+            clear();
+            if (count == 0) {
+                return true;
+            }
+            keys = new T[count + 1];
+            if (keys == NULL) {
+                return false;
+            }
+            this->count = count;
+            levels = log2Floor(count) + 1;
+            next = leftmost(1);
+            return true;
+        }
+
+        /**
+         * @brief Store the next value of a build started with begin(); extra values are ignored
+         *
+         * The values fill the implicit tree in order, so each one goes to the in-order successor of the last.
+        */
+        void append(const T &value) {
+            if (next == 0) {
+                return;
+            }
+            keys[next] = value;
+            if (2 * next + 1 <= count) {
+                next = leftmost(2 * next + 1);
+            } else {
+                while (next & 1) {
+                    next >>= 1;
+                }
+                next >>= 1;
+            }
+        }
+
+        /**
+         * @brief Find a key
+         * @return const T* - the key in the snapshot, or NULL if it is not there
+        */
+        const T *find(const T &value) const {
+            size_t k = lowerBoundIndex(value);
+            return k != 0 && keys[k] == value ? keys + k : NULL;
+        }
+
+        bool contains(const T &value) const {
+            return find(value) != NULL;
+        }
+
+        /**
+         * @brief Find the smallest key that is not less than value
+         * @return const T* - the key, or NULL if every key is less than value
+        */
+        const T *lowerBound(const T &value) const {
+            size_t k = lowerBoundIndex(value);
+            return k != 0 ? keys + k : NULL;
+        }
+
+        const T *findMin() const {
+            return count != 0 ? keys + leftmost(1) : NULL;
+        }
+
+        const T *findMax() const {
+            if (count == 0) {
+                return NULL;
+            }
+            size_t k = 1;
+            while (2 * k + 1 <= count) {
+                k = 2 * k + 1;
+            }
+            return keys + k;
+        }
+
+        /**
+         * @brief Get the depth of a key (0 for the root)
+         * @return int - the depth, or -1 if the key is not there
+        */
+        int depth(const T &value) const {
+            const T *key = find(value);
+            return key != NULL ? log2Floor(key - keys) : -1;
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        bool isEmpty() const {
+            return count == 0;
+        }
+
+        /**
+         * @brief Get the number of levels (0 when empty), like BinaryTree::height()
+        */
+        int height() const {
+            return levels;
+        }
+
+        /**
+         * @brief Get the number of keys on a level (the root is level 0)
+        */
+        size_t levelWidth(int level) const {
+            if (level < 0 || level >= levels) {
+                return 0;
+            }
+            size_t first = (size_t)1 << level; // index of the leftmost key on the level
+            return level == levels - 1 ? count - first + 1 : first;
+        }
+
+        /**
+         * @brief Get the largest number of keys on one level
+        */
+        size_t width() const {
+            if (levels == 0) {
+                return 0;
+            }
+            size_t last = levelWidth(levels - 1);
+            size_t full = levels > 1 ? levelWidth(levels - 2) : 0;
+            return last > full ? last : full;
+        }
+
+        // keys[k] is a leaf when it has no child 2k, so the leaves are the second half of the array
+        size_t leafCount() const {
+            return count - count / 2;
+        }
+
+        size_t nonLeafCount() const {
+            return count / 2;
+        }
+
+        void clear() {
+            delete[] keys;
+            keys = NULL;
+            count = 0;
+            next = 0;
+            levels = 0;
+        }
+};
+
+#endif // EYTZINGER_SNAPSHOT_h
@@ -1,6 +1,16 @@
 #ifndef BINARYTREE_h
 #define BINARYTREE_h
 
+#include <Arduino.h>
+#include <Stack.h>
+#include <EytzingerSnapshot.h>
+
+// Entries the traversal stacks keep inline instead of recursing. In order and post order walks need one entry per level
+// of the deepest path; the tree is not balanced, so a deeper path spills the rest to the heap rather than failing.
+#ifndef BINARYTREE_STACK_DEPTH
+#define BINARYTREE_STACK_DEPTH 64
+#endif
+
 template <typename T>
 struct BinaryNode {
         T data;
@@ -12,133 +22,86 @@ class BinaryTree {
 private:
     BinaryNode<T> *root;
 
-    BinaryNode<T>* insert(BinaryNode<T>* node, T data) {
-      // If the tree is empty, assign a new node address
-      if (node == nullptr) {
-        node = createNode(data);
-      }
-      // Else, do nothing.
-      return node;
-    }
-
-    void inorder(BinaryNode<T>* node) {
-        if (node == nullptr) {
-            return;
-        }
-        inorder(node->left);
-        Serial.println(node->data);
-        inorder(node->right);
-    }
-
-    BinaryNode<T>* deleteNode(BinaryNode<T>* node, T data) {
+    struct Frame {
+        BinaryNode<T>* node;
+        int depth; // the root is at depth 0
+    };
+
+    bool outOfMemory() {
+        Serial.println("Memory Error");
+        return false;
+    }
+
+    /**
+     * @brief Visit every node in preorder (node, left subtree, right subtree) as visit(node, depth)
+     *
+     * visit may swap the children of the node it is given; the walk reads them afterwards.
+     *
+     * @return bool - false if a deep path could not be spilled to the heap (the walk stops early)
+    */
+    template <typename Visit>
+    bool preorderWalk(BinaryNode<T>* node, Visit visit) {
+        SpillStack<Frame, BINARYTREE_STACK_DEPTH> pending;
         if (node == nullptr) {
-            return node;
+            return true;
         }
-        if (data < node->data) {
-            node->left = deleteNode(node->left, data);
-        } else if (data > node->data) {
-            node->right = deleteNode(node->right, data);
-        } else {
-            if (node->left == nullptr) {
-                BinaryNode<T>* temp = node->right;
-                delete node;
-                return temp;
-            } else if (node->right == nullptr) {
-                BinaryNode<T>* temp = node->left;
-                delete node;
-                return temp;
+        Frame frame = { node, 0 };
+        pending.push(frame);
+        while (pending.pop(frame)) {
+            visit(frame.node, frame.depth);
+            Frame right = { frame.node->right, frame.depth + 1 };
+            Frame left = { frame.node->left, frame.depth + 1 };
+            if ((right.node != nullptr && !pending.push(right)) || (left.node != nullptr && !pending.push(left))) {
+                return outOfMemory();
             }
-            BinaryNode<T>* temp = minValueNode(node->right);
-            node->data = temp->data;
-            node->right = deleteNode(node->right, temp->data);
         }
-        return node;
-    }
-
-    int height(BinaryNode<T>* node) {
-        if (node == nullptr) {
-            return 0;
-        } else {
-            int lheight = height(node->left);
-            int rheight = height(node->right);
-            if (lheight > rheight) {
-                return lheight + 1;
+        return true;
+    }
+
+    template <typename Visit>
+    bool inorderWalk(BinaryNode<T>* node, Visit visit) {
+        SpillStack<BinaryNode<T>*, BINARYTREE_STACK_DEPTH> pending;
+        while (node != nullptr || !pending.isEmpty()) {
+            if (node != nullptr) {
+                if (!pending.push(node)) {
+                    return outOfMemory();
+                }
+                node = node->left;
             } else {
-                return rheight + 1;
+                node = pending.pop();
+                visit(node);
+                node = node->right;
             }
         }
-    }
-
-    int leafcount(BinaryNode<T>* node) {
-        if (node == nullptr) {
-            return 0;
-        }
-        if (node->left == nullptr && node->right == nullptr) {
-            return 1;
-        } else {
-            return leafcount(node->left) + leafcount(node->right);
-        }
-    }
-
-    int nonleafcount(BinaryNode<T>* node) {
-        if (node == nullptr || (node->left == nullptr && node->right == nullptr)) {
-            return 0;
-        } else {
-            return 1 + nonleafcount(node->left) + nonleafcount(node->right);
-        }
-    }
-
-    int nodecount(BinaryNode<T>* node) {
-        if (node == nullptr) {
-            return 0;
-        } else {
-            return 1 + nodecount(node->left) + nodecount(node->right);
-        }
-    }
-
-    int depth(BinaryNode<T>* node, T data) {
-        if (node == nullptr) {
-            return -1;
-        }
-        if (node->data == data) {
-            return 0;
-        }
-        int left = depth(node->left, data);
-        int right = depth(node->right, data);
-        if (left >= 0) {
-            return left + 1;
-        }
-        if (right >= 0) {
-            return right + 1;
-        }
-        return -1;
-    }
-
-    int level(BinaryNode<T>* node, T data) {
-        return depth(node, data);
-    }
-
-    int width(BinaryNode<T>* node) {
-        int h = height(node);
-        int maxwidth = 0;
-        for (int i = 1; i <= h; i++) {
-            int width = getWidth(node, i);
-            if (width > maxwidth) {
-                maxwidth = width;
+        return true;
+    }
+
+    template <typename Visit>
+    bool postorderWalk(BinaryNode<T>* node, Visit visit) {
+        SpillStack<BinaryNode<T>*, BINARYTREE_STACK_DEPTH> pending;
+        BinaryNode<T>* last = nullptr; // the node visited last; its parent's right subtree is done when it matches
+        while (node != nullptr || !pending.isEmpty()) {
+            if (node != nullptr) {
+                if (!pending.push(node)) {
+                    return outOfMemory();
+                }
+                node = node->left;
+            } else {
+                BinaryNode<T>* top = pending.peek();
+                if (top->right != nullptr && top->right != last) {
+                    node = top->right;
+                } else {
+                    pending.pop();
+                    visit(top);
+                    last = top;
+                }
             }
         }
-        return maxwidth;
+        return true;
     }
 
-    int getWidth(BinaryNode<T>* node, int level) {
-        if (node == nullptr) {
-            return 0;
-        }
-        if (level == 1) {
-            return 1;
-        } else if (level > 1) {
-            return getWidth(node->left, level - 1) + getWidth(node->right, level - 1);
-        }
+    static void printNode(BinaryNode<T>* node) {
+        Serial.println(node->data);
     }
 
     int findMax(BinaryNode<T>* node) {
@@ -161,79 +124,13 @@ private:
         return node->data;
     }
 
-    void mirror(BinaryNode<T>* node) {
-        if (node == nullptr) {
-            return;
-        } else {
-            BinaryNode<T>* temp;
-            mirror(node->left);
-            mirror(node->right);
-            temp = node->left;
-            node->left = node->right;
-            node->right = temp;
-        }
-    }
-
-    void preorder(BinaryNode<T>* node) {
-        if (node == nullptr) {
-            return;
-        }
-        Serial.println(node->data);
-        preorder(node->left);
-        preorder(node->right);
-    }
-
-    void postorder(BinaryNode<T>* node) {
-        if (node == nullptr) {
-            return;
-        }
-        postorder(node->left);
-        postorder(node->right);
-        Serial.println(node->data);
-    }
-
-    void levelorder(BinaryNode<T>* node) {
-        int h = height(node);
-        for (int i = 1; i <= h; i++) {
-            printGivenLevel(node, i);
-        }
-    }
-
-    void printGivenLevel(BinaryNode<T>* node, int level) {
-        if (node == nullptr) {
-            return;
-        }
-        if (level == 1) {
-            Serial.println(node->data);
-        } else if (level > 1) {
-            printGivenLevel(node->left, level - 1);
-            printGivenLevel(node->right, level - 1);
-        }
-    }
-
-    BinaryNode<T>* minValueNode(BinaryNode<T>* node) {
-        BinaryNode<T>* current = node;
-        while (current->left != nullptr) {
-            current = current->left;
-        }
-        return current;
-    }
-
-    BinaryNode<T>* search(BinaryNode<T>* node, T data) {
-        // Base Cases: root is null or key is present at root
-        if (node == nullptr || node->data == data)
-           return node;
-        
-        // Key is greater than root's key
-        if (node->data < data)
-           return search(node->right, data);
-    
-        // Key is smaller than root's key
-        return search(node->left, data);
-    }
 public:
     BinaryTree() : root(nullptr) {}
 
+    ~BinaryTree() {
+        clear();
+    }
+
     BinaryNode<T>* createNode(T data) {
         BinaryNode<T> *newNode = new BinaryNode<T>();
         if(!newNode) {
@@ -245,44 +142,133 @@ public:
         return newNode;
     }
 
+    /**
+     * @brief Insert a value in search tree order (smaller values to the left). Duplicates are ignored.
+    */
     void insert(T data) {
-        root = insert(root, data);
+        BinaryNode<T>** link = &root;
+        while (*link != nullptr) {
+            if (data < (*link)->data) {
+                link = &(*link)->left;
+            } else if (data > (*link)->data) {
+                link = &(*link)->right;
+            } else {
+                return;
+            }
+        }
+        *link = createNode(data);
     }
 
     void inorder(){
-        inorder(root);
+        inorderWalk(root, printNode);
     }
 
     void deleteNode(T data) {
-        root = deleteNode(root, data);
+        BinaryNode<T>** link = &root;
+        while (*link != nullptr) {
+            if (data < (*link)->data) {
+                link = &(*link)->left;
+            } else if (data > (*link)->data) {
+                link = &(*link)->right;
+            } else {
+                break;
+            }
+        }
+        BinaryNode<T>* node = *link;
+        if (node == nullptr) {
+            return;
+        }
+        if (node->left != nullptr && node->right != nullptr) {
+            // Two children: take the value of the in-order successor and unlink the successor instead
+            BinaryNode<T>** successorLink = &node->right;
+            while ((*successorLink)->left != nullptr) {
+                successorLink = &(*successorLink)->left;
+            }
+            BinaryNode<T>* successor = *successorLink;
+            node->data = successor->data;
+            *successorLink = successor->right;
+            delete successor;
+            return;
+        }
+        *link = node->left != nullptr ? node->left : node->right;
+        delete node;
     }
 
     int height() {
-        return height(root);
+        int result = 0;
+        preorderWalk(root, [&result](BinaryNode<T>*, int depth) {
+            if (depth + 1 > result) {
+                result = depth + 1;
+            }
+        });
+        return result;
     }
 
     int leafcount() {
-        return leafcount(root);
+        int count = 0;
+        preorderWalk(root, [&count](BinaryNode<T>* node, int) {
+            if (node->left == nullptr && node->right == nullptr) {
+                count++;
+            }
+        });
+        return count;
     }
 
     int nonleafcount() {
-        return nonleafcount(root);
+        int count = 0;
+        preorderWalk(root, [&count](BinaryNode<T>* node, int) {
+            if (node->left != nullptr || node->right != nullptr) {
+                count++;
+            }
+        });
+        return count;
     }
 
     int nodecount() {
-        return nodecount(root);
-    }
-
+        int count = 0;
+        preorderWalk(root, [&count](BinaryNode<T>*, int) {
+            count++;
+        });
+        return count;
+    }
+
+    /**
+     * @brief Get the depth of the first node (in preorder) holding data
+     *
+     * @return int - 0 for the root, -1 if no node holds data
+    */
     int depth(T data) {
-        return depth(root, data);
+        int result = -1;
+        preorderWalk(root, [&result, &data](BinaryNode<T>* node, int depth) {
+            if (result < 0 && node->data == data) {
+                result = depth;
+            }
+        });
+        return result;
     }
 
     int level(T data) {
-        return level(root, data);
+        return depth(data);
     }
 
+    /**
+     * @brief Get the largest number of nodes on one level (one preorder pass per level)
+    */
     int width() {
-        return width(root);
+        int h = height();
+        int maxwidth = 0;
+        for (int i = 0; i < h; i++) {
+            int count = 0;
+            preorderWalk(root, [i, &count](BinaryNode<T>*, int depth) {
+                if (depth == i) {
+                    count++;
+                }
+            });
+            if (count > maxwidth) {
+                maxwidth = count;
+            }
+        }
+        return maxwidth;
     }
 
     int findMax() {
@@ -294,34 +280,87 @@ public:
     }
 
     void mirror() {
-        mirror(root);
+        preorderWalk(root, [](BinaryNode<T>* node, int) {
+            BinaryNode<T>* temp = node->left;
+            node->left = node->right;
+            node->right = temp;
+        });
     }
 
     //preorder
     void preorder() {
-        preorder(root);
+        preorderWalk(root, [](BinaryNode<T>* node, int) {
+            printNode(node);
+        });
     }
 
     //postorder
     void postorder() {
-        postorder(root);
+        postorderWalk(root, printNode);
     }
 
-    //levelorder
+    //levelorder: one preorder pass per level, which keeps the left to right order within a level
     void levelorder() {
-        levelorder(root);
+        int h = height();
+        for (int i = 0; i < h; i++) {
+            preorderWalk(root, [i](BinaryNode<T>* node, int depth) {
+                if (depth == i) {
+                    printNode(node);
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Copy the values into a read-only Eytzinger layout (see EytzingerSnapshot.h)
+     *
+     * Lookups in the snapshot never miss a branch, and its height(), width() and leaf counts are O(1) instead of
+     * one or more walks of the tree. The snapshot does not follow later changes to the tree. The tree must be in
+     * search order (not mirrored).
+     *
+     * @param out - the snapshot to fill (its old contents are replaced)
+     * @return bool - false if the snapshot (or the walk's spilled stack) could not be allocated
+    */
+    bool snapshot(EytzingerSnapshot<T>& out) {
+        if (!out.begin(nodecount())) {
+            return false;
+        }
+        bool walked = inorderWalk(root, [&out](BinaryNode<T>* node) {
+            out.append(node->data);
+        });
+        if (!walked) {
+            out.clear();
+        }
+        return walked;
     }
 
-    // Function to be called by the user, it uses the private search function
     BinaryNode<T>* search(T data) {
-        return search(root, data);
+        BinaryNode<T>* node = root;
+        while (node != nullptr && !(node->data == data)) {
+            node = node->data < data ? node->right : node->left;
+        }
+        return node;
     }
 
+    /**
+     * @brief Delete every node without recursion or a stack
+     *
+     * Rotates left children up until the root has none, then deletes the root and continues with its right child.
+    */
     void clear() {
         while (root != nullptr) {
-            deleteNode(root->data);
+            if (root->left != nullptr) {
+                BinaryNode<T>* left = root->left;
+                root->left = left->right;
+                left->right = root;
+                root = left;
+            } else {
+                BinaryNode<T>* right = root->right;
+                delete root;
+                root = right;
+            }
         }
     }
 
 };
-#endif // BINARYTREE_h
\ No newline at end of file
+#endif // BINARYTREE_h
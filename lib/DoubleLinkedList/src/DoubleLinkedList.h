@@ -31,9 +31,6 @@ private:
     DoubleListNode<T> *head; // Pointer to the first node
     DoubleListNode<T> *tail; // Pointer to the last node
     size_t Size;            // Number of elements in the list
-    // Random Iterator Helper
-    mutable bool *visited;       // Array to keep track of visited nodes
-    mutable size_t visitedCount; // Number of visited nodes
 
 public:
     /**
@@ -123,63 +120,72 @@ public:
     // Random iterator class definition
     /**
      * @brief Random Iterator
+     * @details Returns every element exactly once, in a uniformly shuffled order. The iterator copies the node
+     * pointers once (O(n) time, one pointer per element) and runs one Fisher-Yates step per dereference, so a full
+     * pass is O(n) with no rescans of the list.
+     * @warning Inserting or removing elements invalidates the iterator.
     */
     class RandomIterator {
     private:
-        DoubleLinkedList<T> *list;
+        DoubleListNode<T> **order; // node pointers; order[0, position) have been returned in this pass
+        size_t count;
+        size_t position;
 
+    public:
         /**
-         * @brief Reset the visited list
-         * @details This method resets the visited list
+         * @brief Construct a new Random Iterator object
         */
-        void resetVisited() const {
-            for (size_t i = 0; i < list->Size; ++i) {
-                list->visited[i] = false;
+        RandomIterator(DoubleLinkedList<T> *list) : order(nullptr), count(list->Size), position(0) {
+            if (count) {
+                order = new DoubleListNode<T> *[count];
+                size_t i = 0;
+                for (DoubleListNode<T> *node = list->head; node; node = node->next) {
+                    order[i++] = node;
+                }
             }
-            list->visitedCount = 0;
         }
 
-    public:
-        /**
-         * @brief Construct a new Random Iterator object
-        */
-        RandomIterator(DoubleLinkedList<T> *list) : list(list) {
-            list->visited = new bool[list->Size]();
-            resetVisited();
+        RandomIterator(const RandomIterator &other) : order(nullptr), count(other.count), position(other.position) {
+            if (count) {
+                order = new DoubleListNode<T> *[count];
+                memcpy(order, other.order, count * sizeof(DoubleListNode<T> *));
+            }
+        }
+
+        RandomIterator(RandomIterator &&other) : order(other.order), count(other.count), position(other.position) {
+            other.order = nullptr;
+            other.count = 0;
+            other.position = 0;
         }
 
+        RandomIterator &operator=(const RandomIterator &) = delete;
+
         /**
          * @brief Destroy the Random Iterator object
         */
         ~RandomIterator() {
-            delete[] list->visited;
+            delete[] order;
         }
 
         /**
          * @brief Dereference operator
+         * @details Returns the next element of the shuffled order: a uniformly chosen element among those not yet
+         * returned in this pass. Once every element has been returned, a new pass starts.
+         * @note Returns a static default constructed T if the list was empty.
         */
         T &operator*() {
-            size_t index = random(0, list->Size - list->visitedCount);
-            size_t count = 0;
-            for (size_t i = 0; i < list->Size; ++i) {
-                if (!list->visited[i]) {
-                    if (count == index) {
-                        list->visited[i] = true;
-                        list->visitedCount++;
-                        return *list->get(i);
-                    }
-                    count++;
-                }
-                // Return the first unvisited element as a fallback
-                for (size_t i = 0; i < list->Size; ++i) {
-                    if (!list->visited[i]) {
-                        list->visited[i] = true;
-                        list->visitedCount++;
-                        return *list->get(i);
-                    }
-                }
-                // Should not reach here
+            if (count == 0) {
+                static T dummy;
+                return dummy;
+            }
+            if (position == count) {
+                position = 0;
             }
+            size_t pick = position + random(0, count - position);
+            DoubleListNode<T> *node = order[pick];
+            order[pick] = order[position];
+            order[position++] = node;
+            return node->data;
         }
 
         /**
@@ -187,15 +193,15 @@ public:
          * @details This method checks if there is a next element
         */
         bool hasNext() const {
-            return list->visitedCount < list->Size;
+            return position < count;
         }
 
         /**
          * @brief Reset the iterator
-         * @details This method resets the iterator
+         * @details Starts a new pass; it is shuffled afresh as it is consumed.
         */
         void reset() {
-            resetVisited();
+            position = 0;
         }
     };
 
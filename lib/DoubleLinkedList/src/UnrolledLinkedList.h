@@ -0,0 +1,473 @@
+#ifndef UNROLLEDLINKEDLIST_H
+#define UNROLLEDLINKEDLIST_H
+
+#include <Arduino.h>
+#include <new>
+
+// Bytes of elements packed into each node of an UnrolledLinkedList<T> when K is not given. Every node adds two
+// pointers, a count byte and the allocator header, so this is the knob between memory per element and the cost of
+// shifting elements inside a node on insert/remove.
+#ifndef UNROLLEDLIST_NODE_BYTES
+#define UNROLLEDLIST_NODE_BYTES 32
+#endif
+
+/**
+ * @brief Default number of elements per node: UNROLLEDLIST_NODE_BYTES worth of T, at least 4 and at most 255
+*/
+template <typename T>
+struct UnrolledListCapacity {
+    static const size_t bytes = UNROLLEDLIST_NODE_BYTES / sizeof(T);
+    static const size_t value = bytes < 4 ? 4 : (bytes > 255 ? 255 : bytes);
+};
+
+/**
+ * @brief Unrolled List Node
+ * @param T Data type
+ * @param K Number of element slots in the node
+ * @note Holds up to K elements in a contiguous block; only the first count slots are constructed
+*/
+template <typename T, size_t K>
+class UnrolledListNode {
+public:
+    UnrolledListNode *next;
+    UnrolledListNode *prev;
+    uint8_t count; // constructed elements, front first
+    alignas(T) unsigned char storage[K * sizeof(T)];
+
+    UnrolledListNode() : next(nullptr), prev(nullptr), count(0) {}
+
+    T *items() {
+        return reinterpret_cast<T *>(storage);
+    }
+
+    const T *items() const {
+        return reinterpret_cast<const T *>(storage);
+    }
+};
+
+/**
+ * @brief Unrolled Double Linked List
+ * @param T Data type
+ * @param K Elements per node (default: UNROLLEDLIST_NODE_BYTES / sizeof(T), between 4 and 255)
+ * @note A drop-in variant of DoubleLinkedList that packs up to K elements into each node
+ * @details DoubleLinkedList spends two pointers and an allocation on every element. This list spends them on every
+ * K elements, and keeps each node at least half full where it can (a full node is split in two on insert, and a
+ * node is merged with its neighbour once both fit in one), so memory per element approaches sizeof(T) and iteration
+ * walks contiguous arrays. Positional access walks nodes, not elements, from the closer end of the list.
+ *
+ * @warning Pointers returned by get() and iterators are invalidated by any insert or remove, since elements move
+ * between and within nodes.
+*/
+template <typename T, size_t K = UnrolledListCapacity<T>::value>
+class UnrolledLinkedList {
+    static_assert(K >= 2 && K <= 255, "UnrolledLinkedList needs between 2 and 255 elements per node");
+
+private:
+    typedef UnrolledListNode<T, K> Node;
+
+    Node *head;  // Pointer to the first node
+    Node *tail;  // Pointer to the last node
+    size_t Size; // Number of elements in the list
+
+    /**
+     * @brief Find the node holding a position
+     * @param position Position of the element (must be less than Size)
+     * @param offset Receives the index of the element inside the node
+     * @return Node* The node holding the element
+    */
+    Node *locate(size_t position, uint8_t &offset) const {
+        Node *node;
+        if (position < Size / 2) {
+            node = head;
+            while (position >= node->count) {
+                position -= node->count;
+                node = node->next;
+            }
+        } else {
+            size_t fromEnd = Size - position; // 1 for the last element
+            node = tail;
+            while (fromEnd > node->count) {
+                fromEnd -= node->count;
+                node = node->prev;
+            }
+            position = node->count - fromEnd;
+        }
+        offset = (uint8_t)position;
+        return node;
+    }
+
+    // Move count elements from src to dest (ranges in the same node may overlap), leaving src unconstructed.
+    static void moveItems(T *dest, T *src, size_t count) {
+        if (dest < src) {
+            for (size_t i = 0; i < count; i++) {
+                new (dest + i) T(static_cast<T &&>(src[i]));
+                src[i].~T();
+            }
+        } else {
+            for (size_t i = count; i > 0; i--) {
+                new (dest + i - 1) T(static_cast<T &&>(src[i - 1]));
+                src[i - 1].~T();
+            }
+        }
+    }
+
+    // Create an empty node and link it after prev (or in front of the head when prev is nullptr).
+    Node *linkNodeAfter(Node *prev) {
+        Node *node = new Node();
+        node->prev = prev;
+        node->next = prev ? prev->next : head;
+        if (node->next) {
+            node->next->prev = node;
+        } else {
+            tail = node;
+        }
+        if (prev) {
+            prev->next = node;
+        } else {
+            head = node;
+        }
+        return node;
+    }
+
+    void unlinkNode(Node *node) {
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            tail = node->prev;
+        }
+        delete node;
+    }
+
+    /**
+     * @brief Insert a value at an offset of a node, splitting the node in two when it is full
+    */
+    void insertAt(Node *node, uint8_t offset, const T &value) {
+        if (node->count == K) {
+            Node *upper = linkNodeAfter(node);
+            uint8_t keep = (uint8_t)(K / 2);
+            moveItems(upper->items(), node->items() + keep, K - keep);
+            upper->count = (uint8_t)(K - keep);
+            node->count = keep;
+            if (offset > keep) {
+                offset -= keep;
+                node = upper;
+            }
+        }
+        T *items = node->items();
+        moveItems(items + offset + 1, items + offset, node->count - offset);
+        new (items + offset) T(value);
+        node->count++;
+        Size++;
+    }
+
+    /**
+     * @brief Remove the element at an offset of a node, then merge the node with a neighbour when both fit in one
+    */
+    void removeAt(Node *node, uint8_t offset) {
+        T *items = node->items();
+        items[offset].~T();
+        moveItems(items + offset, items + offset + 1, node->count - offset - 1);
+        node->count--;
+        Size--;
+        if (node->count == 0) {
+            unlinkNode(node);
+            return;
+        }
+        if (node->count >= K / 2) {
+            return;
+        }
+        if (node->next && node->count + node->next->count <= K) {
+            mergeNext(node);
+        } else if (node->prev && node->prev->count + node->count <= K) {
+            mergeNext(node->prev);
+        }
+    }
+
+    // Append the elements of node->next to node and delete node->next.
+    void mergeNext(Node *node) {
+        Node *next = node->next;
+        moveItems(node->items() + node->count, next->items(), next->count);
+        node->count += next->count;
+        next->count = 0;
+        unlinkNode(next);
+    }
+
+public:
+    /**
+     * @brief Forward Iterator
+     * @note Walks the elements of each node in order, then moves to the next node
+    */
+    class ForwardIterator {
+    private:
+        Node *current;
+        uint8_t index;
+
+    public:
+        ForwardIterator(Node *start, uint8_t index = 0) : current(start), index(index) {}
+
+        T &operator*() {
+            return current->items()[index];
+        }
+
+        bool operator!=(const ForwardIterator &other) const {
+            return current != other.current || index != other.index;
+        }
+
+        ForwardIterator &operator++() {
+            if (current && ++index == current->count) {
+                current = current->next;
+                index = 0;
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Backward Iterator
+     * @note Like DoubleLinkedList::BackwardIterator, it moves towards the head with operator--
+    */
+    class BackwardIterator {
+    private:
+        Node *current;
+        uint8_t index;
+
+    public:
+        BackwardIterator(Node *start) : current(start), index(start ? start->count - 1 : 0) {}
+
+        T &operator*() {
+            return current->items()[index];
+        }
+
+        bool operator!=(const BackwardIterator &other) const {
+            return current != other.current || index != other.index;
+        }
+
+        BackwardIterator &operator--() {
+            if (!current) {
+                return *this;
+            }
+            if (index > 0) {
+                index--;
+            } else {
+                current = current->prev;
+                index = current ? current->count - 1 : 0;
+            }
+            return *this;
+        }
+    };
+
+    ForwardIterator begin() const {
+        return ForwardIterator(head);
+    }
+
+    ForwardIterator end() const {
+        return ForwardIterator(nullptr);
+    }
+
+    BackwardIterator rbegin() const {
+        return BackwardIterator(tail);
+    }
+
+    BackwardIterator rend() const {
+        return BackwardIterator(nullptr);
+    }
+
+    UnrolledLinkedList() : head(nullptr), tail(nullptr), Size(0) {}
+
+    UnrolledLinkedList(const UnrolledLinkedList &other) : head(nullptr), tail(nullptr), Size(0) {
+        *this = other;
+    }
+
+    UnrolledLinkedList &operator=(const UnrolledLinkedList &other) {
+        if (this != &other) {
+            clear();
+            for (const Node *node = other.head; node; node = node->next) {
+                for (uint8_t i = 0; i < node->count; i++) {
+                    append(node->items()[i]);
+                }
+            }
+        }
+        return *this;
+    }
+
+    ~UnrolledLinkedList() {
+        clear();
+    }
+
+    /**
+     * @brief Add an element to the list
+     * @param value Value to add
+    */
+    void add(const T &value) {
+        append(value);
+    }
+
+    /**
+     * @brief Append an element to the end of the list
+     * @details Fills the last node; a full last node gets a new empty node after it rather than being split, so a
+     * list built by append() has full nodes.
+     * @param value Value to append
+    */
+    void append(const T &value) {
+        if (!tail || tail->count == K) {
+            linkNodeAfter(tail);
+        }
+        new (tail->items() + tail->count) T(value);
+        tail->count++;
+        Size++;
+    }
+
+    /**
+     * @brief Prepend an element to the beginning of the list
+     * @param value Value to prepend
+    */
+    void prepend(const T &value) {
+        if (!head || head->count == K) {
+            linkNodeAfter(nullptr);
+        }
+        insertAt(head, 0, value);
+    }
+
+    /**
+     * @brief Insert an element at a random position
+     * @param value Value to insert
+    */
+    void insert(const T &value) {
+        insert(value, (size_t)random(0, Size));
+    }
+
+    /**
+     * @brief Insert an element at a specific position
+     * @param value Value to insert
+     * @param position Position to insert
+     * @note If the position is greater than or equal to the size, the element will be appended
+    */
+    void insert(const T &value, size_t position) {
+        if (position >= Size) {
+            append(value);
+            return;
+        }
+        uint8_t offset;
+        Node *node = locate(position, offset);
+        insertAt(node, offset, value);
+    }
+
+    /**
+     * @brief Remove the element at a specific position
+     * @note Out of range positions are ignored
+    */
+    void remove(const int &position) {
+        if (position < 0 || (size_t)position >= Size) {
+            return;
+        }
+        uint8_t offset;
+        Node *node = locate(position, offset);
+        removeAt(node, offset);
+    }
+
+    /**
+     * @brief Remove the first occurrence of an element from the list
+    */
+    void removeElement(const T &value) {
+        for (Node *node = head; node; node = node->next) {
+            T *items = node->items();
+            for (uint8_t i = 0; i < node->count; i++) {
+                if (items[i] == value) {
+                    removeAt(node, i);
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Get the element at a specific position
+     * @param position Position to get
+     * @return T* Pointer to the element, or nullptr if the position is out of bounds
+     * @warning The pointer is invalidated by any insert or remove
+    */
+    T *get(size_t position) const {
+        if (position >= Size) {
+            return nullptr;
+        }
+        uint8_t offset;
+        Node *node = locate(position, offset);
+        return node->items() + offset;
+    }
+
+    /**
+     * @brief Get a copy of the element at a specific position
+     * @return T The element, or a default constructed T if the position is out of bounds
+    */
+    T getElement(size_t position) const {
+        T *item = get(position);
+        return item ? *item : T();
+    }
+
+    /**
+     * @brief Get the element at a specific position as a string
+     * @return String Element at the position, or an empty String if the position is out of bounds
+    */
+    String getAsString(size_t position) const {
+        T *item = get(position);
+        return item ? String(*item) : String();
+    }
+
+    /**
+     * @brief Check if the list contains a specific element
+    */
+    bool contains(const T &value) const {
+        for (const Node *node = head; node; node = node->next) {
+            const T *items = node->items();
+            for (uint8_t i = 0; i < node->count; i++) {
+                if (items[i] == value) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    size_t size() const {
+        return Size;
+    }
+
+    bool isEmpty() const {
+        return Size == 0;
+    }
+
+    /**
+     * @brief Get the number of nodes (allocations) in use
+     * @details Memory use is about nodeCount() * (sizeof(UnrolledListNode<T, K>) + allocator header).
+    */
+    size_t nodeCount() const {
+        size_t count = 0;
+        for (const Node *node = head; node; node = node->next) {
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Clear the list and release memory
+    */
+    void clear() {
+        while (head) {
+            Node *node = head;
+            head = head->next;
+            T *items = node->items();
+            for (uint8_t i = 0; i < node->count; i++) {
+                items[i].~T();
+            }
+            delete node;
+        }
+        tail = nullptr;
+        Size = 0;
+    }
+};
+#endif // UNROLLEDLINKEDLIST_H
@@ -2,6 +2,7 @@
 #define HASHTABLE_H
 
 #include <SimpleVector.h>
+#include <StringPool.h>
 #include <Arduino.h>
 
 // Forward declaration of KeyHash
@@ -83,6 +84,31 @@ struct KeyHash<double> {
         return hash;
     }
 };
+
+// Specialization for InternedString
+/**
+ * @brief A functor that hashes an InternedString key
+ * @details Interned keys are already unique small integers, so the pool Id is used as the hash.
+*/
+template<>
+struct KeyHash<InternedString> {
+    unsigned long operator()(const InternedString& key) const {
+        return static_cast<unsigned long>(key.getId());
+    }
+};
+
+// Specialization for StringPool::Id
+/**
+ * @brief A functor that hashes a StringPool::Id key, for tables whose keys live in a pool of their own
+ * @details The Id is already a unique small integer, so it is used as the hash.
+*/
+template<>
+struct KeyHash<StringPool::Id> {
+    unsigned long operator()(const StringPool::Id& key) const {
+        return static_cast<unsigned long>(key);
+    }
+};
+
 template <typename K, typename V, typename Hash = KeyHash<K>>
 class Hashtable {
 private:
@@ -232,11 +258,27 @@ public:
         **/
         KeyValuePair operator*() const {
             if (!currentEntry) {
-                return KeyValuePair{"", ""}; // Return an empty key-value pair if invalid
+                return KeyValuePair{K(), V()}; // Return an empty key-value pair if invalid
             }
             return KeyValuePair{currentEntry->key, currentEntry->value};
         }
 
+        /**
+         * @brief Returns the key of the current entry without copying the pair
+         * @note Only valid while the iterator points at an entry.
+        */
+        const K& key() const {
+            return currentEntry->key;
+        }
+
+        /**
+         * @brief Returns the value of the current entry without copying the pair
+         * @note Only valid while the iterator points at an entry.
+        */
+        V& value() const {
+            return currentEntry->value;
+        }
+
         /**
          * @brief Constructor
          * @details This constructor creates an iterator for the hash table.
@@ -0,0 +1,72 @@
+/*
+    Example Name: Scheduler Example For HeapTree Library
+
+    A small task scheduler on a 4-ary min-heap of due times. Each task keeps the Handle its entry got from insert(),
+    so a task can be rescheduled (update) or cancelled (erase) in O(log n) without searching the heap. The heap is
+    built in O(n) with heapify() at startup.
+
+    The circuit:
+    This Library does not Require any Circuits to run.
+
+    Created  month day year   // 10/18/2026
+    By author's name braydenanderson2014 (Brayden Anderson)
+    Modified day month year  // 10/18/2026
+    By author's name  braydenanderson2014 (Brayden Anderson)
+
+    https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
+
+*/
+#include <HeapTree.h>
+
+struct Entry {
+    unsigned long due;
+    uint8_t task;
+
+    bool operator>(const Entry& other) const {
+        return due > other.due;
+    }
+};
+
+typedef HeapTree<Entry, HeapGreater<Entry>, 4> Schedule; // earliest due time on top
+
+const uint8_t TASKS = 3;
+const unsigned long periods[TASKS] = { 500, 1200, 3000 };
+
+Schedule schedule(TASKS);
+Schedule::Handle handles[TASKS];
+
+void setup() {
+    Serial.begin(9600);
+    Entry start[TASKS];
+    for (uint8_t i = 0; i < TASKS; i++) {
+        start[i].due = millis() + periods[i];
+        start[i].task = i;
+    }
+    schedule.heapify(start, TASKS);
+    for (uint8_t i = 0; i < TASKS; i++) {
+        handles[i] = i; // heapify() gives the i-th value handle i
+    }
+}
+
+void loop() {
+    Entry next = schedule.top();
+    if ((long)(millis() - next.due) < 0) {
+        return;
+    }
+    Serial.print("Running task ");
+    Serial.println(next.task);
+
+    // Run it again one period later: update the entry in place instead of extracting and inserting it
+    next.due += periods[next.task];
+    schedule.update(handles[next.task], next);
+
+    // Task 0 also pulls task 2 forward when it runs
+    if (next.task == 0) {
+        const Entry *other = schedule.get(handles[2]);
+        if (other != NULL && other->due > millis() + 100) {
+            Entry sooner = *other;
+            sooner.due = millis() + 100;
+            schedule.decreaseKey(handles[2], sooner);
+        }
+    }
+}
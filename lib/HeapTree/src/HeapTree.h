@@ -2,134 +2,682 @@
 #define HEAP_TREE_h
 
 #include <Arduino.h>
+
+/**
+ * @brief Default ordering of a heap: operator<, which puts the largest value on top (a max-heap)
+*/
+template <typename T>
+struct HeapLess {
+    bool operator()(const T& a, const T& b) const {
+        return a < b;
+    }
+};
+
+/**
+ * @brief operator>: puts the smallest value on top (a min-heap, e.g. a scheduler ordered by due time)
+*/
 template <typename T>
+struct HeapGreater {
+    bool operator()(const T& a, const T& b) const {
+        return a > b;
+    }
+};
+
+/**
+ * @brief A D-ary heap (priority queue) with handles
+ *
+ * The values sit in one array in heap order: the children of index i are D * i + 1 ... D * i + D. A 4-ary heap is
+ * half as deep as a binary one and its children share a cache line, which makes it faster in practice although
+ * sifting down compares more children per level.
+ *
+ * insert() returns a Handle that keeps naming the value while it moves around the heap, so update(), decreaseKey()
+ * and erase() find it in O(1) and restore the heap in O(log n) instead of searching for it. A handle is released
+ * when its value leaves the heap and may then be given to a later insert.
+ *
+ * @tparam T The type of the values
+ * @tparam Compare Compare(a, b) is true when a belongs below b: HeapLess (the default) keeps the largest value on top,
+ * HeapGreater the smallest
+ * @tparam D The number of children per node (2 or more)
+*/
+template <typename T, typename Compare = HeapLess<T>, size_t D = 2>
 class HeapTree {
+    static_assert(D >= 2, "HeapTree needs at least 2 children per node");
+
 public:
-    HeapTree() : size(0), capacity(2) {
-        arr = new T[capacity];
+    typedef size_t Handle;
+
+    static const Handle INVALID_HANDLE = (Handle)-1;
+
+    HeapTree(size_t initialCapacity = 2, Compare compare = Compare())
+        : values(NULL), handles(NULL), positions(NULL), size(0), capacity(0), handleCount(0),
+          freeHandle(INVALID_HANDLE), compare(compare) {
+        reserve(initialCapacity ? initialCapacity : 1);
+    }
+
+    HeapTree(const HeapTree& other)
+        : values(NULL), handles(NULL), positions(NULL), size(0), capacity(0), handleCount(0),
+          freeHandle(INVALID_HANDLE), compare(other.compare) {
+        copyFrom(other);
+    }
+
+    HeapTree& operator=(const HeapTree& other) {
+        if (this != &other) {
+            compare = other.compare;
+            copyFrom(other);
+        }
+        return *this;
     }
 
     ~HeapTree() {
-        delete[] arr;
+        release();
+    }
+
+    /**
+     * @brief Make room for n values without further allocation
+     * @return bool - false if the memory could not be allocated
+    */
+    bool reserve(size_t n) {
+        if (n <= capacity) {
+            return true;
+        }
+        T* newValues = new T[n];
+        Handle* newHandles = new Handle[n];
+        Handle* newPositions = new Handle[n];
+        if (newValues == NULL || newHandles == NULL || newPositions == NULL) {
+            delete[] newValues;
+            delete[] newHandles;
+            delete[] newPositions;
+            return false;
+        }
+        for (size_t i = 0; i < size; i++) {
+            newValues[i] = values[i];
+            newHandles[i] = handles[i];
+        }
+        for (size_t h = 0; h < handleCount; h++) {
+            newPositions[h] = positions[h];
+        }
+        release();
+        values = newValues;
+        handles = newHandles;
+        positions = newPositions;
+        capacity = n;
+        return true;
     }
 
-    void insert(T value) {
-        if (size == capacity) {
-            resize();
+    /**
+     * @brief Add a value in O(log n)
+     * @return Handle - names the value until it leaves the heap, or INVALID_HANDLE if out of memory
+    */
+    Handle insert(T value) {
+        if (size == capacity && !reserve(capacity * 2)) {
+            return INVALID_HANDLE;
         }
-        arr[size] = value;
-        siftUp(size);
+        Handle handle = takeHandle();
+        values[size] = value;
+        place(size, handle);
         size++;
+        siftUp(size - 1);
+        return handle;
     }
 
-    T extractMax() {
-        T result = arr[0];
-        arr[0] = arr[size - 1];
-        size--;
-        siftDown(0);
+    /**
+     * @brief Replace the contents with count values in O(n) (bottom-up heap construction)
+     *
+     * The i-th value read from first gets handle i.
+     *
+     * @return bool - false if the memory could not be allocated (the heap is left empty)
+    */
+    template <typename Iterator>
+    bool heapify(Iterator first, size_t count) {
+        clear();
+        if (!reserve(count)) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++, ++first) {
+            values[i] = *first;
+            place(i, i);
+        }
+        size = count;
+        handleCount = count;
+        for (size_t i = size / D + 1; i > 0; i--) {
+            if (i - 1 < size) {
+                siftDown(i - 1);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the top value (the maximum for HeapLess) without removing it
+     * @return T - the top value, or a default constructed T if the heap is empty
+    */
+    T top() {
+        return size ? values[0] : T();
+    }
+
+    Handle topHandle() {
+        return size ? handles[0] : INVALID_HANDLE;
+    }
+
+    /**
+     * @brief Remove and return the top value in O(log n)
+     * @return T - the top value, or a default constructed T if the heap is empty
+    */
+    T extractTop() {
+        if (size == 0) {
+            return T();
+        }
+        T result = values[0];
+        removeAt(0);
         return result;
     }
 
+    /**
+     * @brief Same as extractTop(): the maximum for the default HeapLess
+    */
+    T extractMax() {
+        return extractTop();
+    }
+
+    /**
+     * @brief Remove and return the bottom value (the minimum for HeapLess)
+     *
+     * The bottom value is one of the leaves, so this scans the last (D - 1) / D of the array. Use MinMaxHeapTree when
+     * both ends are needed often.
+    */
     T extractMin() {
-        T result = arr[size - 1];
-        arr[size - 1] = arr[0];
-        size--;
-        siftDown(0);
+        if (size == 0) {
+            return T();
+        }
+        size_t bottom = (size - 1) / D; // the first index that can be a leaf
+        for (size_t i = bottom + 1; i < size; i++) {
+            if (compare(values[i], values[bottom])) {
+                bottom = i;
+            }
+        }
+        T result = values[bottom];
+        removeAt(bottom);
         return result;
     }
 
+    /**
+     * @brief Check if a handle names a value in the heap
+    */
+    bool contains(Handle handle) {
+        return handle < handleCount && positions[handle] < size && handles[positions[handle]] == handle;
+    }
+
+    /**
+     * @brief Get the value a handle names
+     * @return const T* - the value, or NULL if the handle is not in the heap
+    */
+    const T* get(Handle handle) {
+        return contains(handle) ? values + positions[handle] : NULL;
+    }
+
+    /**
+     * @brief Change the value a handle names and move it up or down to its place in O(log n)
+     * @return bool - false if the handle is not in the heap
+    */
+    bool update(Handle handle, const T& value) {
+        if (!contains(handle)) {
+            return false;
+        }
+        size_t i = positions[handle];
+        bool up = compare(values[i], value);
+        values[i] = value;
+        if (up) {
+            siftUp(i);
+        } else {
+            siftDown(i);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Move a value towards the top: decrease its key in a HeapGreater min-heap (increase it in a max-heap)
+     *
+     * Only sifts up, comparing one parent per level.
+     *
+     * @return bool - false if the handle is not in the heap or value would belong lower than the old value
+    */
+    bool decreaseKey(Handle handle, const T& value) {
+        if (!contains(handle) || compare(value, values[positions[handle]])) {
+            return false;
+        }
+        size_t i = positions[handle];
+        values[i] = value;
+        siftUp(i);
+        return true;
+    }
+
+    /**
+     * @brief Remove the value a handle names in O(log n)
+     * @return bool - false if the handle is not in the heap
+    */
+    bool erase(Handle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        removeAt(positions[handle]);
+        return true;
+    }
+
     bool empty() {
         return size == 0;
     }
 
+    bool isEmpty() {
+        return size == 0;
+    }
+
+    /**
+     * @brief Remove every value and release every handle. The capacity is kept.
+    */
     void clear() {
         size = 0;
+        handleCount = 0;
+        freeHandle = INVALID_HANDLE;
     }
 
     int getSize() {
         return size;
     }
 
+    /**
+     * @brief Subtract val from the value at heap index i and restore the heap
+    */
     void remove(int i, T val) {
-        arr[i] -= val;
-        if (arr[i] > arr[parent(i)]) {
-            siftUp(i);
-        } else {
-            siftDown(i);
+        if (i < 0 || (size_t)i >= size) {
+            return;
         }
+        T value = values[i];
+        value -= val;
+        update(handles[i], value);
     }
 
+    /**
+     * @brief Remove the value at heap index i
+    */
     void remove(int i) {
-        arr[i] = arr[0] + 1;
-        siftUp(i);
-        extractMax();
+        if (i >= 0 && (size_t)i < size) {
+            removeAt(i);
+        }
     }
 
+    /**
+     * @brief Remove the first value equal to value (a linear search; erase() with a handle is O(log n))
+    */
     void removeItem(T value) {
-        for (int i = 0; i < size; i++) {
-            if (arr[i] == value) {
-                remove(i);
+        for (size_t i = 0; i < size; i++) {
+            if (values[i] == value) {
+                removeAt(i);
                 break;
             }
         }
     }
 
-    HeapTree<T> getTree() {
+    HeapTree getTree() {
         return *this;
     }
 
+    /**
+     * @brief Get the values in heap order (getSize() of them)
+    */
     T* getArray() {
-        return arr;
+        return values;
     }
 
     void print() {
-        for (int i = 0; i < size; i++) {
-            Serial.print(arr[i]);
+        for (size_t i = 0; i < size; i++) {
+            Serial.print(values[i]);
             Serial.print(" ");
         }
         Serial.println();
     }
+
 private:
-    T* arr;
-    int size;
-    int capacity;
+    T* values;          // the heap, values[0] on top
+    Handle* handles;    // handles[i] names values[i]
+    Handle* positions;  // positions[h] is the index of the value handle h names; free handles link to the next free one
+    size_t size;
+    size_t capacity;
+    size_t handleCount; // handles ever given out (the used part of positions)
+    Handle freeHandle;  // first released handle, or INVALID_HANDLE
+    Compare compare;
 
-    void siftUp(int i) {
-        while (i > 0 && arr[parent(i)] < arr[i]) {
-            swap(arr[parent(i)], arr[i]);
-            i = parent(i);
+    Handle takeHandle() {
+        if (freeHandle != INVALID_HANDLE) {
+            Handle handle = freeHandle;
+            freeHandle = positions[handle];
+            return handle;
         }
+        return handleCount++;
     }
 
-    void siftDown(int i) {
-        int maxIndex = i;
-        int l = leftChild(i);
-        if (l < size && arr[l] > arr[maxIndex]) {
-            maxIndex = l;
+    void releaseHandle(Handle handle) {
+        positions[handle] = freeHandle;
+        freeHandle = handle;
+    }
+
+    void place(size_t i, Handle handle) {
+        handles[i] = handle;
+        positions[handle] = i;
+    }
+
+    // Take the value at i out of the heap: the last value fills the hole and moves up or down from there
+    void removeAt(size_t i) {
+        releaseHandle(handles[i]);
+        size--;
+        if (i == size) {
+            return;
         }
-        int r = rightChild(i);
-        if (r < size && arr[r] > arr[maxIndex]) {
-            maxIndex = r;
+        bool up = compare(values[i], values[size]);
+        values[i] = values[size];
+        place(i, handles[size]);
+        if (up) {
+            siftUp(i);
+        } else {
+            siftDown(i);
         }
-        if (i != maxIndex) {
-            swap(arr[i], arr[maxIndex]);
-            siftDown(maxIndex);
+    }
+
+    // Parents that belong below the value are moved down into the hole; the value is written once at the end.
+    void siftUp(size_t i) {
+        T value = values[i];
+        Handle handle = handles[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / D;
+            if (!compare(values[parent], value)) {
+                break;
+            }
+            values[i] = values[parent];
+            place(i, handles[parent]);
+            i = parent;
         }
+        values[i] = value;
+        place(i, handle);
     }
 
-    void resize() {
-        capacity *= 2;
-        T* temp = new T[capacity];
-        for (int i = 0; i < size; i++) {
-            temp[i] = arr[i];
+    void siftDown(size_t i) {
+        T value = values[i];
+        Handle handle = handles[i];
+        while (true) {
+            size_t first = D * i + 1;
+            if (first >= size) {
+                break;
+            }
+            size_t last = first + D < size ? first + D : size;
+            size_t best = first;
+            for (size_t child = first + 1; child < last; child++) {
+                if (compare(values[best], values[child])) {
+                    best = child;
+                }
+            }
+            if (!compare(value, values[best])) {
+                break;
+            }
+            values[i] = values[best];
+            place(i, handles[best]);
+            i = best;
         }
-        delete[] arr;
-        arr = temp;
+        values[i] = value;
+        place(i, handle);
     }
 
-    int parent(int i) { return (i - 1) / 2; }
-    int leftChild(int i) { return 2 * i + 1; }
-    int rightChild(int i) { return 2 * i + 2; }
+    void copyFrom(const HeapTree& other) {
+        clear();
+        if (!reserve(other.capacity)) {
+            return;
+        }
+        for (size_t i = 0; i < other.size; i++) {
+            values[i] = other.values[i];
+            handles[i] = other.handles[i];
+        }
+        for (size_t h = 0; h < other.handleCount; h++) {
+            positions[h] = other.positions[h];
+        }
+        size = other.size;
+        handleCount = other.handleCount;
+        freeHandle = other.freeHandle;
+    }
+
+    void release() {
+        delete[] values;
+        delete[] handles;
+        delete[] positions;
+        values = NULL;
+        handles = NULL;
+        positions = NULL;
+        capacity = 0;
+    }
+};
+
+template <typename T, typename Compare, size_t D>
+const typename HeapTree<T, Compare, D>::Handle HeapTree<T, Compare, D>::INVALID_HANDLE;
+
+/**
+ * @brief A min-max heap: both the smallest and the largest value in O(1), and both removed in O(log n)
+ *
+ * A binary heap whose even levels (the root is level 0) are ordered like a min-heap and whose odd levels like a
+ * max-heap, so the minimum is the root and the maximum one of its children. Use it for a double ended priority
+ * queue, e.g. to keep the N best readings while dropping the worst.
+ *
+ * @tparam T The type of the values
+ * @tparam Compare Compare(a, b) is true when a is smaller than b
+*/
+template <typename T, typename Compare = HeapLess<T> >
+class MinMaxHeapTree {
+public:
+    MinMaxHeapTree(size_t initialCapacity = 2, Compare compare = Compare())
+        : values(NULL), size(0), capacity(0), compare(compare) {
+        reserve(initialCapacity ? initialCapacity : 1);
+    }
+
+    MinMaxHeapTree(const MinMaxHeapTree& other) : values(NULL), size(0), capacity(0), compare(other.compare) {
+        *this = other;
+    }
+
+    MinMaxHeapTree& operator=(const MinMaxHeapTree& other) {
+        if (this != &other) {
+            compare = other.compare;
+            size = 0;
+            if (reserve(other.size)) {
+                for (size_t i = 0; i < other.size; i++) {
+                    values[i] = other.values[i];
+                }
+                size = other.size;
+            }
+        }
+        return *this;
+    }
+
+    ~MinMaxHeapTree() {
+        delete[] values;
+    }
+
+    bool reserve(size_t n) {
+        if (n <= capacity) {
+            return true;
+        }
+        T* newValues = new T[n];
+        if (newValues == NULL) {
+            return false;
+        }
+        for (size_t i = 0; i < size; i++) {
+            newValues[i] = values[i];
+        }
+        delete[] values;
+        values = newValues;
+        capacity = n;
+        return true;
+    }
+
+    /**
+     * @brief Add a value in O(log n)
+     * @return bool - false if out of memory
+    */
+    bool insert(T value) {
+        if (size == capacity && !reserve(capacity * 2)) {
+            return false;
+        }
+        values[size] = value;
+        size++;
+        pushUp(size - 1);
+        return true;
+    }
+
+    /**
+     * @brief Replace the contents with count values in O(n)
+     * @return bool - false if the memory could not be allocated (the heap is left empty)
+    */
+    template <typename Iterator>
+    bool heapify(Iterator first, size_t count) {
+        size = 0;
+        if (!reserve(count)) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++, ++first) {
+            values[i] = *first;
+        }
+        size = count;
+        for (size_t i = size / 2; i > 0; i--) {
+            pushDown(i - 1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the smallest value, or a default constructed T if the heap is empty
+    */
+    T peekMin() {
+        return size ? values[0] : T();
+    }
+
+    /**
+     * @brief Get the largest value, or a default constructed T if the heap is empty
+    */
+    T peekMax() {
+        return size ? values[maxIndex()] : T();
+    }
+
+    T extractMin() {
+        return size ? removeAt(0) : T();
+    }
+
+    T extractMax() {
+        return size ? removeAt(maxIndex()) : T();
+    }
+
+    bool isEmpty() {
+        return size == 0;
+    }
+
+    int getSize() {
+        return size;
+    }
+
+    void clear() {
+        size = 0;
+    }
+
+private:
+    T* values;
+    size_t size;
+    size_t capacity;
+    Compare compare;
+
+    static bool isMinLevel(size_t i) {
+        int level = 0;
+        for (size_t n = i + 1; n > 1; n >>= 1) {
+            level++;
+        }
+        return (level & 1) == 0;
+    }
+
+    // Is values[a] on the right side of values[b] for the kind of level: smaller on min levels, larger on max levels
+    bool before(size_t a, size_t b, bool minLevel) {
+        return minLevel ? compare(values[a], values[b]) : compare(values[b], values[a]);
+    }
+
+    void swapValues(size_t a, size_t b) {
+        T temp = values[a];
+        values[a] = values[b];
+        values[b] = temp;
+    }
+
+    size_t maxIndex() {
+        if (size < 3) {
+            return size - 1;
+        }
+        return compare(values[1], values[2]) ? 2 : 1;
+    }
+
+    T removeAt(size_t i) {
+        T result = values[i];
+        size--;
+        if (i < size) {
+            values[i] = values[size];
+            pushDown(i);
+        }
+        return result;
+    }
+
+    void pushUp(size_t i) {
+        if (i == 0) {
+            return;
+        }
+        size_t parent = (i - 1) / 2;
+        bool minLevel = isMinLevel(i);
+        if (before(parent, i, minLevel)) {
+            // The value belongs on the other kind of level: swap with the parent and climb those levels
+            swapValues(i, parent);
+            pushUpLevels(parent, !minLevel);
+        } else {
+            pushUpLevels(i, minLevel);
+        }
+    }
+
+    // Climb grandparents while the value is smaller (min levels) or larger (max levels) than them
+    void pushUpLevels(size_t i, bool minLevel) {
+        while (i >= 3) {
+            size_t grandparent = ((i - 1) / 2 - 1) / 2;
+            if (!before(i, grandparent, minLevel)) {
+                break;
+            }
+            swapValues(i, grandparent);
+            i = grandparent;
+        }
+    }
+
+    void pushDown(size_t i) {
+        bool minLevel = isMinLevel(i);
+        while (2 * i + 1 < size) {
+            // The best of the children and grandchildren
+            size_t best = 2 * i + 1;
+            size_t last = 4 * i + 6 < size ? 4 * i + 6 : size - 1;
+            for (size_t j = 2 * i + 2; j <= last; j++) {
+                if (j != 2 * i + 2 && j < 4 * i + 3) {
+                    continue;
+                }
+                if (before(j, best, minLevel)) {
+                    best = j;
+                }
+            }
+            if (!before(best, i, minLevel)) {
+                return;
+            }
+            swapValues(best, i);
+            if (best <= 2 * i + 2) {
+                return; // a child: it is on the other kind of level, where the old value is in order
+            }
+            size_t parent = (best - 1) / 2;
+            if (before(parent, best, minLevel)) {
+                swapValues(best, parent);
+            }
+            i = best;
+        }
+    }
 };
 
 #endif // HEAP_TREE_h
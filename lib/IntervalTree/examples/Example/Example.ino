@@ -8,7 +8,7 @@
 
     Created  month day year   // 03/01/2024
     By author's name braydenanderson2014 (Brayden Anderson)
-    Modified day month year  // 03/01/2024
+    Modified day month year  // 10/18/2026
     By author's name  braydenanderson2014 (Brayden Anderson)
 
     https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
@@ -60,6 +60,15 @@ void setup(){
         Serial.println("Interval not found");
     }
 
+    Interval<int> hits[8];
+    size_t found = tree.findAllOverlapping(searchInterval, hits, 8); // Every interval overlapping [14, 16]
+    Serial.println(String(found) + " intervals overlap [14, 16]");
+
+    found = tree.stab(58, hits, 8); // Every interval containing the point 58
+    for (size_t i = 0; i < found && i < 8; i++) {
+        Serial.println("Contains 58: [" + String(hits[i].low) + ", " + String(hits[i].high) + "]");
+    }
+
     
 }
 
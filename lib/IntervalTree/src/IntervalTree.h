@@ -3,6 +3,14 @@
 
 #include <Arduino.h>
 #include <TypeTraits.h>
+#include <Stack.h>
+
+// Entries the stacks of inorder(), deleteNode() and the overlap queries keep inline instead of recursing (one per level
+// of the deepest path). The tree is not rebalanced, so intervals inserted in order of their low end build a path as
+// long as the number of intervals; the entries past this many spill to the heap.
+#ifndef INTERVALTREE_STACK_DEPTH
+#define INTERVALTREE_STACK_DEPTH 64
+#endif
 
 template <typename T>
 struct Interval {
@@ -14,7 +22,7 @@ template <typename T>
 struct IntervalTreeNode {
     static_assert(is_arithmetic<T>::value, "IntervalTreeNode only supports int types");
     Interval<T> i; // interval
-    int max; // max endpoint in subtree rooted with this node
+    T max; // max endpoint in subtree rooted with this node
     IntervalTreeNode *left, *right;
 };
 
@@ -23,53 +31,87 @@ class IntervalTree {
     static_assert(is_arithmetic<T>::value, "IntervalTree only supports int types");
     IntervalTreeNode<T>* root = nullptr;
 
-    IntervalTreeNode<T>* insert(IntervalTreeNode<T>* node, Interval<T> i){
-        if(node == nullptr){
-            return new IntervalTreeNode<T>(i);
-        }
-        int l = node->i.low;
-        if(i.low < l){
-            node->left = insert(node->left, i);
-        } else {
-            node->right = insert(node->right, i);
+    IntervalTreeNode<T>* createNode(Interval<T> i){
+        IntervalTreeNode<T>* node = new IntervalTreeNode<T>();
+        node->i = i;
+        node->max = i.high;
+        node->left = nullptr;
+        node->right = nullptr;
+        return node;
+    }
+
+    typedef SpillStack<IntervalTreeNode<T>*, INTERVALTREE_STACK_DEPTH> NodeStack;
+    typedef SpillStack<IntervalTreeNode<T>**, INTERVALTREE_STACK_DEPTH> LinkStack;
+
+    static bool outOfMemory(){
+        Serial.println("Memory Error");
+        return false;
+    }
+
+    // Recompute the max of a node from its own high end and its children
+    static void updateMax(IntervalTreeNode<T>* node){
+        T max = node->i.high;
+        if(node->left != nullptr && node->left->max > max){
+            max = node->left->max;
         }
-        if(node->max < i.high){
-            node->max = i.high;
+        if(node->right != nullptr && node->right->max > max){
+            max = node->right->max;
         }
-        return node;
+        node->max = max;
     }
 
-    IntervalTreeNode<T>* deleteNode(IntervalTreeNode<T>* node, Interval<T> i){
-        if(node == nullptr){
-            return node;
-        }
-        if(i.low < node->i.low){
-            node->left = deleteNode(node->left, i);
-        } else if(i.low > node->i.low){
-            node->right = deleteNode(node->right, i);
-        } else {
-            if(node->left == nullptr){
-                IntervalTreeNode<T>* temp = node->right;
-                delete node;
-                return temp;
-            } else if(node->right == nullptr){
-                IntervalTreeNode<T>* temp = node->left;
-                delete node;
-                return temp;
+    /**
+     * @brief Visit the intervals that overlap query in order of their low end as visit(interval)
+     *
+     * A subtree is skipped when its max ends before query starts, and the walk stops at the first interval that
+     * starts after query ends (every later one starts later still), so it costs O(k + h) for k results in a tree of
+     * height h rather than O(n).
+     *
+     * @return bool - false if a deep path could not be spilled to the heap (the walk stops early)
+    */
+    template <typename Visit>
+    bool overlapWalk(Interval<T> query, Visit visit){
+        NodeStack pending;
+        IntervalTreeNode<T>* node = root;
+        while(node != nullptr || !pending.isEmpty()){
+            if(node != nullptr){
+                if(node->max < query.low){
+                    node = nullptr;
+                    continue;
+                }
+                if(!pending.push(node)){
+                    return outOfMemory();
+                }
+                node = node->left;
+            } else {
+                node = pending.pop();
+                if(node->i.low > query.high){
+                    return true;
+                }
+                if(query.low <= node->i.high){
+                    visit(node->i);
+                }
+                node = node->right;
             }
-            IntervalTreeNode<T>* temp = minValueNode(node->right);
-            node->i = temp->i;
-            node->right = deleteNode(node->right, temp->i);
         }
-        return node;
+        return true;
     }
+
     void inorder(IntervalTreeNode<T>* node){
-        if(node == nullptr){
-            return;
+        NodeStack pending;
+        while(node != nullptr || !pending.isEmpty()){
+            if(node != nullptr){
+                if(!pending.push(node)){
+                    outOfMemory();
+                    return;
+                }
+                node = node->left;
+            } else {
+                node = pending.pop();
+                Serial.print("[" + String(node->i.low) + ", " + String(node->i.high) + "] ");
+                node = node->right;
+            }
         }
-        inorder(node->left);
-        Serial.print("[" + String(node->i.low) + ", " + String(node->i.high) + "] ");
-        inorder(node->right);
     }
 
     bool doOverlap(Interval<T> i1, Interval<T> i2){
@@ -80,27 +122,23 @@ class IntervalTree {
     }
 
     IntervalTreeNode<T>* search(IntervalTreeNode<T>* node, Interval<T> i){
-        if(node == nullptr){
-            return nullptr;
-        }
-        if(doOverlap(node->i, i)){
-            return node;
-        }
-        if(node->left != nullptr && node->left->max >= i.low){
-            return search(node->left, i);
+        while(node != nullptr && !doOverlap(node->i, i)){
+            if(node->left != nullptr && node->left->max >= i.low){
+                node = node->left;
+            } else {
+                node = node->right;
+            }
         }
-        return search(node->right, i);
-    }
-
-    int Max(int a, int b){
-        return (a > b) ? a : b;
+        return node;
     }
 
     int height(IntervalTreeNode<T>* node){
         if(node == nullptr){
             return 0;
         }
-        return 1 + Max(height(node->left), height(node->right));
+        int left = height(node->left);
+        int right = height(node->right);
+        return 1 + (left > right ? left : right);
     }
     int getBalance(IntervalTreeNode<T>* node){
         if(node == nullptr){
@@ -113,8 +151,8 @@ class IntervalTree {
         IntervalTreeNode<T>* T2 = y->left;
         y->left = node;
         node->right = T2;
-        node->max = Max(node->i.high, Max((node->left != nullptr) ? node->left->max : 0, (node->right != nullptr) ? node->right->max : 0));
-        y->max = Max(y->i.high, Max((y->left != nullptr) ? y->left->max : 0, (y->right != nullptr) ? y->right->max : 0));
+        updateMax(node);
+        updateMax(y);
         return y;
     }
     IntervalTreeNode<T>* rightRotate(IntervalTreeNode<T>* node){
@@ -122,33 +160,215 @@ class IntervalTree {
         IntervalTreeNode<T>* T2 = x->right;
         x->right = node;
         node->left = T2;
-        node->max = Max(node->i.high, Max((node->left != nullptr) ? node->left->max : 0, (node->right != nullptr) ? node->right->max : 0));
-        x->max = Max(x->i.high, Max((x->left != nullptr) ? x->left->max : 0, (x->right != nullptr) ? x->right->max : 0));
+        updateMax(node);
+        updateMax(x);
         return x;
     }
-    IntervalTreeNode<T>* minValueNode(IntervalTreeNode<T>* node){
-        IntervalTreeNode<T>* current = node;
-        while(current->left != nullptr){
-            current = current->left;
-        }
-        return current;
-    }
     
     
 public:
+    // Returned by the overlap queries when a walk could not spill its stack to the heap; the intervals visited
+    // before it stopped are not all of them.
+    static const size_t QUERY_FAILED = (size_t)-1;
+
+    IntervalTree() {}
+
+    ~IntervalTree(){
+        clear();
+    }
+
+    IntervalTree(const IntervalTree&) = delete;
+    IntervalTree& operator=(const IntervalTree&) = delete;
 
+    // Walks down from the root, raising max on the way, so no recursion is needed
     void insert(Interval<T> i){
-        root = insert(root, i);
+        IntervalTreeNode<T>** link = &root;
+        while(*link != nullptr){
+            IntervalTreeNode<T>* node = *link;
+            if(node->max < i.high){
+                node->max = i.high;
+            }
+            link = (i.low < node->i.low) ? &node->left : &node->right;
+        }
+        *link = createNode(i);
     }
+    /**
+     * @brief Delete the interval equal to i (same low and high end), if there is one
+     *
+     * Walks down in a loop, keeping the path on a stack so the max of every node above the deleted one can be
+     * brought back down afterwards. The tree is left unchanged if a deep path cannot be spilled to the heap.
+    */
     void deleteNode(Interval<T> i){
-        root = deleteNode(root, i);
+        LinkStack path;
+        IntervalTreeNode<T>** link = &root;
+        while(*link != nullptr){
+            IntervalTreeNode<T>* node = *link;
+            if(i.low == node->i.low && i.high == node->i.high){
+                break;
+            }
+            if(!path.push(link)){
+                outOfMemory();
+                return;
+            }
+            // Equal low ends go right on insert
+            link = (i.low < node->i.low) ? &node->left : &node->right;
+        }
+        IntervalTreeNode<T>* node = *link;
+        if(node == nullptr){
+            return;
+        }
+        if(node->left != nullptr && node->right != nullptr){
+            // Two children: move the interval of the leftmost node on the right up, and unlink that node instead
+            if(!path.push(link)){
+                outOfMemory();
+                return;
+            }
+            link = &node->right;
+            while((*link)->left != nullptr){
+                if(!path.push(link)){
+                    outOfMemory();
+                    return;
+                }
+                link = &(*link)->left;
+            }
+            node->i = (*link)->i;
+            node = *link;
+        }
+        *link = node->left != nullptr ? node->left : node->right;
+        delete node;
+        while(path.pop(link)){
+            updateMax(*link);
+        }
     }
     void inorder(){
         inorder(root);
     }
+    /**
+     * @brief Delete every node without recursion or a stack
+     *
+     * Rotates left children up until the root has none, then deletes the root and continues with its right child.
+    */
+    void clear(){
+        while(root != nullptr){
+            if(root->left != nullptr){
+                IntervalTreeNode<T>* left = root->left;
+                root->left = left->right;
+                left->right = root;
+                root = left;
+            } else {
+                IntervalTreeNode<T>* right = root->right;
+                delete root;
+                root = right;
+            }
+        }
+    }
+    /**
+     * @brief Find one interval that overlaps i
+     * @return IntervalTreeNode<T>* - the node holding it, or nullptr if none does
+    */
     IntervalTreeNode<T>* search(Interval<T> i){
         return search(root, i);
     }
+
+    /**
+     * @brief Copy every interval that overlaps i into out, in order of their low end
+     *
+     * @param i - the query interval (both ends included)
+     * @param out - receives up to capacity intervals
+     * @param capacity - the size of out
+     * @return size_t - the number of overlapping intervals, which may be more than capacity, or QUERY_FAILED
+    */
+    size_t findAllOverlapping(Interval<T> i, Interval<T>* out, size_t capacity){
+        size_t found = 0;
+        bool walked = overlapWalk(i, [&found, out, capacity](const Interval<T>& interval){
+            if(found < capacity){
+                out[found] = interval;
+            }
+            found++;
+        });
+        if(!walked){
+            return QUERY_FAILED;
+        }
+        return found;
+    }
+
+    /**
+     * @brief Call visit(interval) for every interval that overlaps i, in order of their low end
+     * @return size_t - the number of overlapping intervals, or QUERY_FAILED if the walk stopped early
+    */
+    template <typename Visit>
+    size_t forEachOverlapping(Interval<T> i, Visit visit){
+        size_t found = 0;
+        bool walked = overlapWalk(i, [&found, &visit](const Interval<T>& interval){
+            visit(interval);
+            found++;
+        });
+        if(!walked){
+            return QUERY_FAILED;
+        }
+        return found;
+    }
+
+    /**
+     * @brief Copy every interval that contains point into out
+     * @see findAllOverlapping
+    */
+    size_t stab(T point, Interval<T>* out, size_t capacity){
+        Interval<T> i = { point, point };
+        return findAllOverlapping(i, out, capacity);
+    }
+
+    /**
+     * @brief Answer stab queries for many points in one walk of the tree
+     *
+     * Calls visit(index, interval) for every interval that contains points[index]. The intervals come in order of
+     * their low end, and for each one the points it contains in ascending order. Because both the points and the
+     * in-order walk are sorted, the first point an interval can contain only moves forward: a subtree is skipped
+     * when its max is below that point, and the walk stops once an interval starts after the last point. The cost is
+     * O(n' + m + k) for the n' nodes reached, m points and k results, instead of m separate searches.
+     *
+     * @param points - the points, sorted in ascending order
+     * @param count - the number of points
+     * @param visit - called as visit(size_t index, const Interval<T>& interval)
+     * @return size_t - the number of (point, interval) pairs visited, or QUERY_FAILED if the walk stopped early
+    */
+    template <typename Visit>
+    size_t stabBatch(const T* points, size_t count, Visit visit){
+        size_t found = 0;
+        size_t first = 0; // the first point not below the low end of the last interval visited
+        NodeStack pending;
+        IntervalTreeNode<T>* node = root;
+        while(first < count && (node != nullptr || !pending.isEmpty())){
+            if(node != nullptr){
+                if(node->max < points[first]){
+                    node = nullptr;
+                    continue;
+                }
+                if(!pending.push(node)){
+                    outOfMemory();
+                    return QUERY_FAILED;
+                }
+                node = node->left;
+            } else {
+                node = pending.pop();
+                if(node->i.low > points[count - 1]){
+                    break;
+                }
+                while(first < count && points[first] < node->i.low){
+                    first++;
+                }
+                for(size_t p = first; p < count && !(node->i.high < points[p]); p++){
+                    visit(p, node->i);
+                    found++;
+                }
+                node = node->right;
+            }
+        }
+        return found;
+    }
 };
 
+template <typename T>
+const size_t IntervalTree<T>::QUERY_FAILED;
+
 #endif // INTERVAL_TREE_h
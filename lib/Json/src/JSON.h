@@ -2,148 +2,955 @@
 #define JSON_H
 
 #include <CustomString.h>
-#include "SimpleVector.h"
 #include <SD.h>
 
 class JSON {
 public:
+    // Nodes and their text live in the document's Arena, so their addresses never change and
+    // the whole tree is released at once by reset() or the destructor.
     struct Node {
-        Custom_String::String key;
-        Custom_String::String value;
-        SimpleVector<Node> children;
+        const char* key;
+        char* value;
+        Node* firstChild;
+        Node* lastChild;
+        Node* nextSibling;
+        Node* parent; // nullptr only for the document root; lets a path index hit be checked segment by segment
+        uint32_t keyHash; // hashKey() of key, so lookups compare one integer before touching the characters
+        unsigned int keyLength;
+        unsigned int childCount; // Children linked so far; the next array element's index key
+        unsigned int valueCapacity; // Bytes available at value, so set() can overwrite shorter values in place
+        bool isArray; // Children are array elements and are written without their (index) keys
+        bool isObject; // Written as an object even when it has no members, so {} survives a round trip
+        bool isRaw; // value is a number or literal (true, false, null) and is written without quotes
 
-        Node(const Custom_String::String& key = "", const Custom_String::String& value = "") : key(key), value(value) {}
+        bool hasChildren() const {
+            return firstChild != nullptr;
+        }
+    };
+
+    // Bump allocator owning every Node and string byte of a document. Memory is taken from blocks of
+    // BLOCK_SIZE bytes (larger requests get a block of their own) and is only given back by reset().
+    class Arena {
+    public:
+        static const unsigned int BLOCK_SIZE = 256;
+
+        Arena() : head(nullptr), used(0) {}
+
+        ~Arena() {
+            reset();
+        }
+
+        // Returns size bytes at a multiple of align (a power of two), or nullptr when the heap is exhausted.
+        void* allocate(unsigned int size, unsigned int align = alignof(Node)) {
+            if (size > BLOCK_SIZE / 2) {
+                // Large request: give it its own block behind the current one so the current block keeps filling.
+                Block* block = newBlock(size);
+                if (!block) {
+                    return nullptr;
+                }
+                if (head) {
+                    block->next = head->next;
+                    head->next = block;
+                } else {
+                    block->next = nullptr;
+                    head = block;
+                    used = size;
+                }
+                return block->data();
+            }
+            unsigned int start = (used + align - 1) & ~(align - 1);
+            if (!head || start + size > head->size) {
+                Block* block = newBlock(BLOCK_SIZE);
+                if (!block) {
+                    return nullptr;
+                }
+                block->next = head;
+                head = block;
+                start = 0;
+            }
+            used = start + size;
+            return head->data() + start;
+        }
+
+        // Copies length characters into the arena and null-terminates them.
+        char* copyString(const char* text, unsigned int length) {
+            char* copy = (char*)allocate(length + 1, 1);
+            if (copy) {
+                memcpy(copy, text, length);
+                copy[length] = '\0';
+            }
+            return copy;
+        }
+
+        // Frees every block at once.
+        void reset() {
+            while (head) {
+                Block* next = head->next;
+                delete[] (char*)head;
+                head = next;
+            }
+            used = 0;
+        }
+
+        // Total bytes held, including unused space at the end of the current block.
+        unsigned int bytesReserved() const {
+            unsigned int total = 0;
+            for (Block* block = head; block; block = block->next) {
+                total += sizeof(Block) + block->size;
+            }
+            return total;
+        }
+
+    private:
+        // Block headers keep the data that follows them aligned for Node
+        struct Block {
+            Block* next;
+            unsigned int size;
+
+            char* data() {
+                return (char*)(this + 1);
+            }
+        };
+
+        Block* head;
+        unsigned int used;
+
+        Arena(const Arena&);
+        Arena& operator=(const Arena&);
+
+        static Block* newBlock(unsigned int size) {
+            Block* block = (Block*)new char[sizeof(Block) + size];
+            block->size = size;
+            return block;
+        }
+    };
+
+    // FNV-1a hash of length characters. Used for node keys and for whole paths in the path index.
+    static uint32_t hashKey(const char* text, unsigned int length) {
+        uint32_t hash = 2166136261UL;
+        for (unsigned int i = 0; i < length; i++) {
+            hash = (hash ^ (unsigned char)text[i]) * 16777619UL;
+        }
+        return hash;
+    }
+
+    // Deepest nesting the Reader, the Writer and set() accept, counting the document's outer braces as one level.
+    // A path can therefore have at most MAX_DEPTH segments.
+    static const unsigned int MAX_DEPTH = 16;
+
+    // Event-driven pull parser. Reads a Stream through a small fixed buffer, so a document never has to fit in RAM;
+    // only the current key or value is held in memory. Also accepts the legacy files written before this parser
+    // existed (no outer braces, trailing commas).
+    class Reader {
+    public:
+        enum Event { BEGIN_OBJECT, END_OBJECT, BEGIN_ARRAY, END_ARRAY, KEY, VALUE, END_DOCUMENT, ERROR };
+
+        static const unsigned int BUFFER_SIZE = 32;
+
+        Reader(Stream& stream) : stream(stream), head(0), fill(0), depth(0), arrayBits(0), expectKey(false), started(false), implicitRoot(false), quoted(false), token(nullptr), tokenLength(0), tokenCapacity(0) {}
+
+        ~Reader() {
+            delete[] token;
+        }
+
+        // Advances to the next event. KEY and VALUE events make their text available through text().
+        Event next() {
+            if (!started) {
+                started = true;
+                int first = skipSeparators();
+                if (first != '{' && first != '[' && first != -1) {
+                    // Legacy document: a bare list of "key": value pairs.
+                    implicitRoot = true;
+                    push(false);
+                    return BEGIN_OBJECT;
+                }
+            }
+
+            int c = skipSeparators();
+            switch (c) {
+                case -1:
+                    if (implicitRoot && depth == 1) {
+                        implicitRoot = false;
+                        pop();
+                        return END_OBJECT;
+                    }
+                    return depth == 0 ? END_DOCUMENT : ERROR;
+                case '{':
+                    take();
+                    return push(false) ? BEGIN_OBJECT : ERROR;
+                case '[':
+                    take();
+                    return push(true) ? BEGIN_ARRAY : ERROR;
+                case '}':
+                    take();
+                    return depth > 0 && !inArray() && pop() ? END_OBJECT : ERROR;
+                case ']':
+                    take();
+                    return depth > 0 && inArray() && pop() ? END_ARRAY : ERROR;
+                case '"':
+                    take();
+                    if (!readString()) {
+                        return ERROR;
+                    }
+                    if (expectKey) {
+                        if (skipSeparators() != ':') {
+                            return ERROR;
+                        }
+                        take();
+                        expectKey = false;
+                        return KEY;
+                    }
+                    quoted = true;
+                    expectKey = inObject();
+                    return VALUE;
+                default:
+                    readLiteral();
+                    quoted = false;
+                    expectKey = inObject();
+                    return tokenLength == 0 ? ERROR : VALUE;
+            }
+        }
+
+        // Text of the last KEY or VALUE event. Valid until the next call to next().
+        const char* text() const {
+            return token ? token : "";
+        }
+
+        unsigned int textLength() const {
+            return tokenLength;
+        }
+
+        // True if the last VALUE was a quoted string rather than a number or literal.
+        bool isString() const {
+            return quoted;
+        }
+
+        // Number of currently open objects and arrays.
+        unsigned int level() const {
+            return depth;
+        }
+
+    private:
+        Stream& stream;
+        char buffer[BUFFER_SIZE];
+        unsigned char head;
+        unsigned char fill;
+        unsigned char depth;
+        uint32_t arrayBits; // Bit n is set while the container at depth n + 1 is an array
+        bool expectKey;
+        bool started;
+        bool implicitRoot;
+        bool quoted;
+        char* token; // Reused for every key and value; only grows, so steady-state parsing does not allocate
+        unsigned int tokenLength;
+        unsigned int tokenCapacity;
+
+        Reader(const Reader&);
+        Reader& operator=(const Reader&);
+
+        int peekChar() {
+            if (head == fill) {
+                fill = 0;
+                head = 0;
+                while (fill < BUFFER_SIZE && stream.available() > 0) {
+                    int c = stream.read();
+                    if (c < 0) {
+                        break;
+                    }
+                    buffer[fill++] = (char)c;
+                }
+                if (fill == 0) {
+                    return -1;
+                }
+            }
+            return (unsigned char)buffer[head];
+        }
+
+        int take() {
+            int c = peekChar();
+            if (c >= 0) {
+                head++;
+            }
+            return c;
+        }
+
+        // Skips whitespace and ',' and returns the next significant character without consuming it. A ':' is left for
+        // next(), which only accepts it after a key.
+        int skipSeparators() {
+            int c = peekChar();
+            while (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',') {
+                head++;
+                c = peekChar();
+            }
+            return c;
+        }
+
+        bool inArray() const {
+            return depth > 0 && (arrayBits & (1UL << (depth - 1)));
+        }
+
+        bool inObject() const {
+            return depth > 0 && !inArray();
+        }
+
+        bool push(bool isArray) {
+            if (depth >= MAX_DEPTH) {
+                return false;
+            }
+            if (isArray) {
+                arrayBits |= (1UL << depth);
+            } else {
+                arrayBits &= ~(1UL << depth);
+            }
+            depth++;
+            expectKey = !isArray;
+            return true;
+        }
+
+        bool pop() {
+            depth--;
+            expectKey = inObject();
+            return true;
+        }
+
+        void appendToken(char c) {
+            if (tokenLength + 1 >= tokenCapacity) {
+                unsigned int newCapacity = tokenCapacity == 0 ? BUFFER_SIZE : tokenCapacity * 2;
+                char* newToken = new char[newCapacity];
+                if (token) {
+                    memcpy(newToken, token, tokenLength);
+                    delete[] token;
+                }
+                token = newToken;
+                tokenCapacity = newCapacity;
+            }
+            token[tokenLength++] = c;
+            token[tokenLength] = '\0';
+        }
+
+        void clearToken() {
+            tokenLength = 0;
+            if (token) {
+                token[0] = '\0';
+            }
+        }
+
+        bool readString() {
+            clearToken();
+            while (true) {
+                int c = take();
+                if (c < 0) {
+                    return false;
+                }
+                if (c == '"') {
+                    break;
+                }
+                if (c == '\\') {
+                    c = take();
+                    switch (c) {
+                        case 'n': c = '\n'; break;
+                        case 't': c = '\t'; break;
+                        case 'r': c = '\r'; break;
+                        case 'b': c = '\b'; break;
+                        case 'f': c = '\f'; break;
+                        case 'u': {
+                            unsigned int code = 0;
+                            for (int i = 0; i < 4; i++) {
+                                int h = take();
+                                code = code * 16 + (h >= 'a' ? h - 'a' + 10 : h >= 'A' ? h - 'A' + 10 : h - '0');
+                            }
+                            c = code < 0x80 ? (int)code : '?';
+                            break;
+                        }
+                        case -1: return false;
+                        default: break; // '"', '\\' and '/' stand for themselves
+                    }
+                }
+                appendToken((char)c);
+            }
+            return true;
+        }
+
+        void readLiteral() {
+            clearToken();
+            int c = peekChar();
+            while (c >= 0 && c != ',' && c != '}' && c != ']' && c != ':' && c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                appendToken((char)c);
+                head++;
+                c = peekChar();
+            }
+        }
+    };
+
+    // Chunked writer. Output is staged in a small fixed buffer and handed to the Print in blocks,
+    // so serializing never builds the whole document in memory.
+    class Writer {
+    public:
+        static const unsigned int BUFFER_SIZE = 64;
+
+        Writer(Print& out) : out(out), used(0), depth(0), firstBits(1), afterKey(false), failed(false) {}
+
+        ~Writer() {
+            flush();
+        }
+
+        void beginObject() {
+            open('{');
+        }
+
+        void endObject() {
+            close('}');
+        }
+
+        void beginArray() {
+            open('[');
+        }
+
+        void endArray() {
+            close(']');
+        }
+
+        // Writes a member name; the next begin or value call supplies its value.
+        void key(const char* name) {
+            separator();
+            writeQuoted(name);
+            write(": ");
+            afterKey = true;
+        }
+
+        // Writes a quoted, escaped string value.
+        void value(const char* text) {
+            separator();
+            writeQuoted(text);
+        }
+
+        // Writes a value verbatim (numbers, true, false, null).
+        void rawValue(const char* text) {
+            separator();
+            write(text);
+        }
+
+        // False once a begin call went past MAX_DEPTH; nothing is written after that point.
+        bool ok() const {
+            return !failed;
+        }
+
+        // Hands the buffered bytes to the Print.
+        void flush() {
+            if (used > 0) {
+                out.write((const uint8_t*)buffer, used);
+                used = 0;
+            }
+        }
+
+    private:
+        Print& out;
+        char buffer[BUFFER_SIZE];
+        unsigned char used;
+        unsigned char depth;
+        uint32_t firstBits; // Bit n is set while nothing has been written yet at depth n
+        bool afterKey;
+        bool failed;
+
+        void put(char c) {
+            if (failed) {
+                return;
+            }
+            if (used == BUFFER_SIZE) {
+                flush();
+            }
+            buffer[used++] = c;
+        }
+
+        void write(const char* text) {
+            while (*text) {
+                put(*text++);
+            }
+        }
+
+        void indent() {
+            put('\n');
+            for (unsigned int i = 0; i < depth; i++) {
+                write("  ");
+            }
+        }
+
+        // Emits the comma and line break that precede a new member or element.
+        void separator() {
+            if (afterKey) {
+                afterKey = false;
+                return;
+            }
+            if (!(firstBits & (1UL << depth))) {
+                put(',');
+            }
+            firstBits &= ~(1UL << depth);
+            if (depth > 0) {
+                indent();
+            }
+        }
+
+        // A Reader would refuse anything nested deeper, so the Writer stops instead of producing it.
+        void open(char bracket) {
+            if (depth == MAX_DEPTH) {
+                failed = true;
+            }
+            if (failed) {
+                return;
+            }
+            separator();
+            put(bracket);
+            depth++;
+            firstBits |= (1UL << depth);
+        }
+
+        void close(char bracket) {
+            if (failed || depth == 0) {
+                return;
+            }
+            bool empty = firstBits & (1UL << depth);
+            depth--;
+            if (!empty) {
+                indent();
+            }
+            put(bracket);
+            if (depth == 0) {
+                put('\n');
+            }
+        }
+
+        void writeQuoted(const char* text) {
+            put('"');
+            for (; *text; text++) {
+                char c = *text;
+                if (c == '"' || c == '\\') {
+                    put('\\');
+                    put(c);
+                } else if (c == '\n') {
+                    write("\\n");
+                } else if (c == '\r') {
+                    write("\\r");
+                } else if (c == '\t') {
+                    write("\\t");
+                } else {
+                    put(c);
+                }
+            }
+            put('"');
+        }
     };
 
 private:
+    Arena arena;
     Node root;
 
+    // Path index entry: hash of a full dotted path and the node it resolved to.
+    struct PathSlot {
+        uint32_t hash;
+        Node* node;
+    };
+
+    // Optional, lazily filled open-addressing table. Arena nodes never move, so entries stay valid
+    // until the document is reset or reloaded.
+    mutable PathSlot* index;
+    mutable unsigned int indexMask;
+    mutable unsigned int indexCount;
+
 public:
-    JSON() {}
+    JSON() : index(nullptr), indexMask(0), indexCount(0) {
+        initNode(root, "", 0);
+    }
 
-    // Adds or updates a value by its path, supporting nested structures.
-    void set(const Custom_String::String& path, const Custom_String::String& value) {
-        auto& node = findOrCreateNode(path);
-        node.value = value;
+    JSON(const JSON& other) : index(nullptr), indexMask(0), indexCount(0) {
+        initNode(root, "", 0);
+        copyChildren(other.root, root);
     }
 
-    // Retrieves a value by its path as a string. Returns an empty string if not found.
-    Custom_String::String get(const Custom_String::String& path) const {
-        const Node* node = findNode(path);
+    JSON& operator=(const JSON& other) {
+        if (this != &other) {
+            reset();
+            copyChildren(other.root, root);
+        }
+        return *this;
+    }
+
+    ~JSON() {
+        delete[] index;
+    }
+
+    // Drops every node and returns the arena's memory in one step.
+    void reset() {
+        arena.reset();
+        initNode(root, "", 0);
+        invalidatePathIndex();
+    }
+
+    // Bytes currently held by the document's arena.
+    unsigned int memoryUsed() const {
+        return arena.bytesReserved();
+    }
+
+    // Enables the path index with room for at least the given number of paths (rounded up to a power of two).
+    // Repeated get()/set() on the same paths then cost one hash and one probe instead of a walk per segment.
+    void enablePathIndex(unsigned int paths = 16) {
+        unsigned int slots = 4;
+        while (slots < paths + paths / 3) {
+            slots <<= 1;
+        }
+        delete[] index;
+        index = new PathSlot[slots];
+        indexMask = slots - 1;
+        invalidatePathIndex();
+    }
+
+    // Frees the path index; lookups walk the tree again.
+    void disablePathIndex() {
+        delete[] index;
+        index = nullptr;
+        indexMask = 0;
+        indexCount = 0;
+    }
+
+    // Adds or updates a value by its path, supporting nested structures. The value is stored as a string.
+    // A value no longer than the one it replaces is overwritten in place; a longer one takes new arena space.
+    // In an array only the next index can be added; an element further on is refused rather than stored elsewhere.
+    // Returns false if the path has more than MAX_DEPTH segments, skips array elements or the arena is exhausted.
+    bool set(const char* path, const char* value) {
+        Node* node = const_cast<Node*>(lookup(path));
+        if (!node) {
+            node = findOrCreateNode(path);
+        }
+        if (!node || !setValue(*node, value, strlen(value))) {
+            return false;
+        }
+        node->isRaw = false;
+        return true;
+    }
+
+    bool set(const Custom_String::String& path, const Custom_String::String& value) {
+        return set(path.C_STR(), value.C_STR());
+    }
+
+    // Retrieves a value by its path. Returns an empty string if not found. Does not allocate.
+    const char* get(const char* path) const {
+        const Node* node = lookup(path);
         if (node) {
             return node->value;
         }
         return "";
     }
 
-    // Writes the JSON structure to a file.
+    Custom_String::String get(const Custom_String::String& path) const {
+        return Custom_String::String(get(path.C_STR()));
+    }
+
+    // Writes the JSON structure to a file, replacing its previous contents.
     void writeToFile(const Custom_String::String& filename) {
+        SD.remove(filename.C_STR());
         File file = SD.open(filename.C_STR(), FILE_WRITE);
         if (file) {
-            Custom_String::String jsonStr;
-            serializeNode(root, jsonStr, 0);
-            file.println(jsonStr.C_STR());
+            writeTo(file);
             file.close();
         }
     }
-    
-    //Deserializes the JSON structure from a string.
+
+    // Streams the JSON structure to any Print through a Writer. Returns false if the tree is nested deeper than
+    // MAX_DEPTH (the output then stops there).
+    bool writeTo(Print& out) const {
+        Writer writer(out);
+        writer.beginObject();
+        serializeNode(root, writer);
+        writer.endObject();
+        writer.flush();
+        return writer.ok();
+    }
+
+    // Reads the JSON structure from a file, replacing the current contents.
     void readFromFile(const Custom_String::String& filename) {
         File file = SD.open(filename.C_STR(), FILE_READ);
         if (file) {
-            String jsonStr =file.readString();
-            Custom_String::String jsonSTR = jsonStr.c_str();
+            readFrom(file);
             file.close();
-            deserializeNode(jsonSTR, root);
+        }
+    }
+
+    // Builds the tree from a Reader's events. Returns false on malformed input (the nodes read so far are kept).
+    bool readFrom(Stream& in) {
+        reset();
+        Reader reader(in);
+        Node* path[MAX_DEPTH + 1];
+        unsigned int depth = 0;
+        char* key = nullptr;
+        unsigned int keyLength = 0;
+        path[0] = &root;
+
+        if (reader.next() != Reader::BEGIN_OBJECT) {
+            return false;
+        }
+        while (true) {
+            Reader::Event event = reader.next();
+            Node* parent = path[depth];
+            Node* child = nullptr;
+            switch (event) {
+                case Reader::KEY:
+                    key = arena.copyString(reader.text(), reader.textLength());
+                    keyLength = reader.textLength();
+                    break;
+                case Reader::VALUE:
+                    child = appendChild(*parent, key, keyLength);
+                    if (!child) {
+                        return false;
+                    }
+                    setValue(*child, reader.text(), reader.textLength());
+                    child->isRaw = !reader.isString();
+                    break;
+                case Reader::BEGIN_OBJECT:
+                case Reader::BEGIN_ARRAY:
+                    // The outer braces are the first level
+                    if (depth + 1 == MAX_DEPTH) {
+                        return false;
+                    }
+                    child = appendChild(*parent, key, keyLength);
+                    if (!child) {
+                        return false;
+                    }
+                    child->isArray = event == Reader::BEGIN_ARRAY;
+                    child->isObject = event == Reader::BEGIN_OBJECT;
+                    path[++depth] = child;
+                    break;
+                case Reader::END_OBJECT:
+                case Reader::END_ARRAY:
+                    if (depth == 0) {
+                        return reader.next() == Reader::END_DOCUMENT;
+                    }
+                    depth--;
+                    break;
+                default:
+                    return false;
+            }
         }
     }
 
 private:
-    // Recursively finds or creates a node based on a path.
-    Node& findOrCreateNode(const Custom_String::String& path) {
-        size_t pos = 0;
-        Node* node = &root;
-        while ((pos = path.indexOf('.', pos)) != Custom_String::String::NPOS) {
-            Custom_String::String key = path.Sub_String(0, pos);
-            node->children.push_back(Node(key));
-            node = &node->children.back();
-            pos++;
+    // Empties the path index after a structural change.
+    void invalidatePathIndex() const {
+        for (unsigned int i = 0; index && i <= indexMask; i++) {
+            index[i].node = nullptr;
         }
-        return *node;
+        indexCount = 0;
     }
 
-    // Recursively searches for a node by path.
-    const Node* findNode(const Custom_String::String& path, const Node* currentNode = nullptr) const {
-        if (!currentNode) {
-            currentNode = &root;
+    // Resolves a path through the index when it is enabled, recording misses that resolve.
+    const Node* lookup(const char* path) const {
+        if (!index) {
+            return findNode(path);
         }
-        size_t pos = path.indexOf('.');
-        if (pos == Custom_String::String::NPOS) {
-            for (const auto& child : currentNode->children) {
-                if (child.key == path) {
-                    return &child;
-                }
+        uint32_t hash = hashKey(path, strlen(path));
+        unsigned int slot = hash & indexMask;
+        for (unsigned int probes = 0; probes <= indexMask; probes++) {
+            const PathSlot& entry = index[slot];
+            if (!entry.node) {
+                break;
             }
-        } else {
-            Custom_String::String key = path.Sub_String(0, pos);
-            Custom_String::String rest = path.Sub_String(pos + 1, path.size() - pos - 1);
-            for (const auto& child : currentNode->children) {
-                if (child.key == key) {
-                    return findNode(rest, &child);
-                }
+            if (entry.hash == hash && matchesPath(path, *entry.node)) {
+                return entry.node;
+            }
+            slot = (slot + 1) & indexMask;
+        }
+        const Node* node = findNode(path);
+        // Keep the table at most 3/4 full so probe sequences stay short
+        if (node && !index[slot].node && (indexCount + 1) * 4 <= (indexMask + 1) * 3) {
+            index[slot].hash = hash;
+            index[slot].node = const_cast<Node*>(node);
+            indexCount++;
+        }
+        return node;
+    }
+
+    // Guards index hits against hash collisions: every segment of the path, last to first, must equal the key
+    // of the node or of one of its parents, and the path must end exactly at the root.
+    static bool matchesPath(const char* path, const Node& node) {
+        const char* end = path + strlen(path);
+        for (const Node* current = &node; current->parent; current = current->parent) {
+            unsigned int keyLength = current->keyLength;
+            if ((unsigned int)(end - path) < keyLength) {
+                return false;
+            }
+            const char* start = end - keyLength;
+            if (memcmp(start, current->key, keyLength) != 0) {
+                return false;
+            }
+            if (!current->parent->parent) {
+                return start == path;
+            }
+            if (start == path || start[-1] != '.') {
+                return false;
+            }
+            end = start - 1;
+        }
+        return false;
+    }
+
+    // Finds the direct child whose key equals the given segment; the hash is compared first.
+    static const Node* findChild(const Node& parent, const char* segment, unsigned int length) {
+        uint32_t hash = hashKey(segment, length);
+        for (const Node* child = parent.firstChild; child; child = child->nextSibling) {
+            if (child->keyHash == hash && child->keyLength == length && memcmp(child->key, segment, length) == 0) {
+                return child;
             }
         }
         return nullptr;
     }
 
-    void serializeNode(const Node& node, Custom_String::String& output, int depth) const {
-    for (const auto& child : node.children) {
-        // Create indentation String
-        Custom_String::String indentation(depth * 2, ' ');
-        
-        // Key with quotes
-        Custom_String::String keyWithQuotes = (Custom_String::String)"\"" + child.key + "\": ";
-        
-        // Concatenate indentation, key with quotes
-        output += indentation + keyWithQuotes;
-
-        if (!child.children.isEmpty()) {
-            output += "{\n";
-            serializeNode(child, output, depth + 1);
-            output += indentation + "},\n";
-        } else {
-            // Value with quotes
-            Custom_String::String valueWithQuotes = (Custom_String::String)"\"" + child.value + "\",\n";
-            output += valueWithQuotes;
+    // Walks the path one segment at a time without copying it.
+    const Node* findNode(const char* path) const {
+        const Node* node = &root;
+        while (node) {
+            const char* end = path;
+            while (*end != '\0' && *end != '.') {
+                end++;
+            }
+            node = findChild(*node, path, end - path);
+            if (*end == '\0') {
+                return node;
+            }
+            path = end + 1;
         }
+        return nullptr;
     }
-}
 
+    // Walks the path, creating missing nodes. Returns nullptr if the path is too deep or the arena is exhausted.
+    Node* findOrCreateNode(const char* path) {
+        unsigned int segments = 1;
+        for (const char* c = path; *c != '\0'; c++) {
+            if (*c == '.') {
+                segments++;
+            }
+        }
+        if (segments > MAX_DEPTH) {
+            return nullptr;
+        }
+        Node* node = &root;
+        while (true) {
+            const char* end = path;
+            while (*end != '\0' && *end != '.') {
+                end++;
+            }
+            Node* child = const_cast<Node*>(findChild(*node, path, end - path));
+            if (!child) {
+                if (node->isArray && !isNextIndex(*node, path, end - path)) {
+                    return nullptr;
+                }
+                child = appendChild(*node, arena.copyString(path, end - path), end - path);
+                if (!child) {
+                    return nullptr;
+                }
+            }
+            node = child;
+            if (*end == '\0') {
+                return node;
+            }
+            path = end + 1;
+        }
+    }
 
-    // Deserializes the JSON structure from a string.
-    void deserializeNode(const Custom_String::String& input, Node& node) {
-        size_t pos = 0;
-        while (pos < input.size()) {
-            size_t keyStart = input.indexOf('\"', pos);
-            if (keyStart == Custom_String::String::NPOS) {
-                break;
+    // True if segment is the index the next element of an array gets, so set() only ever appends to an array
+    // at the end and an element is always stored under the index the caller gave.
+    static bool isNextIndex(const Node& array, const char* segment, unsigned int length) {
+        char digits[12];
+        unsigned int digitCount = Custom_String::Formatter::into(digits, "%u", array.childCount);
+        return length == digitCount && memcmp(segment, digits, length) == 0;
+    }
+
+    void initNode(Node& node, const char* key, unsigned int keyLength) {
+        static char emptyValue[1] = "";
+        node.key = key;
+        node.keyLength = keyLength;
+        node.keyHash = hashKey(key, keyLength);
+        node.value = emptyValue;
+        node.valueCapacity = 0;
+        node.firstChild = nullptr;
+        node.lastChild = nullptr;
+        node.childCount = 0;
+        node.nextSibling = nullptr;
+        node.parent = nullptr;
+        node.isArray = false;
+        node.isObject = false;
+        node.isRaw = false;
+    }
+
+    // Allocates a node in the arena and links it after the parent's last child. Array elements are keyed by index.
+    Node* appendChild(Node& parent, const char* key, unsigned int keyLength) {
+        Node* node = (Node*)arena.allocate(sizeof(Node));
+        if (!node) {
+            return nullptr;
+        }
+        if (parent.isArray) {
+            char digits[12];
+            keyLength = Custom_String::Formatter::into(digits, "%u", parent.childCount);
+            key = arena.copyString(digits, keyLength);
+        }
+        initNode(*node, key ? key : "", key ? keyLength : 0);
+        node->parent = &parent;
+        if (parent.lastChild) {
+            parent.lastChild->nextSibling = node;
+        } else {
+            parent.firstChild = node;
+        }
+        parent.lastChild = node;
+        parent.childCount++;
+        return node;
+    }
+
+    bool setValue(Node& node, const char* value, unsigned int length) {
+        if (length + 1 > node.valueCapacity) {
+            char* copy = arena.copyString(value, length);
+            if (!copy) {
+                return false;
             }
-            size_t keyEnd = input.indexOf('\"', keyStart + 1);
-            if (keyEnd == Custom_String::String::NPOS) {
-                break;
+            node.value = copy;
+            node.valueCapacity = length + 1;
+        } else {
+            memcpy(node.value, value, length);
+            node.value[length] = '\0';
+        }
+        return true;
+    }
+
+    // Deep-copies the children of one node into another, allocating from this document's arena.
+    void copyChildren(const Node& from, Node& to) {
+        to.isArray = from.isArray;
+        to.isObject = from.isObject;
+        to.isRaw = from.isRaw;
+        for (const Node* child = from.firstChild; child; child = child->nextSibling) {
+            Node* copy = appendChild(to, arena.copyString(child->key, child->keyLength), child->keyLength);
+            if (!copy) {
+                return;
             }
-            size_t valueStart = input.indexOf('\"', keyEnd + 1);
-            if (valueStart == Custom_String::String::NPOS) {
-                break;
+            setValue(*copy, child->value, strlen(child->value));
+            copyChildren(*child, *copy);
+        }
+    }
+
+    // Recursively writes the children of a node. Strings are quoted, numbers and literals are written as read.
+    void serializeNode(const Node& node, Writer& writer) const {
+        for (const Node* child = node.firstChild; child; child = child->nextSibling) {
+            if (!node.isArray) {
+                writer.key(child->key);
             }
-            size_t valueEnd = input.indexOf('\"', valueStart + 1);
-            if (valueEnd == Custom_String::String::NPOS) {
-                break;
+            if (child->isArray) {
+                writer.beginArray();
+                serializeNode(*child, writer);
+                writer.endArray();
+            } else if (child->isObject || child->hasChildren()) {
+                writer.beginObject();
+                serializeNode(*child, writer);
+                writer.endObject();
+            } else if (child->isRaw) {
+                writer.rawValue(child->value);
+            } else {
+                writer.value(child->value);
             }
-            Custom_String::String key = input.Sub_String(keyStart + 1, keyEnd - keyStart - 1);
-            Custom_String::String value = input.Sub_String(valueStart + 1, valueEnd - valueStart - 1);
-            node.children.push_back(Node(key, value));
-            pos = valueEnd + 1;
         }
     }
 };
@@ -25,11 +25,98 @@ template <typename T>
 class LinkedList {
 private:
     ListNode<T>* head;
+    ListNode<T>* tail; // last node, so append() does not walk the list
     size_t Size;
+
+    // Cursor cache: the node at cursorIndex (or nullptr when unknown). Indexed access starts from the cursor when the
+    // wanted index is at or after it, so a loop over get(i) / set(i) / remove(i) walks each node once overall.
+    mutable ListNode<T>* cursorNode;
+    mutable size_t cursorIndex;
+
+    /**
+     * @brief Find the node at a position, starting from the cursor when possible
+     * @param position - the position of the node (must be less than Size)
+     * @return the node at the given position
+    */
+    ListNode<T>* nodeAt(size_t position) const {
+        if (position == Size - 1) {
+            return tail;
+        }
+        ListNode<T>* current = head;
+        size_t i = 0;
+        if (cursorNode && cursorIndex <= position) {
+            current = cursorNode;
+            i = cursorIndex;
+        }
+        for (; i < position; i++) {
+            current = current->next;
+        }
+        cursorNode = current;
+        cursorIndex = position;
+        return current;
+    }
+
+    // Keep the cursor valid after a node is inserted at position.
+    void insertedAt(size_t position) {
+        if (cursorNode && position <= cursorIndex) {
+            cursorIndex++;
+        }
+    }
+
+    // Keep the cursor valid after the node at position is removed.
+    void removedAt(size_t position) {
+        if (!cursorNode || position > cursorIndex) {
+            return;
+        }
+        if (position == cursorIndex) {
+            cursorNode = nullptr;
+        } else {
+            cursorIndex--;
+        }
+    }
+
+    // Unlink and delete the node after previous (or the head when previous is nullptr); position is its index, or
+    // Size when unknown, which drops the cursor.
+    void unlinkAfter(ListNode<T>* previous, size_t position) {
+        ListNode<T>* temp = previous ? previous->next : head;
+        if (previous) {
+            previous->next = temp->next;
+        } else {
+            head = temp->next;
+        }
+        if (temp == tail) {
+            tail = previous;
+        }
+        delete temp;
+        Size--;
+        if (position >= Size + 1) {
+            cursorNode = nullptr;
+        } else {
+            removedAt(position);
+        }
+    }
+
+    // Link newNode after previous (or in front of the head when previous is nullptr) as the element at position.
+    void linkAfter(ListNode<T>* previous, ListNode<T>* newNode, size_t position) {
+        if (previous) {
+            newNode->next = previous->next;
+            previous->next = newNode;
+        } else {
+            newNode->next = head;
+            head = newNode;
+        }
+        if (!newNode->next) {
+            tail = newNode;
+        }
+        Size++;
+        insertedAt(position);
+    }
+
 public:
 class ForwardIterator {
     private:
         ListNode<T>* current;
+        friend class LinkedList;
     public:
         /**
          * @brief Instantiate a new ForwardIterator object
@@ -62,12 +149,38 @@ class ForwardIterator {
             if (current) current = current->next;
             return *this;
         }
+
+        bool operator==(const ForwardIterator& other) const {
+            return current == other.current;
+        }
     };
+
+    /**
+     * @brief Get an iterator to the first element
+    */
+    ForwardIterator begin() const {
+        return ForwardIterator(head);
+    }
+
+    /**
+     * @brief Get the past-the-end iterator
+    */
+    ForwardIterator end() const {
+        return ForwardIterator(nullptr);
+    }
     /**
      * @brief Instantiate a new LinkedList object
      * 
     */
-    LinkedList() : head(nullptr), Size(0) {}
+    LinkedList() : head(nullptr), tail(nullptr), Size(0), cursorNode(nullptr), cursorIndex(0) {}
+
+    /**
+     * @brief Copy constructor
+     * @param other - the list to copy
+    */
+    LinkedList(const LinkedList& other) : head(nullptr), tail(nullptr), Size(0), cursorNode(nullptr), cursorIndex(0) {
+        *this = other;
+    }
 
     /**
      * @brief Destructor
@@ -92,20 +205,10 @@ class ForwardIterator {
      * @brief Append an element to the end of the list
      * @param value - the value to be appended
      * 
-     * @details Creates a new node with the given value and appends it to the end of the list.
+     * @details Creates a new node with the given value and links it after the tail node. O(1).
     */
     void append(const T& value) {
-        ListNode<T>* newNode = new ListNode<T>(value);
-        if (!head) {
-            head = newNode;
-        } else {
-            ListNode<T>* current = head;
-            while (current->next) {
-                current = current->next;
-            }
-            current->next = newNode;
-        }
-        Size++;
+        linkAfter(tail, new ListNode<T>(value), Size);
     }
 
     /**
@@ -115,10 +218,7 @@ class ForwardIterator {
      * @details Creates a new node with the given value and prepends it to the beginning of the list.
     */
     void prepend(const T& value) {
-        ListNode<T>* newNode = new ListNode<T>(value);
-        newNode->next = head;
-        head = newNode;
-        Size++;
+        linkAfter(nullptr, new ListNode<T>(value), 0);
     }
 
     /**
@@ -131,22 +231,7 @@ class ForwardIterator {
      * Otherwise, the value is inserted at the random position.
     */
     void insert(const T& value){
-        int randomNum = random(0, Size);
-        if (randomNum == 0) {
-            prepend(value);
-        } else if (randomNum >= Size) {
-            append(value);
-        } else {
-            ListNode<T>* newNode = new ListNode<T>(value);
-            ListNode<T>* current = head;
-            for (size_t i = 1; i < randomNum; i++) {
-                current = current->next;
-            }
-            newNode->next = current->next;
-            current->next = newNode;
-            
-            Size++;
-        }
+        insert(value, (size_t)random(0, Size));
     }
     // Insert an element at a specific position
     /**
@@ -157,23 +242,53 @@ class ForwardIterator {
      * @details Creates a new node with the given value and inserts it at the given position in the list.
      * If the position is 0, the value is prepended to the list.
      * If the position is greater than or equal to the size of the list, the value is appended to the list.
-     * Otherwise, the value is inserted at the given position.
+     * Otherwise, the value is inserted at the given position (walking from the cursor when possible).
     */
     void insert(const T& value, size_t position) {
         if (position == 0) {
             prepend(value);
-        } else if (position >= size) {
+        } else if (position >= Size) {
             append(value);
         } else {
-            ListNode<T>* newNode = new ListNode<T>(value);
-            ListNode<T>* current = head;
-            for (size_t i = 1; i < position; i++) {
-                current = current->next;
-            }
-            newNode->next = current->next;
-            current->next = newNode;
-            Size++;
+            linkAfter(nodeAt(position - 1), new ListNode<T>(value), position);
+        }
+    }
+
+    /**
+     * @brief Insert an element after the one an iterator points at
+     * @param position - an iterator to an element of this list (end() inserts at the front)
+     * @param value - the value to be inserted
+     * @return an iterator to the new element
+     *
+     * @details O(1); no walk from the head.
+    */
+    ForwardIterator insertAfter(ForwardIterator position, const T& value) {
+        ListNode<T>* newNode = new ListNode<T>(value);
+        linkAfter(position.current, newNode, Size + 1);
+        cursorNode = nullptr; // the index of the new node is unknown
+        return ForwardIterator(newNode);
+    }
+
+    /**
+     * @brief Remove the element after the one an iterator points at
+     * @param position - an iterator to an element of this list
+     * @return an iterator to the element that followed the removed one (end() if there is none)
+     *
+     * @details O(1); no walk from the head. Nothing happens if position is the last element.
+     * To erase while iterating, keep an iterator to the previous element:
+     * @code
+     * auto previous = list.begin();
+     * for (auto it = ++list.begin(); it != list.end();) {
+     *     if (*it == 0) { it = list.eraseAfter(previous); } else { previous = it; ++it; }
+     * }
+     * @endcode
+    */
+    ForwardIterator eraseAfter(ForwardIterator position) {
+        if (!position.current || !position.current->next) {
+            return end();
         }
+        unlinkAfter(position.current, Size);
+        return ForwardIterator(position.current->next);
     }
 
     /**
@@ -184,23 +299,13 @@ class ForwardIterator {
      * If the position is 0, the first element is removed.
      * If the position is greater than or equal to the size of the list, nothing happens.
      * Otherwise, the element at the given position is removed.
+     * Removing the same index repeatedly, or indices in increasing order, walks each node once overall.
     */
     void remove(const int index){
-        if(index == 0){
-            ListNode<T>* temp = head;
-            head = head->next;
-            delete temp;
-            Size--;
+        if (index < 0 || (size_t)index >= Size) {
             return;
         }
-        ListNode<T>* current = head;
-        for(int i = 0; i < index - 1; i++){
-            current = current->next;
-        }
-        ListNode<T>* temp = current->next;
-        current->next = temp->next;
-        delete temp;
-        Size--;
+        unlinkAfter(index == 0 ? nullptr : nodeAt(index - 1), index);
     }
     
     /**
@@ -209,26 +314,13 @@ class ForwardIterator {
      * 
     */
     void removeElement(const T& value) {
-        if (!head) {
-            return; // List is empty
-        }
-        if (head->data == value) {
-            ListNode<T>* temp = head;
-            head = head->next;
-            delete temp;
-            Size--;
-            return;
-        }
-        ListNode<T>* current = head;
-        while (current->next) {
-            if (current->next->data == value) {
-                ListNode<T>* temp = current->next;
-                current->next = current->next->next;
-                delete temp;
-                Size--;
+        ListNode<T>* previous = nullptr;
+        size_t index = 0;
+        for (ListNode<T>* current = head; current; previous = current, current = current->next, index++) {
+            if (current->data == value) {
+                unlinkAfter(previous, index);
                 return;
             }
-            current = current->next;
         }
     }
     // Get the element at a specific position
@@ -244,33 +336,31 @@ class ForwardIterator {
      * @warning This Function Returns a Pointer
     */
     T* get(size_t position) const {
-        ListNode<T>* current = head;
-        for (size_t i = 0; i < position; i++) {
-            if (!current) {
-                return nullptr; // Out of bounds
-            }
-            current = current->next;
-        }
-        if (current) {
-            return &(current->data);
-        } else {
-            return nullptr;
+        if (position >= Size) {
+            return nullptr; // Out of bounds
         }
+        return &(nodeAt(position)->data);
     }
 
     T getElement(size_t position) const {
-        ListNode<T>* current = head;
-        for (size_t i = 0; i < position; i++) {
-            if (!current) {
-                return T(); // Out of bounds
-            }
-            current = current->next;
+        if (position >= Size) {
+            return T(); // Out of bounds
         }
-        if (current) {
-            return current->data;
-        } else {
-            return T();
+        return nodeAt(position)->data;
+    }
+
+    /**
+     * @brief Replace the element at a specific position
+     * @param position - the position of the element to replace
+     * @param value - the new value
+     * @return true if the position was in bounds, false otherwise
+    */
+    bool set(size_t position, const T& value) {
+        if (position >= Size) {
+            return false;
         }
+        nodeAt(position)->data = value;
+        return true;
     }
 
     /**
@@ -283,18 +373,10 @@ class ForwardIterator {
      * Otherwise, the element at the given position is returned as a String
     */
     String getAsString(size_t position) const {
-        ListNode<T>* current = head;
-        for (size_t i = 0; i < position; i++) {
-            if (!current) {
-                return nullptr; // Out of bounds
-            }
-            current = current->next;
-        }
-        if (current) {
-            return String(current->data);
-        } else {
-            return nullptr;
+        if (position >= Size) {
+            return String(); // Out of bounds
         }
+        return String(nodeAt(position)->data);
     }
     // Check if the list contains a specific element
     /**
@@ -345,6 +427,8 @@ class ForwardIterator {
             head = head->next;
             delete temp;
         }
+        tail = nullptr;
+        cursorNode = nullptr;
         Size = 0;
     }
 
@@ -355,22 +439,15 @@ class ForwardIterator {
      * @return the element at the given index
      * 
      * @details Returns the element at the given index in the list.
-     * If the index is out of bounds, the first element is returned.
+     * If the index is out of bounds, a static default constructed element is returned.
      * Otherwise, the element at the given index is returned.
     */
     T& operator[](size_t index) {
-        ListNode<T>* current = head;
-        for (size_t i = 0; i < index; i++) {
-            if (!current) {
-                return current->data; // Out of bounds
-            }
-            current = current->next;
-        }
-        if (current) {
-            return current->data;
-        } else {
-            return current->data;
+        static T dummy;
+        if (index >= Size) {
+            return dummy; // Out of bounds
         }
+        return nodeAt(index)->data;
     }
 
     /**
@@ -379,22 +456,15 @@ class ForwardIterator {
      * @return the element at the given index
      * 
      * @details Returns the element at the given index in the list.
-     * If the index is out of bounds, the first element is returned.
+     * If the index is out of bounds, a static default constructed element is returned.
      * Otherwise, the element at the given index is returned.
     */
     const T& operator[](size_t index) const {
-        ListNode<T>* current = head;
-        for (size_t i = 0; i < index; i++) {
-            if (!current) {
-                return current->data; // Out of bounds
-            }
-            current = current->next;
-        }
-        if (current) {
-            return current->data;
-        } else {
-            return current->data;
+        static T dummy;
+        if (index >= Size) {
+            return dummy; // Out of bounds
         }
+        return nodeAt(index)->data;
     }
 
     //= operator
@@ -72,7 +72,7 @@ size_t LittleFSProperties::getChipSelect() {
  * @return bool
 */
 bool LittleFSProperties::exists(const String& key) {
-    return table.get(key) != nullptr;
+    return table.get(keyId(key)) != nullptr;
 }
 
 /**
@@ -87,7 +87,7 @@ bool LittleFSProperties::exists(const String& key) {
  * @return bool
 */
 bool LittleFSProperties::exists(const String& key, const String& value) {
-    String* valuePtr = table.get(key);
+    String* valuePtr = table.get(keyId(key));
     if (!valuePtr) {
         return false;
     }
@@ -159,7 +159,7 @@ void LittleFSProperties::identify(const IDENTIFIERTYPE identifierType = EQUALS)
  * @return void
 */
 void LittleFSProperties::setProperty(const String& key, const String& value) {
-    table.put(key, value);
+    putProperty(key, value);
 }
 
 /**
@@ -176,7 +176,7 @@ void LittleFSProperties::setProperty(const String& key, const String& value) {
 */
 void LittleFSProperties::setProperty(const String& key, const String& value, const String& filePath) {
     loadFromSD(filePath);
-    table.put(key, value);
+    putProperty(key, value);
     saveToSD(filePath);
 }
 
@@ -189,7 +189,7 @@ void LittleFSProperties::setProperty(const String& key, const String& value, con
  * @return String
 */
 String LittleFSProperties::getProperty(const String& key) {
-    String* valuePtr = table.get(key);
+    String* valuePtr = table.get(keyId(key));
     if (!valuePtr) {
         return "[SIMPLE LittleFSProperties]: Property with key '" + key + "' not found.";
     }
@@ -210,7 +210,7 @@ String LittleFSProperties::getProperty(const String& key) {
 */
 String LittleFSProperties::getProperty(const String& key, const String& defaultValue, const String& filePath) {
     loadFromSD(filePath);
-    String* valuePtr = table.get(key);
+    String* valuePtr = table.get(keyId(key));
     if (!valuePtr) {
         return defaultValue;
     }
@@ -226,7 +226,7 @@ String LittleFSProperties::getProperty(const String& key, const String& defaultV
  * @return void
 */
 void LittleFSProperties::removeProperty(const String& key) {
-    table.remove(key);
+    table.remove(keyId(key));
 }
 
 /**
@@ -237,6 +237,34 @@ void LittleFSProperties::removeProperty(const String& key) {
 */
 void LittleFSProperties::clear() {
     table.clear();
+    keys.clear();
+}
+
+/**
+ * @brief Store a property under the Id of its key
+ * 
+ * @param key (Variable Name)
+ * @param value (Variable Value)
+ * 
+ * @details The key is interned in this object's own pool, which clear() empties. If the pool is out of memory the property is not stored.
+ * @return void
+*/
+void LittleFSProperties::putProperty(const String& key, const String& value) {
+    StringPool::Id id = keys.intern(key);
+    if (id != StringPool::NONE) {
+        table.put(id, value);
+    }
+}
+
+/**
+ * @brief Look up the Id of a key without adding it
+ * 
+ * @param key (Variable Name)
+ * 
+ * @return StringPool::Id (StringPool::NONE if no property has ever used the key)
+*/
+StringPool::Id LittleFSProperties::keyId(const String& key) const {
+    return keys.find(key.c_str(), key.length());
 }
 
 /**
@@ -454,7 +482,7 @@ bool LittleFSProperties::loadFromSD(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -487,7 +515,7 @@ bool LittleFSProperties::loadFromSD(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -520,7 +548,7 @@ bool LittleFSProperties::loadFromSD(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -691,7 +719,7 @@ bool LittleFSProperties::store(const String& filename, const String& comments) {
  * @return bool
 */
 bool LittleFSProperties::containsKey(const String& key) {
-    return table.get(key) != nullptr;
+    return table.get(keyId(key)) != nullptr;
 }
 
 /**
@@ -826,7 +854,7 @@ bool LittleFSProperties::loadFromXML(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 5, keyEndIndex);
                 String value = line.substring(valueStartIndex + 7, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -846,7 +874,7 @@ bool LittleFSProperties::loadFromXML(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 5, keyEndIndex);
                 String value = line.substring(valueStartIndex + 7, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -867,7 +895,7 @@ bool LittleFSProperties::loadFromXML(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 5, keyEndIndex);
                 String value = line.substring(valueStartIndex + 7, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -958,7 +986,7 @@ bool LittleFSProperties::loadFromMsgPack(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -975,7 +1003,7 @@ bool LittleFSProperties::loadFromMsgPack(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -993,7 +1021,7 @@ bool LittleFSProperties::loadFromMsgPack(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1084,7 +1112,7 @@ bool LittleFSProperties::loadFromTOML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 3, line.length() - 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1101,7 +1129,7 @@ bool LittleFSProperties::loadFromTOML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 3, line.length() - 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1119,7 +1147,7 @@ bool LittleFSProperties::loadFromTOML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 3, line.length() - 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1210,7 +1238,7 @@ bool LittleFSProperties::loadFromCSV(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1227,7 +1255,7 @@ bool LittleFSProperties::loadFromCSV(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1245,7 +1273,7 @@ bool LittleFSProperties::loadFromCSV(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1372,7 +1400,7 @@ bool LittleFSProperties::loadFromJSON(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 8, keyEndIndex);
                 String value = line.substring(valueStartIndex + 9, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1392,7 +1420,7 @@ bool LittleFSProperties::loadFromJSON(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 8, keyEndIndex);
                 String value = line.substring(valueStartIndex + 9, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1413,7 +1441,7 @@ bool LittleFSProperties::loadFromJSON(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 8, keyEndIndex);
                 String value = line.substring(valueStartIndex + 9, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1504,7 +1532,7 @@ bool LittleFSProperties::loadFromYAML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1521,7 +1549,7 @@ bool LittleFSProperties::loadFromYAML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1539,7 +1567,7 @@ bool LittleFSProperties::loadFromYAML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1630,7 +1658,7 @@ bool LittleFSProperties::loadFromINI(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1647,7 +1675,7 @@ bool LittleFSProperties::loadFromINI(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -1665,7 +1693,7 @@ bool LittleFSProperties::loadFromINI(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -6,7 +6,8 @@
 
 class LittleFSProperties {
 private:
-        Hashtable<String, String> table; // Declaration of the Hashtable (Uses the Hashtable class from the Hashtable.h file in the background)
+        StringPool keys; // Key text of this object only; clear() empties it, so loading files never grows StringPool::shared()
+        Hashtable<StringPool::Id, String> table; // Declaration of the Hashtable (Each entry stores the 2 byte Id of its key in keys instead of a String)
         enum IDENTIFIERTYPE{ // Enumeration of the identifier types (=, :, ;, -, , , /, \)
             EQUALS,
             COLEN,
@@ -18,6 +19,9 @@ private:
         };
         IDENTIFIERTYPE identifierType = EQUALS;
         size_t chipSelect = 4; // Declaration of the chip select pin
+
+        void putProperty(const String& key, const String& value); // Interns the key in keys and stores the value under its Id
+        StringPool::Id keyId(const String& key) const; // Id of a key in keys without adding it (StringPool::NONE if absent)
     public:
         LittleFSProperties(); // Declaration of the constructor
         ~LittleFSProperties();
@@ -74,11 +78,12 @@ private:
     */
     class LittleFSPropertiesIterator {
 private:
-    Hashtable<String, String>::Iterator it; // Declaration of the Hashtable iterator
+    Hashtable<StringPool::Id, String>::Iterator it; // Declaration of the Hashtable iterator
+    const StringPool* keys; // Pool the Ids of the keys belong to
 public:
     // Constructor
-    LittleFSPropertiesIterator(Hashtable<String, String>::Iterator begin)
-        : it(begin) {}
+    LittleFSPropertiesIterator(Hashtable<StringPool::Id, String>::Iterator begin, const StringPool& keys)
+        : it(begin), keys(&keys) {}
 
     // Prefix increment
     LittleFSPropertiesIterator& operator++() {
@@ -99,29 +104,29 @@ public:
     }
 
     // Dereference operator
-    Hashtable<String, String>::KeyValuePair operator*() const {
+    Hashtable<StringPool::Id, String>::KeyValuePair operator*() const {
         return *it; // Delegate to the Hashtable iterator
     }
 
     // Key accessor
     String key() const { 
-        return it.operator*().key; // Access the key of the current KeyValuePair
+        return String(keys->c_str(it.key())); // Read the key straight out of the pool
     }
 
     // Value accessor
-    String value() const { 
-        return it.operator*().value; // Access the value of the current KeyValuePair
+    const String& value() const { 
+        return it.value(); // Reference to the stored value, no copy of the pair
     }
 };
 
 // Iterator begin
     LittleFSPropertiesIterator begin() {
-        return LittleFSPropertiesIterator(table.begin());
+        return LittleFSPropertiesIterator(table.begin(), keys);
     }
 
 // Iterator end
     LittleFSPropertiesIterator end() {
-        return LittleFSPropertiesIterator(table.end());
+        return LittleFSPropertiesIterator(table.end(), keys);
     }
 };
 
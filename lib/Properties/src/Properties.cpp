@@ -46,7 +46,7 @@ size_t Properties::getChipSelect() {
  * @return bool
 */
 bool Properties::exists(const String& key) {
-    return table.get(key) != nullptr;
+    return table.get(keyId(key)) != nullptr;
 }
 
 /**
@@ -61,7 +61,7 @@ bool Properties::exists(const String& key) {
  * @return bool
 */
 bool Properties::exists(const String& key, const String& value) {
-    String* valuePtr = table.get(key);
+    String* valuePtr = table.get(keyId(key));
     if (!valuePtr) {
         return false;
     }
@@ -90,7 +90,7 @@ void Properties::identify(const IDENTIFIERTYPE identifierType = EQUALS) {
  * @return void
 */
 void Properties::setProperty(const String& key, const String& value) {
-    table.put(key, value);
+    putProperty(key, value);
 }
 
 /**
@@ -107,7 +107,7 @@ void Properties::setProperty(const String& key, const String& value) {
 */
 void Properties::setProperty(const String& key, const String& value, const String& filePath) {
     loadFromSD(filePath);
-    table.put(key, value);
+    putProperty(key, value);
     saveToSD(filePath);
 }
 
@@ -120,7 +120,7 @@ void Properties::setProperty(const String& key, const String& value, const Strin
  * @return String
 */
 String Properties::getProperty(const String& key) {
-    String* valuePtr = table.get(key);
+    String* valuePtr = table.get(keyId(key));
     if (!valuePtr) {
         return "[SIMPLE PROPERTIES]: Property with key '" + key + "' not found.";
     }
@@ -141,7 +141,7 @@ String Properties::getProperty(const String& key) {
 */
 String Properties::getProperty(const String& key, const String& defaultValue, const String& filePath) {
     loadFromSD(filePath);
-    String* valuePtr = table.get(key);
+    String* valuePtr = table.get(keyId(key));
     if (!valuePtr) {
         return defaultValue;
     }
@@ -157,7 +157,7 @@ String Properties::getProperty(const String& key, const String& defaultValue, co
  * @return void
 */
 void Properties::removeProperty(const String& key) {
-    table.remove(key);
+    table.remove(keyId(key));
 }
 
 /**
@@ -168,6 +168,34 @@ void Properties::removeProperty(const String& key) {
 */
 void Properties::clear() {
     table.clear();
+    keys.clear();
+}
+
+/**
+ * @brief Store a property under the Id of its key
+ * 
+ * @param key (Variable Name)
+ * @param value (Variable Value)
+ * 
+ * @details The key is interned in this object's own pool, which clear() empties. If the pool is out of memory the property is not stored.
+ * @return void
+*/
+void Properties::putProperty(const String& key, const String& value) {
+    StringPool::Id id = keys.intern(key);
+    if (id != StringPool::NONE) {
+        table.put(id, value);
+    }
+}
+
+/**
+ * @brief Look up the Id of a key without adding it
+ * 
+ * @param key (Variable Name)
+ * 
+ * @return StringPool::Id (StringPool::NONE if no property has ever used the key)
+*/
+StringPool::Id Properties::keyId(const String& key) const {
+    return keys.find(key.c_str(), key.length());
 }
 
 /**
@@ -292,7 +320,7 @@ bool Properties::loadFromSD(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -385,7 +413,7 @@ bool Properties::store(const String& filename, const String& comments) {
  * @return bool
 */
 bool Properties::containsKey(const String& key) {
-    return table.get(key) != nullptr;
+    return table.get(keyId(key)) != nullptr;
 }
 
 /**
@@ -466,7 +494,7 @@ bool Properties::loadFromXML(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 5, keyEndIndex);
                 String value = line.substring(valueStartIndex + 7, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -524,7 +552,7 @@ bool Properties::loadFromMsgPack(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -582,7 +610,7 @@ bool Properties::loadFromTOML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 3, line.length() - 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -640,7 +668,7 @@ bool Properties::loadFromCSV(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 1);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -712,7 +740,7 @@ bool Properties::loadFromJSON(const String& filename) {
             if (keyStartIndex != -1 && keyEndIndex != -1 && valueStartIndex != -1 && valueEndIndex != -1) {
                 String key = line.substring(keyStartIndex + 8, keyEndIndex);
                 String value = line.substring(valueStartIndex + 9, valueEndIndex);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -770,7 +798,7 @@ bool Properties::loadFromYAML(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -828,7 +856,7 @@ bool Properties::loadFromINI(const String& filename) {
             if (separatorIndex != -1) {
                 String key = line.substring(0, separatorIndex);
                 String value = line.substring(separatorIndex + 2);
-                table.put(key, value);
+                putProperty(key, value);
             }
         }
         file.close();
@@ -6,7 +6,8 @@
 
 class Properties {
 private:
-        Hashtable<String, String> table; // Declaration of the Hashtable (Uses the Hashtable class from the Hashtable.h file in the background)
+        StringPool keys; // Key text of this object only; clear() empties it, so loading files never grows StringPool::shared()
+        Hashtable<StringPool::Id, String> table; // Declaration of the Hashtable (Each entry stores the 2 byte Id of its key in keys instead of a String)
         enum IDENTIFIERTYPE{ // Enumeration of the identifier types (=, :, ;, -, , , /, \)
             EQUALS,
             COLEN,
@@ -19,6 +20,9 @@ private:
         IDENTIFIERTYPE identifierType = EQUALS;
 
         size_t chipSelect = 4; // Declaration of the chip select pin
+
+        void putProperty(const String& key, const String& value); // Interns the key in keys and stores the value under its Id
+        StringPool::Id keyId(const String& key) const; // Id of a key in keys without adding it (StringPool::NONE if absent)
     public:
         Properties(); // Declaration of the constructor
         ~Properties();
@@ -72,11 +76,12 @@ private:
     */
     class PropertiesIterator {
 private:
-    Hashtable<String, String>::Iterator it; // Declaration of the Hashtable iterator
+    Hashtable<StringPool::Id, String>::Iterator it; // Declaration of the Hashtable iterator
+    const StringPool* keys; // Pool the Ids of the keys belong to
 public:
     // Constructor
-    PropertiesIterator(Hashtable<String, String>::Iterator begin)
-        : it(begin) {}
+    PropertiesIterator(Hashtable<StringPool::Id, String>::Iterator begin, const StringPool& keys)
+        : it(begin), keys(&keys) {}
 
     // Prefix increment
     PropertiesIterator& operator++() {
@@ -97,29 +102,29 @@ public:
     }
 
     // Dereference operator
-    Hashtable<String, String>::KeyValuePair operator*() const {
+    Hashtable<StringPool::Id, String>::KeyValuePair operator*() const {
         return *it; // Delegate to the Hashtable iterator
     }
 
     // Key accessor
     String key() const { 
-        return it.operator*().key; // Access the key of the current KeyValuePair
+        return String(keys->c_str(it.key())); // Read the key straight out of the pool
     }
 
     // Value accessor
-    String value() const { 
-        return it.operator*().value; // Access the value of the current KeyValuePair
+    const String& value() const { 
+        return it.value(); // Reference to the stored value, no copy of the pair
     }
 };
 
 // Iterator begin
     PropertiesIterator begin() {
-        return PropertiesIterator(table.begin());
+        return PropertiesIterator(table.begin(), keys);
     }
 
 // Iterator end
     PropertiesIterator end() {
-        return PropertiesIterator(table.end());
+        return PropertiesIterator(table.end(), keys);
     }
 };
 
@@ -4,6 +4,12 @@
 #include <Arduino.h>
 #include <TypeTraits.h>
 #include <SimpleVector.h>
+#include <SmallVector.h>
+
+// Points a QuadNode stores without a heap allocation; nodes holding more spill to the heap.
+#ifndef QUADTREE_INLINE_POINTS
+#define QUADTREE_INLINE_POINTS 4
+#endif
 
 template <typename T>
 struct Point {
@@ -69,7 +75,7 @@ class QuadNode {
     static_assert(is_arithmetic<T>::value, "QuadNode only supports number types");
     public:
     Rectangle<T> boundary; // The boundary of the node
-    SimpleVector<Point<T>> points; // The points contained in the node
+    SmallVector<Point<T>, QUADTREE_INLINE_POINTS> points; // The points contained in the node
     int capacity; // The maximum number of points a node can hold
     bool divided = false; // Whether the node has been divided
     QuadNode* children[4] = {nullptr}; // NW, NE, SW, SE
@@ -102,7 +108,7 @@ class QuadNode {
     bool insert(const Point<T>& point) {
         if (!boundary.contains(point)) return false;
 
-        if (points.size() < capacity) {
+        if ((int)points.elements() < capacity) {
             points.push_back(point);
             return true;
         }
@@ -137,8 +143,8 @@ class QuadNode {
             return false;
         }
 
-        if (points.size() > 0) {
-            for (int i = 0; i < points.size(); i++) {
+        if (points.elements() > 0) {
+            for (unsigned int i = 0; i < points.elements(); i++) {
                 if (points[i].x == point.x && points[i].y == point.y) {
                     points.erase(i);
                     return true;
@@ -162,8 +168,8 @@ class QuadNode {
             return false;
         }
 
-        if (points.size() > 0) {
-            for (int i = 0; i < points.size(); i++) {
+        if (points.elements() > 0) {
+            for (unsigned int i = 0; i < points.elements(); i++) {
                 if (points[i].x == point.x && points[i].y == point.y) {
                     return true;
                 }
@@ -219,7 +225,7 @@ class QuadTree {
     void print(const QuadNode<T>* node) {
         if (node->isLeaf()) {
             Serial.println("Leaf");
-            for (int i = 0; i < node->points.size(); i++) {
+            for (unsigned int i = 0; i < node->points.elements(); i++) {
                 Serial.print("Point: ");
                 Serial.print(node->points[i].x);
                 Serial.print(", ");
@@ -270,7 +276,7 @@ class QuadTree {
     }
 
     uint16_t size() {
-        return root->points.size();
+        return root->points.elements();
     }
 
     uint16_t depth() {
@@ -0,0 +1,52 @@
+/*
+    Example Name: ISR Handoff Example For Queue Library
+
+    Hands pulse timestamps from an interrupt handler to loop() through an SPSCQueue. The handler only calls push()
+    and loop() only calls popN(), so interrupts are never disabled and the handler never waits. Pulses that arrive
+    while the queue is full are counted as dropped instead of blocking.
+
+    The circuit:
+    A push button (or any pulse source) between pin 2 and GND.
+
+    Created  month day year   // 10/18/2026
+    By author's name braydenanderson2014 (Brayden Anderson)
+    Modified day month year  // 10/18/2026
+    By author's name  braydenanderson2014 (Brayden Anderson)
+
+    https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
+
+*/
+#include <Arduino.h>
+#include <SPSCQueue.h>
+
+const int PULSE_PIN = 2;
+
+SPSCQueue<unsigned long, 32> pulses; // written by onPulse(), read by loop()
+volatile unsigned int dropped = 0;   // written by onPulse() only
+
+void onPulse() {
+    if (!pulses.push(micros())) {
+        dropped++;
+    }
+}
+
+void setup() {
+    Serial.begin(9600);
+    pinMode(PULSE_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(PULSE_PIN), onPulse, FALLING);
+}
+
+void loop() {
+    unsigned long batch[8];
+    size_t count = pulses.popN(batch, 8); // drain in batches: one head update per batch
+    for (size_t i = 0; i < count; i++) {
+        Serial.print("Pulse at ");
+        Serial.print(batch[i]);
+        Serial.println(" us");
+    }
+    if (dropped) {
+        Serial.print("Dropped pulses: ");
+        Serial.println(dropped);
+    }
+    delay(100);
+}
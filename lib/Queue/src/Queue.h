@@ -1,144 +1,320 @@
 #ifndef QUEUE_h
 #define QUEUE_h
 
+#include <Arduino.h>
+
+/**
+ * @brief Storage for a Queue: a fixed inline array of N elements, or (N == 0) a growable heap array
+ * @private
+*/
+template <class T, size_t N>
+class QueueStorage {
+    static_assert((N & (N - 1)) == 0, "Queue<T, N> needs a power of two capacity");
+protected:
+    T buffer[N]; // ring storage, no heap use
+
+    QueueStorage(size_t) {}
+
+    size_t storageCapacity() const {
+        return N;
+    }
+
+    static bool canGrow() {
+        return false;
+    }
+
+    void adopt(T*, size_t) {}
+};
+
 template <class T>
-class Queue {
+class QueueStorage<T, 0> {
+protected:
+    T* buffer; // ring storage, doubled when full
+    size_t slots;
+
+    QueueStorage(size_t initialCapacity) : slots(1) {
+        while (slots < initialCapacity) {
+            slots <<= 1;
+        }
+        buffer = new T[slots];
+    }
+
+    QueueStorage(const QueueStorage& other) : buffer(new T[other.slots]), slots(other.slots) {
+        for (size_t i = 0; i < slots; i++) {
+            buffer[i] = other.buffer[i];
+        }
+    }
+
+    QueueStorage& operator=(const QueueStorage& other) {
+        if (this != &other) {
+            T* newBuffer = new T[other.slots];
+            for (size_t i = 0; i < other.slots; i++) {
+                newBuffer[i] = other.buffer[i];
+            }
+            adopt(newBuffer, other.slots);
+        }
+        return *this;
+    }
+
+    ~QueueStorage() {
+        delete[] buffer;
+    }
+
+    size_t storageCapacity() const {
+        return slots;
+    }
+
+    static bool canGrow() {
+        return true;
+    }
+
+    // Replace the storage with a new array (the caller has copied the elements over)
+    void adopt(T* newBuffer, size_t newCapacity) {
+        delete[] buffer;
+        buffer = newBuffer;
+        slots = newCapacity;
+    }
+};
+
+/**
+ * @brief A FIFO queue on a circular buffer
+ *
+ * head and tail count every element ever removed and added; the slot of an index is index & (capacity - 1), so the
+ * capacity is always a power of two and no element is ever shifted. count() is tail - head, which stays correct when
+ * the counters wrap around.
+ *
+ * Queue<T> starts with 16 slots (or the next power of two above the size passed to the constructor) and doubles when
+ * full. Queue<T, N> keeps its N slots inside the object and never allocates; enqueue() fails when it is full.
+ *
+ * @tparam T The type of the elements
+ * @tparam N The fixed capacity (a power of two), or 0 for a growable queue
+*/
+template <class T, size_t N = 0>
+class Queue : private QueueStorage<T, N> {
 private:
-    T *queue; // array
-    int front; // front of the queue
-    int rear; // rear of the queue
-    int size; // size of the queue
-    int elements; // number of elements in the queue
+    typedef QueueStorage<T, N> Storage;
+
+    size_t head; // index of the front element
+    size_t tail; // index one past the last element
+
+    // Element types copied with memcpy in the bulk operations (int, byte, pointers, plain structs)
+    struct Trivial {
+        static const bool value = __has_trivial_copy(T) && __has_trivial_assign(T);
+    };
+
+    template <bool B> struct Tag {};
+
+    static void copySpan(T* dest, const T* src, size_t n, Tag<true>) {
+        memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(T));
+    }
+
+    static void copySpan(T* dest, const T* src, size_t n, Tag<false>) {
+        for (size_t i = 0; i < n; i++) {
+            dest[i] = src[i];
+        }
+    }
+
+    static void copySpan(T* dest, const T* src, size_t n) {
+        if (n) {
+            copySpan(dest, src, n, Tag<Trivial::value>());
+        }
+    }
+
+    size_t mask() const {
+        return Storage::storageCapacity() - 1;
+    }
 
     /**
-     * @brief Resize the queue
+     * @brief Copy n elements starting at the front into out, in at most two contiguous spans
      * @private
-     * 
-     * @return void
     */
-    void resize(){
-        T *newQueue = new int[size * 2]; // create a new array with double the size
-        copy(newQueue);
-        delete[] queue;
-        queue = newQueue;
-        size *= 2;
+    void copyOut(T* out, size_t n) const {
+        size_t start = head & mask();
+        size_t first = Storage::storageCapacity() - start; // elements before the end of the buffer
+        if (first > n) {
+            first = n;
+        }
+        copySpan(out, Storage::buffer + start, first);
+        copySpan(out + first, Storage::buffer, n - first);
     }
 
     /**
-     * @brief Copy the elements from the old queue to the new queue
+     * @brief Double the capacity of a growable queue
      * @private
-     * 
-     * @param newQueue - the new queue
-     * @return void
+     *
+     * @return bool - false for a fixed capacity queue
     */
-    void copy(T *newQueue){
-        for(int i = front; i <= rear; i++){
-            newQueue[i] = queue[i];
+    bool grow() {
+        if (!Storage::canGrow()) {
+            return false;
+        }
+        size_t size = count();
+        size_t newCapacity = Storage::storageCapacity() * 2;
+        T* newBuffer = new T[newCapacity];
+        if (!newBuffer) {
+            return false;
         }
+        copyOut(newBuffer, size); // unwrap: the front moves to slot 0
+        Storage::adopt(newBuffer, newCapacity);
+        head = 0;
+        tail = size;
+        return true;
     }
+
 public:
     /**
      * @brief Construct a new Queue object
-     * 
+     *
+     * @param initialCapacity - the starting capacity of a growable queue, rounded up to a power of two (ignored for Queue<T, N>)
+    */
+    Queue(size_t initialCapacity = 16) : Storage(initialCapacity), head(0), tail(0) {}
+
+    /**
+     * @brief Add an element to the back of the queue
+     *
+     * @param value - the value to add
+     * @return bool - false if a fixed capacity queue is full (or a growable one is out of memory)
+    */
+    bool enqueue(const T& value) {
+        if (isFull() && !grow()) {
+            return false;
+        }
+        Storage::buffer[tail++ & mask()] = value;
+        return true;
+    }
+
+    /**
+     * @brief Remove the element at the front of the queue
+     *
+     * @param value - receives the removed value
+     * @return bool - false if the queue is empty
     */
-    Queue(){
-        queue = new T[10]; // create a new array with size 10
-        front = 0; // set the front to 0
-        rear = -1; // set the rear to -1
-        size = 10; // set the size to 10
-        elements = 0; // set the number of elements to 0
+    bool dequeue(T& value) {
+        if (isEmpty()) {
+            return false;
+        }
+        value = Storage::buffer[head++ & mask()];
+        return true;
     }
 
     /**
-     * @brief Destroy the Queue object
-     * 
+     * @brief Remove the element at the front of the queue
+     *
+     * @return T - the value removed, or a default constructed T if the queue is empty
     */
-    ~Queue(){
-        delete[] queue;
+    T dequeue() {
+        T value = T();
+        dequeue(value);
+        return value;
     }
 
     /**
-     * @brief Add an element to the queue
-     * 
-     * @param value - the value to add
-     * @return void
+     * @brief Get the value at the front of the queue
+     *
+     * @return T - the value at the front of the queue, or a default constructed T if the queue is empty
     */
-    void enqueue(int value){
-        if(isFull()){
-            resize();
+    T peek() const {
+        if (isEmpty()) {
+            return T();
         }
-        queue[++rear] = value;
-        elements++;
+        return Storage::buffer[head & mask()];
     }
 
     /**
-     * @brief Remove an element from the queue
-     * 
-     * @return int - the value removed
+     * @brief Add up to n elements in at most two contiguous copies
+     *
+     * A growable queue makes room for all of them at once; a fixed queue adds as many as fit.
+     *
+     * @param values - the values to add, front first
+     * @param n - the number of values
+     * @return size_t - the number of values added
     */
-    int dequeue(){
-        if(isEmpty()){
-            return -1;
+    size_t pushN(const T* values, size_t n) {
+        while (Storage::storageCapacity() - count() < n && grow()) {
+        }
+        size_t space = Storage::storageCapacity() - count();
+        if (n > space) {
+            n = space;
         }
-        return queue[front++];
-        elements--;
+        size_t start = tail & mask();
+        size_t first = Storage::storageCapacity() - start;
+        if (first > n) {
+            first = n;
+        }
+        copySpan(Storage::buffer + start, values, first);
+        copySpan(Storage::buffer, values + first, n - first);
+        tail += n;
+        return n;
     }
 
     /**
-     * @brief Get the value at the front of the queue
-     * 
-     * @return int - the value at the front of the queue
+     * @brief Remove up to n elements from the front in at most two contiguous copies
+     *
+     * @param out - receives the removed values, front first
+     * @param n - the maximum number of values to remove
+     * @return size_t - the number of values removed
     */
-    int peek(){
-        if(isEmpty()){
-            return -1;
+    size_t popN(T* out, size_t n) {
+        size_t size = count();
+        if (n > size) {
+            n = size;
         }
-        return queue[front];
+        copyOut(out, n);
+        head += n;
+        return n;
     }
 
     /**
      * @brief Check if the queue is empty
-     * 
+     *
      * @return bool - true if the queue is empty, false otherwise
     */
-    bool isEmpty(){
-        return front > rear;
-    
+    bool isEmpty() const {
+        return head == tail;
     }
 
     /**
-     * @brief Check if the queue is full
-     * 
-     * @return bool - true if the queue is full, false otherwise
+     * @brief Check if every slot is in use
+     *
+     * @return bool - true if the queue is full (a growable queue grows on the next enqueue), false otherwise
     */
-    bool isFull(){
-        return rear == size - 1;
+    bool isFull() const {
+        return count() == Storage::storageCapacity();
     }
 
     /**
-     * @brief Print the elements in the queue
-     * 
+     * @brief Print the elements in the queue, front first
+     *
      * @return void
     */
-    void print(){
-        for(int i = front; i <= rear; i++){
-            Serial.println(queue[i]);
+    void print() const {
+        for (size_t i = head; i != tail; i++) {
+            Serial.println(Storage::buffer[i & mask()]);
         }
     }
 
     /**
      * @brief Clear the queue
-     * 
+     *
      * @return void
     */
-    void clear(){
-        front = 0;
-        rear = -1;
-        elements = 0;
+    void clear() {
+        head = 0;
+        tail = 0;
+    }
+
+    /**
+     * @brief Get the number of elements in the queue
+    */
+    size_t count() const {
+        return tail - head;
     }
 
-    size_t count(){
-        return elements;
+    /**
+     * @brief Get the number of slots (a power of two)
+    */
+    size_t capacity() const {
+        return Storage::storageCapacity();
     }
 };
-#endif // QUEUE_h
\ No newline at end of file
+#endif // QUEUE_h
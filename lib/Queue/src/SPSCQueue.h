@@ -0,0 +1,240 @@
+#ifndef SPSCQUEUE_h
+#define SPSCQUEUE_h
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+/*
+ * Index publication. Each index has a single writer: tail belongs to the producer and head to the consumer. A side
+ * reads its own index without ordering (loadOwn) and publishes it with release semantics (store) after the slot it
+ * covers is written or read; the other side reads it with acquire semantics (load) before touching that slot.
+ *
+ * - AVR: volatile single byte indices. Byte loads and stores are atomic and the core is single, so a compiler barrier
+ *   is all the ordering needed. Limits the capacity to 128.
+ * - Toolchains with <atomic> (ARM, ESP32, RP2040, host builds): std::atomic<size_t> with acquire/release.
+ * - Anything else: volatile size_t indices with full barriers.
+*/
+#if defined(__AVR__)
+#define SPSCQUEUE_BYTE_INDICES
+#elif defined(__has_include)
+#if __has_include(<atomic>)
+#include <atomic>
+#define SPSCQUEUE_STD_ATOMIC
+#endif
+#endif
+
+#if defined(SPSCQUEUE_STD_ATOMIC)
+class SPSCIndex {
+public:
+    typedef size_t Type;
+
+    SPSCIndex() : value(0) {}
+
+    Type load() const {
+        return value.load(std::memory_order_acquire);
+    }
+
+    Type loadOwn() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+    void store(Type newValue) {
+        value.store(newValue, std::memory_order_release);
+    }
+
+private:
+    std::atomic<size_t> value;
+};
+#else
+class SPSCIndex {
+public:
+#if defined(SPSCQUEUE_BYTE_INDICES)
+    typedef uint8_t Type;
+#else
+    typedef size_t Type;
+#endif
+
+    SPSCIndex() : value(0) {}
+
+    Type load() const {
+        Type result = value;
+        barrier();
+        return result;
+    }
+
+    Type loadOwn() const {
+        return value;
+    }
+
+    void store(Type newValue) {
+        barrier();
+        value = newValue;
+    }
+
+private:
+    volatile Type value;
+
+    static void barrier() {
+#if defined(SPSCQUEUE_BYTE_INDICES)
+        asm volatile("" ::: "memory");
+#else
+        __sync_synchronize();
+#endif
+    }
+};
+#endif
+
+/**
+ * @brief A wait-free single-producer/single-consumer ring buffer for handing data from an ISR to loop()
+ *
+ * One context (usually an interrupt handler) calls only push()/pushN(), the other (usually loop()) calls only pop(),
+ * popN() and peek(). Neither side ever disables interrupts, spins or allocates: each call finishes in a bounded number
+ * of steps and fails instead of waiting when the queue is full or empty. count(), isEmpty() and isFull() may be called
+ * from either side and return a snapshot.
+ *
+ * head and tail count every element ever removed and added, like Queue; the slot of an index is index & (N - 1).
+ *
+ * @tparam T The type of the elements; copied by assignment, so keep it small and free of heap use in an ISR
+ * @tparam N The capacity, a power of two (at most 128 on AVR)
+*/
+template <class T, size_t N>
+class SPSCQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SPSCQueue<T, N> needs a power of two capacity");
+#if defined(SPSCQUEUE_BYTE_INDICES)
+    static_assert(N <= 128, "SPSCQueue<T, N> uses byte indices on AVR, so N is at most 128");
+#endif
+
+private:
+    typedef typename SPSCIndex::Type Index;
+
+    static const Index MASK = N - 1;
+
+    T buffer[N];
+    SPSCIndex head; // written by the consumer only
+    SPSCIndex tail; // written by the producer only
+
+    // Free-running difference; the cast keeps byte indices correct across wrap around.
+    static size_t distance(Index from, Index to) {
+        return static_cast<Index>(to - from);
+    }
+
+public:
+    SPSCQueue() {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /**
+     * @brief Add an element to the back of the queue (producer side)
+     *
+     * @param value - the value to add
+     * @return bool - false if the queue is full; the value is dropped
+    */
+    bool push(const T& value) {
+        Index t = tail.loadOwn();
+        if (distance(head.load(), t) == N) {
+            return false;
+        }
+        buffer[t & MASK] = value;
+        tail.store(static_cast<Index>(t + 1));
+        return true;
+    }
+
+    /**
+     * @brief Add up to n elements and publish them together (producer side)
+     *
+     * @param values - the values to add, front first
+     * @param n - the number of values
+     * @return size_t - the number of values added
+    */
+    size_t pushN(const T* values, size_t n) {
+        Index t = tail.loadOwn();
+        size_t space = N - distance(head.load(), t);
+        if (n > space) {
+            n = space;
+        }
+        for (size_t i = 0; i < n; i++) {
+            buffer[static_cast<Index>(t + i) & MASK] = values[i];
+        }
+        tail.store(static_cast<Index>(t + n));
+        return n;
+    }
+
+    /**
+     * @brief Remove the element at the front of the queue (consumer side)
+     *
+     * @param value - receives the removed value
+     * @return bool - false if the queue is empty
+    */
+    bool pop(T& value) {
+        Index h = head.loadOwn();
+        if (h == tail.load()) {
+            return false;
+        }
+        value = buffer[h & MASK];
+        head.store(static_cast<Index>(h + 1));
+        return true;
+    }
+
+    /**
+     * @brief Remove up to n elements and release their slots together (consumer side)
+     *
+     * Draining in batches publishes head once per batch instead of once per element.
+     *
+     * @param out - receives the removed values, front first
+     * @param n - the maximum number of values to remove
+     * @return size_t - the number of values removed
+    */
+    size_t popN(T* out, size_t n) {
+        Index h = head.loadOwn();
+        size_t available = distance(h, tail.load());
+        if (n > available) {
+            n = available;
+        }
+        for (size_t i = 0; i < n; i++) {
+            out[i] = buffer[static_cast<Index>(h + i) & MASK];
+        }
+        head.store(static_cast<Index>(h + n));
+        return n;
+    }
+
+    /**
+     * @brief Copy the element at the front of the queue without removing it (consumer side)
+     *
+     * @param value - receives the front value
+     * @return bool - false if the queue is empty
+    */
+    bool peek(T& value) const {
+        Index h = head.loadOwn();
+        if (h == tail.load()) {
+            return false;
+        }
+        value = buffer[h & MASK];
+        return true;
+    }
+
+    /**
+     * @brief Get the number of elements in the queue (a snapshot when called from the other side)
+    */
+    size_t count() const {
+        size_t size = distance(head.load(), tail.load());
+        return size > N ? N : size; // the other side may move both indices between the two loads
+    }
+
+    bool isEmpty() const {
+        return count() == 0;
+    }
+
+    bool isFull() const {
+        return count() == N;
+    }
+
+    size_t capacity() const {
+        return N;
+    }
+};
+#endif // SPSCQUEUE_h
@@ -0,0 +1,86 @@
+/*
+    Example Name: Intrusive Index Example For RedBlackTree Library
+
+    Indexes a fixed array of sensor channels two ways at once with IntrusiveRedBlackTree: by channel id and by the
+    latest reading. The channels live in a static array; each one carries a RedBlackHook per index, so inserting,
+    re-keying and removing never allocate. Every second the readings change, update() moves each channel to its new
+    place in the reading index, and the lowest and highest channels are printed.
+
+    The circuit:
+    This Library does not Require any Circuits to run.
+
+    Created  month day year   // 10/18/2026
+    By author's name braydenanderson2014 (Brayden Anderson)
+    Modified day month year  // 10/18/2026
+    By author's name  braydenanderson2014 (Brayden Anderson)
+
+    https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
+
+*/
+#include <IntrusiveRedBlackTree.h>
+
+struct Channel {
+    uint8_t id;
+    int reading;
+    RedBlackHook<Channel> byIdHook;
+    RedBlackHook<Channel> byReadingHook;
+};
+
+struct ById {
+    bool operator()(const Channel& a, const Channel& b) const {
+        return a.id < b.id;
+    }
+};
+
+struct ByReading {
+    bool operator()(const Channel& a, const Channel& b) const {
+        return a.reading < b.reading;
+    }
+};
+
+const uint8_t CHANNELS = 8;
+Channel channels[CHANNELS];
+
+IntrusiveRedBlackTree<Channel, &Channel::byIdHook, ById> byId;
+IntrusiveRedBlackTree<Channel, &Channel::byReadingHook, ByReading> byReading;
+
+void setup() {
+    Serial.begin(9600);
+    for (uint8_t i = 0; i < CHANNELS; i++) {
+        channels[i].id = CHANNELS - i; // ids out of array order
+        channels[i].reading = analogRead(A0);
+        byId.insert(channels[i]);
+        byReading.insert(channels[i]);
+    }
+
+    // Look a channel up by id with a probe holding just the key
+    Channel probe;
+    probe.id = 3;
+    Channel *three = byId.find(probe);
+    if (three != NULL) {
+        Serial.print("Channel 3 reads ");
+        Serial.println(three->reading);
+    }
+}
+
+void loop() {
+    for (uint8_t i = 0; i < CHANNELS; i++) {
+        channels[i].reading = analogRead(A0) + random(-50, 50);
+        byReading.update(channels[i]); // re-key in place: no allocation
+    }
+
+    Serial.print("Lowest: channel ");
+    Serial.print(byReading.first()->id);
+    Serial.print(" Highest: channel ");
+    Serial.println(byReading.last()->id);
+
+    // Channels in id order
+    for (Channel *channel = byId.first(); channel != NULL; channel = byId.next(*channel)) {
+        Serial.print(channel->id);
+        Serial.print("=");
+        Serial.print(channel->reading);
+        Serial.print(" ");
+    }
+    Serial.println();
+    delay(1000);
+}
@@ -0,0 +1,482 @@
+#ifndef INTRUSIVE_REDBLACK_TREE_h
+#define INTRUSIVE_REDBLACK_TREE_h
+
+#include <Arduino.h>
+
+/**
+ * @brief The links an IntrusiveRedBlackTree needs, embedded in the indexed object
+ *
+ * Put one hook in the struct for every tree the object should be in. The colour is kept in the low bit of the
+ * parent pointer, which the alignment of the hook (at least 2) leaves free, so a hook is three pointers.
+ *
+ * A copy of a hook is unlinked: copying an object never copies its place in a tree.
+ *
+ * @tparam T The type of the object holding the hook
+*/
+template <typename T>
+struct alignas(2) alignas(void*) RedBlackHook {
+    T *left;
+    T *right;
+    uintptr_t parentAndColor; // the parent (NULL for the root or an unlinked object), low bit set when red
+
+    RedBlackHook() : left(NULL), right(NULL), parentAndColor(0) {}
+
+    RedBlackHook(const RedBlackHook&) : left(NULL), right(NULL), parentAndColor(0) {}
+
+    RedBlackHook& operator=(const RedBlackHook&) {
+        return *this;
+    }
+};
+
+/**
+ * @brief The default ordering of an IntrusiveRedBlackTree: operator< of T
+*/
+template <typename T>
+struct RedBlackLess {
+    bool operator()(const T& a, const T& b) const {
+        return a < b;
+    }
+};
+
+/**
+ * @brief A red-black tree of objects that live elsewhere (static arrays, globals), linked through a hook inside them
+ *
+ * The tree owns no memory and never allocates: insert(), erase() and update() only rewrite the links in the hooks.
+ * An object with several hooks can be in several trees at once, each ordered by its own Compare:
+ *
+ *     struct Task {
+ *         uint32_t due;
+ *         uint8_t priority;
+ *         RedBlackHook<Task> byDueHook;
+ *         RedBlackHook<Task> byPriorityHook;
+ *     };
+ *     struct ByDue { bool operator()(const Task& a, const Task& b) const { return a.due < b.due; } };
+ *     IntrusiveRedBlackTree<Task, &Task::byDueHook, ByDue> byDue;
+ *
+ * Equal keys are allowed; an object goes after the objects already in the tree that compare equal to it. An object
+ * must not be inserted into a tree it is already in, and must be erased (or the tree cleared) before it is destroyed.
+ *
+ * @tparam T The type of the objects
+ * @tparam Hook The hook member of T this tree uses
+ * @tparam Compare A strict weak ordering of T: bool operator()(const T&, const T&)
+*/
+template <typename T, RedBlackHook<T> T::*Hook, typename Compare = RedBlackLess<T> >
+class IntrusiveRedBlackTree {
+    private:
+        T *root;
+        size_t count;
+        Compare compare;
+
+        static RedBlackHook<T>& hook(T *node) {
+            return node->*Hook;
+        }
+
+        static T *parentOf(T *node) {
+            return reinterpret_cast<T*>(hook(node).parentAndColor & ~static_cast<uintptr_t>(1));
+        }
+
+        static bool isRed(T *node) {
+            return node != NULL && (hook(node).parentAndColor & 1) != 0;
+        }
+
+        static void setParent(T *node, T *parent) {
+            hook(node).parentAndColor = reinterpret_cast<uintptr_t>(parent) | (hook(node).parentAndColor & 1);
+        }
+
+        static void setRed(T *node, bool red) {
+            hook(node).parentAndColor = (hook(node).parentAndColor & ~static_cast<uintptr_t>(1)) | (red ? 1 : 0);
+        }
+
+        static T *leftmost(T *node) {
+            while (hook(node).left != NULL) {
+                node = hook(node).left;
+            }
+            return node;
+        }
+
+        static T *rightmost(T *node) {
+            while (hook(node).right != NULL) {
+                node = hook(node).right;
+            }
+            return node;
+        }
+
+        // Point the link that held oldChild (in parent, or the root) at newChild
+        void replaceChild(T *parent, T *oldChild, T *newChild) {
+            if (parent == NULL) {
+                root = newChild;
+            } else if (hook(parent).left == oldChild) {
+                hook(parent).left = newChild;
+            } else {
+                hook(parent).right = newChild;
+            }
+        }
+
+        // Put the subtree at replacement (may be NULL) where node was
+        void transplant(T *node, T *replacement) {
+            T *parent = parentOf(node);
+            replaceChild(parent, node, replacement);
+            if (replacement != NULL) {
+                setParent(replacement, parent);
+            }
+        }
+
+        void rotateLeft(T *node) {
+            T *child = hook(node).right;
+            hook(node).right = hook(child).left;
+            if (hook(child).left != NULL) {
+                setParent(hook(child).left, node);
+            }
+            transplant(node, child);
+            hook(child).left = node;
+            setParent(node, child);
+        }
+
+        void rotateRight(T *node) {
+            T *child = hook(node).left;
+            hook(node).left = hook(child).right;
+            if (hook(child).right != NULL) {
+                setParent(hook(child).right, node);
+            }
+            transplant(node, child);
+            hook(child).right = node;
+            setParent(node, child);
+        }
+
+        void insertFixup(T *node) {
+            T *parent;
+            while (isRed(parent = parentOf(node))) {
+                T *grandparent = parentOf(parent); // a red parent is never the root
+                if (parent == hook(grandparent).left) {
+                    T *uncle = hook(grandparent).right;
+                    if (isRed(uncle)) {
+                        setRed(parent, false);
+                        setRed(uncle, false);
+                        setRed(grandparent, true);
+                        node = grandparent;
+                        continue;
+                    }
+                    if (node == hook(parent).right) {
+                        rotateLeft(parent);
+                        parent = node;
+                    }
+                    setRed(parent, false);
+                    setRed(grandparent, true);
+                    rotateRight(grandparent);
+                    break;
+                } else {
+                    T *uncle = hook(grandparent).left;
+                    if (isRed(uncle)) {
+                        setRed(parent, false);
+                        setRed(uncle, false);
+                        setRed(grandparent, true);
+                        node = grandparent;
+                        continue;
+                    }
+                    if (node == hook(parent).left) {
+                        rotateRight(parent);
+                        parent = node;
+                    }
+                    setRed(parent, false);
+                    setRed(grandparent, true);
+                    rotateLeft(grandparent);
+                    break;
+                }
+            }
+            setRed(root, false);
+        }
+
+        // Restore the black heights after a black node was removed above node (which may be NULL, so its parent
+        // is passed along)
+        void eraseFixup(T *node, T *parent) {
+            while (node != root && !isRed(node)) {
+                if (node == hook(parent).left) {
+                    T *sibling = hook(parent).right;
+                    if (isRed(sibling)) {
+                        setRed(sibling, false);
+                        setRed(parent, true);
+                        rotateLeft(parent);
+                        sibling = hook(parent).right;
+                    }
+                    if (!isRed(hook(sibling).left) && !isRed(hook(sibling).right)) {
+                        setRed(sibling, true);
+                        node = parent;
+                        parent = parentOf(node);
+                        continue;
+                    }
+                    if (!isRed(hook(sibling).right)) {
+                        setRed(hook(sibling).left, false);
+                        setRed(sibling, true);
+                        rotateRight(sibling);
+                        sibling = hook(parent).right;
+                    }
+                    setRed(sibling, isRed(parent));
+                    setRed(parent, false);
+                    setRed(hook(sibling).right, false);
+                    rotateLeft(parent);
+                } else {
+                    T *sibling = hook(parent).left;
+                    if (isRed(sibling)) {
+                        setRed(sibling, false);
+                        setRed(parent, true);
+                        rotateRight(parent);
+                        sibling = hook(parent).left;
+                    }
+                    if (!isRed(hook(sibling).left) && !isRed(hook(sibling).right)) {
+                        setRed(sibling, true);
+                        node = parent;
+                        parent = parentOf(node);
+                        continue;
+                    }
+                    if (!isRed(hook(sibling).left)) {
+                        setRed(hook(sibling).right, false);
+                        setRed(sibling, true);
+                        rotateLeft(sibling);
+                        sibling = hook(parent).left;
+                    }
+                    setRed(sibling, isRed(parent));
+                    setRed(parent, false);
+                    setRed(hook(sibling).left, false);
+                    rotateRight(parent);
+                }
+                node = root;
+            }
+            if (node != NULL) {
+                setRed(node, false);
+            }
+        }
+
+        static void unlink(T *node) {
+            hook(node).left = NULL;
+            hook(node).right = NULL;
+            hook(node).parentAndColor = 0;
+        }
+
+    public:
+        IntrusiveRedBlackTree(Compare compare = Compare()) : root(NULL), count(0), compare(compare) {}
+
+        // Unlinks every object, so they can go into another tree
+        ~IntrusiveRedBlackTree() {
+            clear();
+        }
+
+        IntrusiveRedBlackTree(const IntrusiveRedBlackTree&) = delete;
+        IntrusiveRedBlackTree& operator=(const IntrusiveRedBlackTree&) = delete;
+
+        /**
+         * @brief Link an object into the tree in O(log n) without allocating
+         *
+         * @param item - an object that is not in this tree
+        */
+        void insert(T &item) {
+            T *node = &item;
+            T *parent = NULL;
+            T **link = &root;
+            while (*link != NULL) {
+                parent = *link;
+                link = compare(item, *parent) ? &hook(parent).left : &hook(parent).right;
+            }
+            hook(node).left = NULL;
+            hook(node).right = NULL;
+            hook(node).parentAndColor = reinterpret_cast<uintptr_t>(parent) | 1;
+            *link = node;
+            count++;
+            insertFixup(node);
+        }
+
+        /**
+         * @brief Unlink an object from the tree in O(log n)
+         *
+         * No comparisons are made, so the key of the object may already have changed.
+         *
+         * @param item - an object in this tree
+        */
+        void erase(T &item) {
+            T *node = &item;
+            T *child;
+            T *childParent;
+            bool removedRed;
+            if (hook(node).left == NULL || hook(node).right == NULL) {
+                child = hook(node).left != NULL ? hook(node).left : hook(node).right;
+                childParent = parentOf(node);
+                removedRed = isRed(node);
+                transplant(node, child);
+            } else {
+                // Two children: the in-order successor takes the place (and colour) of node
+                T *successor = leftmost(hook(node).right);
+                removedRed = isRed(successor);
+                child = hook(successor).right;
+                if (parentOf(successor) == node) {
+                    childParent = successor;
+                } else {
+                    childParent = parentOf(successor);
+                    transplant(successor, child);
+                    hook(successor).right = hook(node).right;
+                    setParent(hook(successor).right, successor);
+                }
+                transplant(node, successor);
+                hook(successor).left = hook(node).left;
+                setParent(hook(successor).left, successor);
+                setRed(successor, isRed(node));
+            }
+            unlink(node);
+            count--;
+            if (!removedRed) {
+                eraseFixup(child, childParent);
+            }
+        }
+
+        /**
+         * @brief Move an object to its new place after its key changed
+         *
+         * Does nothing when the object is still in order with its neighbours; otherwise erases and reinserts it.
+         *
+         * @param item - an object in this tree
+        */
+        void update(T &item) {
+            T *before = prev(item);
+            T *after = next(item);
+            if ((before == NULL || !compare(item, *before)) && (after == NULL || !compare(*after, item))) {
+                return;
+            }
+            erase(item);
+            insert(item);
+        }
+
+        /**
+         * @brief Check if an object is in this tree, by walking up its parent links in O(log n)
+        */
+        bool contains(const T &item) const {
+            T *node = const_cast<T*>(&item);
+            while (parentOf(node) != NULL) {
+                node = parentOf(node);
+            }
+            return node == root;
+        }
+
+        /**
+         * @brief Find the first object equal to probe (neither orders before the other)
+         *
+         * @param probe - an object holding the key to look for; it does not have to be in the tree
+         * @return T* - the object, or NULL if there is none
+        */
+        T *find(const T &probe) const {
+            T *node = lowerBound(probe);
+            return node != NULL && !compare(probe, *node) ? node : NULL;
+        }
+
+        /**
+         * @brief Find the first object that does not order before probe
+         * @return T* - the object, or NULL if every object orders before probe
+        */
+        T *lowerBound(const T &probe) const {
+            T *node = root;
+            T *result = NULL;
+            while (node != NULL) {
+                if (compare(*node, probe)) {
+                    node = hook(node).right;
+                } else {
+                    result = node;
+                    node = hook(node).left;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Find the first object that orders after probe
+         * @return T* - the object, or NULL if there is none
+        */
+        T *upperBound(const T &probe) const {
+            T *node = root;
+            T *result = NULL;
+            while (node != NULL) {
+                if (compare(probe, *node)) {
+                    result = node;
+                    node = hook(node).left;
+                } else {
+                    node = hook(node).right;
+                }
+            }
+            return result;
+        }
+
+        T *first() const {
+            return root == NULL ? NULL : leftmost(root);
+        }
+
+        T *last() const {
+            return root == NULL ? NULL : rightmost(root);
+        }
+
+        /**
+         * @brief Get the object after item in the order of the tree
+         * @return T* - the next object, or NULL after the last one
+        */
+        T *next(T &item) const {
+            T *node = &item;
+            if (hook(node).right != NULL) {
+                return leftmost(hook(node).right);
+            }
+            T *parent = parentOf(node);
+            while (parent != NULL && node == hook(parent).right) {
+                node = parent;
+                parent = parentOf(node);
+            }
+            return parent;
+        }
+
+        /**
+         * @brief Get the object before item in the order of the tree
+         * @return T* - the previous object, or NULL before the first one
+        */
+        T *prev(T &item) const {
+            T *node = &item;
+            if (hook(node).left != NULL) {
+                return rightmost(hook(node).left);
+            }
+            T *parent = parentOf(node);
+            while (parent != NULL && node == hook(parent).left) {
+                node = parent;
+                parent = parentOf(node);
+            }
+            return parent;
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        bool isEmpty() const {
+            return root == NULL;
+        }
+
+        /**
+         * @brief Unlink every object in O(n), without recursion or a stack
+        */
+        void clear() {
+            T *node = root;
+            while (node != NULL) {
+                if (hook(node).left != NULL) {
+                    node = hook(node).left;
+                } else if (hook(node).right != NULL) {
+                    node = hook(node).right;
+                } else {
+                    T *parent = parentOf(node);
+                    if (parent != NULL) {
+                        if (hook(parent).left == node) {
+                            hook(parent).left = NULL;
+                        } else {
+                            hook(parent).right = NULL;
+                        }
+                    }
+                    unlink(node);
+                    node = parent;
+                }
+            }
+            root = NULL;
+            count = 0;
+        }
+};
+
+#endif // INTRUSIVE_REDBLACK_TREE_h
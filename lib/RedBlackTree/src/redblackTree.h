@@ -2,12 +2,28 @@
 #define REDBLACK_TREE_h
 
 #include <Arduino.h>
+#include <new>
 
 
 enum DualColor {RED, BLACK};
 
-template <typename T>
-struct RedBlackNode {
+/**
+ * @brief Subtree size kept in each node of a RedBlackTree<T, true>; empty (and free) otherwise
+ * @private
+*/
+template <bool OrderStatistics>
+struct RedBlackSubtreeSize {
+    size_t count; // nodes in the subtree rooted here
+
+    RedBlackSubtreeSize() : count(1) {}
+};
+
+template <>
+struct RedBlackSubtreeSize<false> {
+};
+
+template <typename T, bool OrderStatistics = false>
+struct RedBlackNode : RedBlackSubtreeSize<OrderStatistics> {
     T data;
     bool color;
     RedBlackNode *left, *right, *parent;
@@ -21,35 +37,111 @@ struct RedBlackNode {
 };
 
 
-template <typename T>
+/**
+ * @brief A red-black tree
+ *
+ * @tparam T The type of the values
+ * @tparam OrderStatistics If true, every node also counts the nodes below it (kept up to date through rotations),
+ * which enables select(), rank(), countInRange() and size() in O(log n) at the cost of a size_t per node
+*/
+template <typename T, bool OrderStatistics = false>
 class RedBlackTree{
+    public:
+        typedef RedBlackNode<T, OrderStatistics> Node;
+
     private:
-        RedBlackNode<T> *root;
+        template <bool B> struct Tag {};
 
-        RedBlackNode<T>* BSTInsert(RedBlackNode<T>* root, RedBlackNode<T>* newNode){
-            if(root == NULL){
-                return newNode;
+        static size_t count(Node* node){
+            return node == NULL ? 0 : node->count;
+        }
+
+        static void updateCount(Node* node, Tag<true>){
+            node->count = 1 + count(node->left) + count(node->right);
+        }
+
+        static void updateCount(Node*, Tag<false>){
+        }
+
+        // Add one to (grow) or take one from the subtree size of node and every ancestor
+        static void updatePath(Node* node, bool grow, Tag<true>){
+            for(; node != NULL; node = node->parent){
+                if(grow){
+                    node->count++;
+                }else{
+                    node->count--;
+                }
             }
-            if(newNode->data < root->data){
-                root->left = BSTInsert(root->left, newNode);
-                root->left->parent = root;
-            }else if(newNode->data > root->data){
-                root->right = BSTInsert(root->right, newNode);
-                root->right->parent = root;
+        }
+
+        static void updatePath(Node*, bool, Tag<false>){
+        }
+
+        // Number of values less than x (orEqual: less than or equal to x), walking one path from the root
+        size_t countBelow(const T& x, bool orEqual){
+            size_t result = 0;
+            Node *node = root;
+            while(node != NULL){
+                if(node->data < x || (orEqual && !(x < node->data))){
+                    result += count(node->left) + 1;
+                    node = node->right;
+                }else{
+                    node = node->left;
+                }
+            }
+            return result;
+        }
+
+        Node *root;
+        Node *block; // nodes of the last buildFromSorted(), allocated together
+        size_t blockSize;
+
+        bool inBlock(Node* node){
+            return node >= block && node < block + blockSize;
+        }
+
+        // Nodes from the block are only destroyed here; their memory goes back when the tree is cleared.
+        void freeNode(Node* node){
+            if(inBlock(node)){
+                node->~Node();
+            }else{
+                delete node;
             }
-            return root;
         }
 
-        void fixViolation(RedBlackNode<T>* &root, RedBlackNode<T>* &newNode){
-            RedBlackNode<T> *parent = NULL;
-            RedBlackNode<T> *grandparent = NULL;
+        void freeBlock(){
+            ::operator delete(static_cast<void*>(block));
+            block = NULL;
+            blockSize = 0;
+        }
+
+        // Link block[lo, hi) (already in order) into a balanced subtree with its middle node as the root. Every
+        // null link then sits at depth redDepth or redDepth + 1, so colouring the nodes at depth redDepth red (they
+        // are all leaves) and the rest black gives every path the same number of black nodes.
+        Node* linkBalanced(size_t lo, size_t hi, int depth, int redDepth, Node* parent){
+            if(lo >= hi){
+                return NULL;
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            Node *node = block + mid;
+            node->parent = parent;
+            node->color = depth == redDepth ? RED : BLACK;
+            node->left = linkBalanced(lo, mid, depth + 1, redDepth, node);
+            node->right = linkBalanced(mid + 1, hi, depth + 1, redDepth, node);
+            updateCount(node, Tag<OrderStatistics>());
+            return node;
+        }
+
+        void fixViolation(Node* &root, Node* &newNode){
+            Node *parent = NULL;
+            Node *grandparent = NULL;
 
             while((newNode != root) && (newNode->color != BLACK) && (newNode->parent->color == RED)){
                 parent = newNode->parent;
                 grandparent = newNode->parent->parent;
 
                 if(parent == grandparent->left){
-                    RedBlackNode<T> *uncle = grandparent->right;
+                    Node *uncle = grandparent->right;
                     if(uncle != NULL && uncle->color == RED){
                         grandparent->color = RED;
                         parent->color = BLACK;
@@ -62,11 +154,13 @@ class RedBlackTree{
                             parent = newNode->parent;
                         }
                         rightRotate(root, grandparent);
-                        swap(parent->color, grandparent->color);
+                        bool color = parent->color;
+                        parent->color = grandparent->color;
+                        grandparent->color = color;
                         newNode = parent;
                     }
                 }else{
-                    RedBlackNode<T> *uncle = grandparent->left;
+                    Node *uncle = grandparent->left;
                     if((uncle != NULL) && (uncle->color == RED)){
                         grandparent->color = RED;
                         parent->color = BLACK;
@@ -79,7 +173,9 @@ class RedBlackTree{
                             parent = newNode->parent;
                         }
                         leftRotate(root, grandparent);
-                        swap(parent->color, grandparent->color);
+                        bool color = parent->color;
+                        parent->color = grandparent->color;
+                        grandparent->color = color;
                         newNode = parent;
                     }
                 }
@@ -87,8 +183,8 @@ class RedBlackTree{
             root->color = BLACK;
         }
 
-        void leftRotate(RedBlackNode<T>* &root, RedBlackNode<T>* &node){
-            RedBlackNode<T> *rightChild = node->right;
+        void leftRotate(Node* &root, Node* &node){
+            Node *rightChild = node->right;
             node->right = rightChild->left;
             if(node->right != NULL){
                 node->right->parent = node;
@@ -103,10 +199,12 @@ class RedBlackTree{
             }
             rightChild->left = node;
             node->parent = rightChild;
+            updateCount(node, Tag<OrderStatistics>());
+            updateCount(rightChild, Tag<OrderStatistics>());
         }
 
-        void rightRotate(RedBlackNode<T>* &root, RedBlackNode<T>* &node){
-            RedBlackNode<T> *leftChild = node->left;
+        void rightRotate(Node* &root, Node* &node){
+            Node *leftChild = node->left;
             node->left = leftChild->right;
             if(node->left != NULL){
                 node->left->parent = node;
@@ -121,14 +219,16 @@ class RedBlackTree{
             }
             leftChild->right = node;
             node->parent = leftChild;
+            updateCount(node, Tag<OrderStatistics>());
+            updateCount(leftChild, Tag<OrderStatistics>());
         }
 
-        void deleteNodeHelper(RedBlackNode<T>* &root, T &data){
-            RedBlackNode<T> *node = root;
-            RedBlackNode<T> *parent = NULL;
-            RedBlackNode<T> *child = NULL;
-            RedBlackNode<T> *successor = NULL;
-            RedBlackNode<T> *toDelete = NULL;
+        void deleteNodeHelper(Node* &root, const T &data){
+            Node *node = root;
+            Node *parent = NULL;
+            Node *child = NULL;
+            Node *successor = NULL;
+            Node *toDelete = NULL;
             while(node != NULL){
                 if(node->data == data){
                     toDelete = node;
@@ -169,14 +269,15 @@ class RedBlackTree{
             if(successor != toDelete){
                 toDelete->data = successor->data;
             }
+            updatePath(parent, false, Tag<OrderStatistics>());
             if(successor->color == BLACK){
                 fixDoubleBlack(root, child, parent);
             }
-            delete successor;
+            freeNode(successor);
         }
 
-        void fixDoubleBlack(RedBlackNode<T>* &root, RedBlackNode<T>* &node, RedBlackNode<T>* &parent){
-            RedBlackNode<T> *sibling = NULL;
+        void fixDoubleBlack(Node* &root, Node* &node, Node* &parent){
+            Node *sibling = NULL;
             while((node == NULL || node->color == BLACK) && node != root){
                 if(node == parent->left){
                     sibling = parent->right;
@@ -237,12 +338,12 @@ class RedBlackTree{
             }
         }
 
-        RedBlackNode<T>* deleteNode(RedBlackNode<T>* &root, T &data){
+        Node* deleteNode(Node* &root, const T &data){
             deleteNodeHelper(root, data);
             return root;
         }
 
-        RedBlackNode<T>* search(RedBlackNode<T>* root, const T &data){
+        Node* search(Node* root, const T &data){
             if(root == NULL || root->data == data){
                 return root;
             }
@@ -252,7 +353,7 @@ class RedBlackTree{
             return search(root->left, data);
         }
 
-        void inOrderHelper(RedBlackNode<T>* root){
+        void inOrderHelper(Node* root){
             if(root == NULL){
                 return;
             }
@@ -262,7 +363,7 @@ class RedBlackTree{
             inOrderHelper(root->right);
         }
 
-        void preOrderHelper(RedBlackNode<T>* root){
+        void preOrderHelper(Node* root){
             if(root == NULL){
                 return;
             }
@@ -272,7 +373,7 @@ class RedBlackTree{
             preOrderHelper(root->right);
         }
 
-        void postOrderHelper(RedBlackNode<T>* root){
+        void postOrderHelper(Node* root){
             if(root == NULL){
                 return;
             }
@@ -284,14 +385,80 @@ class RedBlackTree{
 
         
     public:
-        RedBlackTree() {root = NULL;}
+        RedBlackTree() {root = NULL; block = NULL; blockSize = 0;}
+
+        /**
+         * @brief Construct a balanced tree from count values in ascending order
+         * @see buildFromSorted
+        */
+        template <typename Iterator>
+        RedBlackTree(Iterator first, size_t count) {
+            root = NULL;
+            block = NULL;
+            blockSize = 0;
+            buildFromSorted(first, count);
+        }
+
         ~RedBlackTree(){
-            clear(root);
+            clear();
         }
 
+        RedBlackTree(const RedBlackTree&) = delete;
+        RedBlackTree& operator=(const RedBlackTree&) = delete;
+
+        /**
+         * @brief Replace the contents with count values read from first, which must be in strictly ascending order
+         *
+         * Builds a balanced tree in O(n) without comparisons, rotations or recolouring passes: the values are copied
+         * into one block of count nodes, each range of the block is linked with its middle node as the root, and only
+         * the nodes on an incomplete last level are red. The order is not checked.
+         *
+         * @param first - an iterator (or pointer) to the first value; it is read once, front to back
+         * @param count - the number of values
+         * @return bool - false if the block could not be allocated (the tree is left empty)
+        */
+        template <typename Iterator>
+        bool buildFromSorted(Iterator first, size_t count){
+            clear();
+            if(count == 0){
+                return true;
+            }
+            block = static_cast<Node*>(::operator new(count * sizeof(Node)));
+            if(block == NULL){
+                return false;
+            }
+            blockSize = count;
+            for(size_t i = 0; i < count; i++, ++first){
+                new (block + i) Node(*first);
+            }
+            int redDepth = 0; // floor(log2(count + 1)): the depth of the incomplete last level, if there is one
+            for(size_t full = count + 1; full > 1; full >>= 1){
+                redDepth++;
+            }
+            root = linkBalanced(0, count, 0, redDepth, NULL);
+            return true;
+        }
+
+        /**
+         * @brief Insert a value. Duplicates are ignored (nothing is allocated for them).
+        */
         void insert(const T &data){
-            RedBlackNode<T> *newNode = new RedBlackNode<T>(data);
-            root = BSTInsert(root, newNode);
+            Node *parent = NULL;
+            Node **link = &root;
+            while(*link != NULL){
+                parent = *link;
+                if(data < parent->data){
+                    link = &parent->left;
+                }else if(data > parent->data){
+                    link = &parent->right;
+                }else{
+                    return;
+                }
+            }
+            Node *newNode = new Node(data);
+            newNode->parent = parent;
+            *link = newNode;
+            updatePath(parent, true, Tag<OrderStatistics>());
             fixViolation(root, newNode);
         }
         
@@ -299,7 +466,7 @@ class RedBlackTree{
             root = deleteNode(root, data);
         }
 
-        RedBlackNode<T>* search(const T &data){
+        Node* search(const T &data){
             return search(root, data);
         }
     
@@ -317,44 +484,106 @@ class RedBlackTree{
 
         void clear(){
             clear(root);
+            root = NULL;
+            freeBlock();
         }
 
-        void clear(RedBlackNode<T>* &root){
+        void clear(Node* &root){
             if(root == NULL){
                 return;
             }
             clear(root->left);
             clear(root->right);
-            delete root;
+            freeNode(root);
         }
 
-        void rotateLeft(RedBlackNode<T>* &node){
+        void rotateLeft(Node* &node){
             leftRotate(root, node);
         }
 
-        void rotateRight(RedBlackNode<T>* &node){
+        void rotateRight(Node* &node){
             rightRotate(root, node);
         }
 
-        RedBlackNode<T>* getRoot(){
+        Node* getRoot(){
             return root;
         }
 
-        RedBlackNode<T>* getMin(){
-            RedBlackNode<T> *node = root;
+        Node* getMin(){
+            Node *node = root;
             while(node->left != NULL){
                 node = node->left;
             }
             return node;
         }
 
-        RedBlackNode<T>* getMax(){
-            RedBlackNode<T> *node = root;
+        Node* getMax(){
+            Node *node = root;
             while(node->right != NULL){
                 node = node->right;
             }
             return node;
         }
+
+        /**
+         * @brief Get the number of values in the tree in O(1)
+         * @note Needs RedBlackTree<T, true>
+        */
+        size_t size(){
+            static_assert(OrderStatistics, "size() needs RedBlackTree<T, true>");
+            return count(root);
+        }
+
+        /**
+         * @brief Get the k-th smallest value (k = 0 is the minimum) in O(log n)
+         *
+         * select(size() / 2) is the median, select(size() * 9 / 10) the 90th percentile.
+         *
+         * @param k - the 0-based position in sorted order
+         * @param value - receives the value
+         * @return bool - false if k >= size()
+         * @note Needs RedBlackTree<T, true>
+        */
+        bool select(size_t k, T &value){
+            static_assert(OrderStatistics, "select() needs RedBlackTree<T, true>");
+            Node *node = root;
+            while(node != NULL){
+                size_t smaller = count(node->left);
+                if(k < smaller){
+                    node = node->left;
+                }else if(k > smaller){
+                    k -= smaller + 1;
+                    node = node->right;
+                }else{
+                    value = node->data;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Get the number of values less than x in O(log n); x does not have to be in the tree
+         *
+         * For a value in the tree this is its 0-based position, so select(rank(x)) gives x back.
+         * @note Needs RedBlackTree<T, true>
+        */
+        size_t rank(const T &x){
+            static_assert(OrderStatistics, "rank() needs RedBlackTree<T, true>");
+            return countBelow(x, false);
+        }
+
+        /**
+         * @brief Get the number of values v with lo <= v <= hi in O(log n)
+         * @note Needs RedBlackTree<T, true>
+        */
+        size_t countInRange(const T &lo, const T &hi){
+            static_assert(OrderStatistics, "countInRange() needs RedBlackTree<T, true>");
+            if(hi < lo){
+                return 0;
+            }
+            return countBelow(hi, true) - countBelow(lo, false);
+        }
 };
 
 #endif //   REDBLACK_TREE_h
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define SIMPLEVECTOR_H
 
 #include <Arduino.h>
+#include <new>
 #ifdef ESP32
     #include <initializer_list>
     #define useInit
@@ -22,10 +23,79 @@
     #include <initializer_list>
     #define useInit
 #endif
+/**
+ * @brief Raw storage helpers shared by SimpleVector and SmallVector
+ *
+ * Elements live in uninitialized memory and are constructed with placement new. Relocation moves elements
+ * (or memcpy's them when T is trivially copyable) and ends their lifetime in the old block.
+*/
+template<typename T>
+struct SimpleVectorStorage {
+    // Types that can be copied with memcpy and need no destructor (int, float, pointers, plain structs).
+    // A nested struct so the check only runs once T is complete (a node type may hold a SimpleVector of itself).
+    struct Trivial {
+        static const bool value = __has_trivial_copy(T) && __has_trivial_destructor(T);
+    };
+
+    template<bool B> struct Tag {};
+
+    /**
+     * @brief Allocate uninitialized storage for n elements
+     *
+     * @note operator new returns memory aligned for any type, so no element is constructed here.
+    */
+    static T* allocate(unsigned int n) {
+        return n == 0 ? nullptr : static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    static void deallocate(T* block) {
+        ::operator delete(block);
+    }
+
+    // Move n elements from src into the uninitialized dest and end their lifetime in src.
+    static void relocate(T* dest, T* src, unsigned int n) {
+        relocate(dest, src, n, Tag<Trivial::value>());
+    }
+
+    static void destroy(T* first, unsigned int n) {
+        destroy(first, n, Tag<Trivial::value>());
+    }
+
+    static void copyConstruct(T* dest, const T* src, unsigned int n) {
+        for (unsigned int i = 0; i < n; i++) {
+            new (dest + i) T(src[i]);
+        }
+    }
+
+private:
+    static void relocate(T* dest, T* src, unsigned int n, Tag<true>) {
+        if (n) {
+            memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(T));
+        }
+    }
+
+    static void relocate(T* dest, T* src, unsigned int n, Tag<false>) {
+        for (unsigned int i = 0; i < n; i++) {
+            new (dest + i) T(static_cast<T&&>(src[i]));
+            src[i].~T();
+        }
+    }
+
+    static void destroy(T*, unsigned int, Tag<true>) {}
+
+    static void destroy(T* first, unsigned int n, Tag<false>) {
+        for (unsigned int i = 0; i < n; i++) {
+            first[i].~T();
+        }
+    }
+};
+
 template<typename T>
 class SimpleVector {
 private:
-    T* array;
+    typedef SimpleVectorStorage<T> Storage;
+
+    T* array;               // Raw storage: only the first count slots hold constructed elements
     unsigned int count;
     unsigned int capacity;
 
@@ -35,19 +105,20 @@ private:
      * 
      * @private This method is private because it is only used internally.
      * 
-     * @note This method will copy all elements from the old array to the new array.
+     * @note The elements are moved (or memcpy'd for trivial types) into the new block, never copied.
     */
     void resize(unsigned int newCapacity) {
-        T* newArray = new T[newCapacity];
-        
-        for (unsigned int i = 0; i < count; i++) {
-            newArray[i] = array[i];
-        }
-        delete[] array;
+        T* newArray = Storage::allocate(newCapacity);
+        Storage::relocate(newArray, array, count);
+        Storage::deallocate(array);
         array = newArray;
         capacity = newCapacity;
     }
 
+    unsigned int grownCapacity() const {
+        return capacity == 0 ? 4 : 2 * capacity;
+    }
+
     /**
      * @brief Ensure that the vector has enough capacity to add a new element
      * 
@@ -55,34 +126,70 @@ private:
     */
     void ensureCapacity() {
         if (count == capacity) {
-            resize(2 * capacity);
+            resize(grownCapacity());
         }
     }
 public:
     // The SimpleVectorIterator class will be defined below
     class SimpleVectorIterator;
 
-    SimpleVector() : array(new T[4]), count(0), capacity(4) {}
+    // The first put() allocates; this also lets a type hold a SimpleVector of itself (e.g. tree nodes).
+    SimpleVector() : array(nullptr), count(0), capacity(0) {}
 
-    SimpleVector(unsigned int initialCapacity) : array(new T[initialCapacity]), count(0), capacity(initialCapacity) {}
+    SimpleVector(unsigned int initialCapacity) : array(Storage::allocate(initialCapacity)), count(0), capacity(initialCapacity) {}
 
-    SimpleVector(const SimpleVector& other) : array(new T[other.capacity]), count(other.count), capacity(other.capacity) {
-        for (unsigned int i = 0; i < count; i++) {
-            array[i] = other.array[i];
+    SimpleVector(const SimpleVector& other) : array(Storage::allocate(other.capacity)), count(other.count), capacity(other.capacity) {
+        Storage::copyConstruct(array, other.array, count);
+    }
+
+    SimpleVector(SimpleVector&& other) : array(other.array), count(other.count), capacity(other.capacity) {
+        other.array = nullptr;
+        other.count = 0;
+        other.capacity = 0;
+    }
+
+    /**
+     * @brief Copy assignment operator
+     * @param other The vector to copy
+     * @return Reference to this vector
+     *
+     * @note Without this the compiler generated assignment copies the array pointer and both vectors free it.
+    */
+    SimpleVector& operator=(const SimpleVector& other) {
+        if (this != &other) {
+            T* newArray = Storage::allocate(other.capacity);
+            Storage::copyConstruct(newArray, other.array, other.count);
+            releaseMemory();
+            array = newArray;
+            count = other.count;
+            capacity = other.capacity;
         }
+        return *this;
+    }
+
+    SimpleVector& operator=(SimpleVector&& other) {
+        if (this != &other) {
+            releaseMemory();
+            array = other.array;
+            count = other.count;
+            capacity = other.capacity;
+            other.array = nullptr;
+            other.count = 0;
+            other.capacity = 0;
+        }
+        return *this;
     }
 
     #ifdef useInit
-    SimpleVector(initializer_list<T> initList) : array(new T[initList.size()]), count(initList.size()), capacity(initList.size()) {
-        int i = 0;
+    SimpleVector(initializer_list<T> initList) : array(Storage::allocate(initList.size())), count(0), capacity(initList.size()) {
         for (const auto& value : initList) {
-            array[i++] = value;
+            new (array + count++) T(value);
         }
     }
     #endif
 
     ~SimpleVector() {
-        delete[] array;
+        releaseMemory();
     }
 
     // ... Other methods ...
@@ -93,7 +200,8 @@ public:
      * @public This method is public because it is meant to be called by the user.
     */
     void releaseMemory() {
-        delete[] array;
+        Storage::destroy(array, count);
+        Storage::deallocate(array);
         array = nullptr;
         capacity = 0;
         count = 0;
@@ -108,21 +216,19 @@ public:
     */
     bool shrinkToFit() {
         if (count < capacity) {
-            resize(count);
+            resize(count); // count == 0 frees the block
             return true;
         }
         return false;
     }
 
     /**
-    * @brief Clears the vector by setting all elements to their default value and resetting the count.
+    * @brief Clears the vector by destroying all elements and resetting the count. The capacity is kept.
     * 
     * @public This method is public because it is meant to be called by the user.
     */
     void clear() {
-        for (unsigned int i = 0; i < count; i++) {
-            array[i] = T(); // Set each element to its default value
-        }
+        Storage::destroy(array, count);
         count = 0; // Reset the count
     }
 
@@ -134,10 +240,11 @@ public:
      * 
     */
     void put(const T& item) {
-        if (count == capacity) {
-            resize(2 * capacity);
-        }
-        array[count++] = item;
+        emplace_back(item);
+    }
+
+    void put(T&& item) {
+        emplace_back(static_cast<T&&>(item));
     }
 
     template<typename... Args>
@@ -148,18 +255,28 @@ public:
         }
     }
 
-    void emplace_back() {  
-        ensureCapacity();
-        // Default-construct in place
-        new (elements + size()) T();
-        count++;
-    }
-
-    void emplace_back(const T& value) {
-        ensureCapacity();
-        // Copy-construct in place
-        new (elements + size()) T(value);
-        count++;
+    /**
+     * @brief Construct an element in place at the end of the vector
+     * @param args The arguments forwarded to the constructor of T
+     * @return Reference to the new element
+     *
+     * @note When the vector grows, the new element is constructed before the old elements are moved, so
+     *       args may refer to an element of this vector (v.emplace_back(v[0])).
+    */
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == capacity) {
+            unsigned int newCapacity = grownCapacity();
+            T* newArray = Storage::allocate(newCapacity);
+            new (newArray + count) T(static_cast<Args&&>(args)...);
+            Storage::relocate(newArray, array, count);
+            Storage::deallocate(array);
+            array = newArray;
+            capacity = newCapacity;
+        } else {
+            new (array + count) T(static_cast<Args&&>(args)...);
+        }
+        return array[count++];
     }
 
     //back() method
@@ -177,6 +294,10 @@ public:
         put(item);
     }
 
+    void push_back(T&& item) {
+        put(static_cast<T&&>(item));
+    }
+
     // Remove an element from the vector by shifting elements (Added in Version 1.0.1)
     /**
      * @brief Remove an element from the vector
@@ -191,11 +312,32 @@ public:
                 // Element found, skip it
                 continue;
             }
-            array[index++] = array[i];
+            if (index != i) {
+                array[index] = static_cast<T&&>(array[i]);
+            }
+            index++;
         }
+        Storage::destroy(array + index, count - index);
         count = index;
     }
 
+    /**
+     * @brief Remove the element at the specified index
+     * @param index The index of the element to be removed
+     *
+     * @note The elements after index are shifted to the left by one.
+    */
+    void erase(unsigned int index) {
+        if (index >= count) {
+            return;
+        }
+        for (unsigned int i = index + 1; i < count; i++) {
+            array[i - 1] = static_cast<T&&>(array[i]);
+        }
+        Storage::destroy(array + count - 1, 1);
+        count--;
+    }
+
     /**
      * Overloads the subscript operator for the SimpleVector class.
      * 
@@ -216,8 +358,9 @@ public:
 
     // Overload [] operator for const objects.
     const T& operator[](unsigned int index) const{
+        static T dummy;
         if (index >= count){
-            return nullptr; // You can handle this error differently if needed
+            return dummy; // Same out of bounds handling as the non-const overload
         }
         return array[index];
     }
@@ -252,10 +395,7 @@ public:
      * @return Reference to the element at the specified index
     */
     T& get(unsigned int index) {
-        if (index >= count) {
-            return nullptr; // You can handle this error differently if needed
-        }
-        return array[index];
+        return (*this)[index]; // Out of bounds returns the same dummy element as operator[]
     }
 
 
@@ -0,0 +1,335 @@
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <Arduino.h>
+#include <SimpleVector.h>
+
+/**
+ * @brief A SimpleVector that keeps its first N elements inside the object
+ *
+ * Up to N elements are stored in an inline buffer, so small vectors never touch the heap. Adding element N + 1
+ * moves everything to a heap block, after which it grows like SimpleVector. The interface matches SimpleVector,
+ * so a SmallVector<T, N> can replace a SimpleVector<T> that usually holds only a few elements.
+ *
+ * @note sizeof(SmallVector<T, N>) includes N * sizeof(T); keep N small for vectors that live in many nodes.
+*/
+template<typename T, unsigned int N>
+class SmallVector {
+private:
+    static_assert(N > 0, "SmallVector needs an inline capacity of at least 1");
+
+    typedef SimpleVectorStorage<T> Storage;
+
+    T* array;               // Points at inlineBuffer or at a heap block; the first count slots are constructed
+    unsigned int count;
+    unsigned int capacity;
+    alignas(T) unsigned char inlineBuffer[N * sizeof(T)];
+
+    T* inlineData() {
+        return reinterpret_cast<T*>(inlineBuffer);
+    }
+
+    /**
+     * @brief Move the elements into a new block of the specified capacity
+     * @param newCapacity The new capacity; N or less moves the elements back into the inline buffer
+     *
+     * @private This method is private because it is only used internally.
+    */
+    void resize(unsigned int newCapacity) {
+        T* newArray = newCapacity <= N ? inlineData() : Storage::allocate(newCapacity);
+        if (newArray == array) {
+            return;
+        }
+        Storage::relocate(newArray, array, count);
+        freeHeap();
+        array = newArray;
+        capacity = newCapacity <= N ? N : newCapacity;
+    }
+
+    void freeHeap() {
+        if (!isInline()) {
+            Storage::deallocate(array);
+        }
+    }
+
+    // Take other's elements, leaving it empty and inline.
+    void moveFrom(SmallVector& other) {
+        if (other.isInline()) {
+            array = inlineData();
+            capacity = N;
+            Storage::relocate(array, other.array, other.count);
+        } else {
+            array = other.array;
+            capacity = other.capacity;
+            other.array = other.inlineData();
+            other.capacity = N;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+
+    void copyFrom(const SmallVector& other) {
+        if (other.count > N) {
+            array = Storage::allocate(other.count);
+            capacity = other.count;
+        }
+        Storage::copyConstruct(array, other.array, other.count);
+        count = other.count;
+    }
+
+public:
+    typedef typename SimpleVector<T>::SimpleVectorIterator SimpleVectorIterator;
+    typedef SimpleVectorIterator iterator;
+
+    SmallVector() : array(inlineData()), count(0), capacity(N) {}
+
+    SmallVector(const SmallVector& other) : array(inlineData()), count(0), capacity(N) {
+        copyFrom(other);
+    }
+
+    SmallVector(SmallVector&& other) : array(inlineData()), count(0), capacity(N) {
+        moveFrom(other);
+    }
+
+    /**
+     * @brief Copy the elements of a SimpleVector
+     * @param other The vector to copy
+    */
+    explicit SmallVector(const SimpleVector<T>& other) : array(inlineData()), count(0), capacity(N) {
+        for (unsigned int i = 0; i < other.elements(); i++) {
+            put(other[i]);
+        }
+    }
+
+    #ifdef useInit
+    SmallVector(initializer_list<T> initList) : array(inlineData()), count(0), capacity(N) {
+        for (const auto& value : initList) {
+            put(value);
+        }
+    }
+    #endif
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            releaseMemory();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) {
+        if (this != &other) {
+            releaseMemory();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        releaseMemory();
+    }
+
+    /**
+     * @brief Check whether the elements are still stored inside the object
+     * @return True if no heap block is in use
+    */
+    bool isInline() const {
+        return array == reinterpret_cast<const T*>(inlineBuffer);
+    }
+
+    /**
+     * @brief Release the memory used by the vector
+     *
+     * @note The vector is empty and inline afterwards.
+    */
+    void releaseMemory() {
+        Storage::destroy(array, count);
+        freeHeap();
+        array = inlineData();
+        capacity = N;
+        count = 0;
+    }
+
+    /**
+     * @brief Shrink the capacity of the vector to match the count of elements
+     * @return True if the capacity changed, false otherwise
+     *
+     * @note Moves the elements back into the inline buffer when they fit.
+    */
+    bool shrinkToFit() {
+        if (isInline() || count == capacity) {
+            return false;
+        }
+        resize(count);
+        return true;
+    }
+
+    /**
+     * @brief Destroy all elements. The capacity is kept.
+    */
+    void clear() {
+        Storage::destroy(array, count);
+        count = 0;
+    }
+
+    /**
+     * @brief Add an element to the vector
+     * @param item The item to be added to the vector
+    */
+    void put(const T& item) {
+        emplace_back(item);
+    }
+
+    void put(T&& item) {
+        emplace_back(static_cast<T&&>(item));
+    }
+
+    template<typename... Args>
+    void bulkAdd(Args... args) {
+        const T temp[] = {args...};
+        for (auto& val : temp) {
+            put(val);
+        }
+    }
+
+    /**
+     * @brief Construct an element in place at the end of the vector
+     * @param args The arguments forwarded to the constructor of T
+     * @return Reference to the new element
+     *
+     * @note As in SimpleVector, args may refer to an element of this vector.
+    */
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == capacity) {
+            unsigned int newCapacity = 2 * capacity;
+            T* newArray = Storage::allocate(newCapacity);
+            new (newArray + count) T(static_cast<Args&&>(args)...);
+            Storage::relocate(newArray, array, count);
+            freeHeap();
+            array = newArray;
+            capacity = newCapacity;
+        } else {
+            new (array + count) T(static_cast<Args&&>(args)...);
+        }
+        return array[count++];
+    }
+
+    T& back() {
+        return array[count - 1];
+    }
+
+    void push_back(const T& item) {
+        put(item);
+    }
+
+    void push_back(T&& item) {
+        put(static_cast<T&&>(item));
+    }
+
+    /**
+     * @brief Remove every element equal to item
+     * @param item The item to be removed from the vector
+    */
+    void remove(const T& item) {
+        unsigned int index = 0;
+        for (unsigned int i = 0; i < count; i++) {
+            if (array[i] == item) {
+                continue;
+            }
+            if (index != i) {
+                array[index] = static_cast<T&&>(array[i]);
+            }
+            index++;
+        }
+        Storage::destroy(array + index, count - index);
+        count = index;
+    }
+
+    /**
+     * @brief Remove the element at the specified index
+     * @param index The index of the element to be removed
+    */
+    void erase(unsigned int index) {
+        if (index >= count) {
+            return;
+        }
+        for (unsigned int i = index + 1; i < count; i++) {
+            array[i - 1] = static_cast<T&&>(array[i]);
+        }
+        Storage::destroy(array + count - 1, 1);
+        count--;
+    }
+
+    // Out of bounds access returns a dummy element, as in SimpleVector.
+    T& operator[](unsigned int index) {
+        static T dummy;
+        if (index >= count) {
+            return dummy;
+        }
+        return array[index];
+    }
+
+    const T& operator[](unsigned int index) const {
+        static T dummy;
+        if (index >= count) {
+            return dummy;
+        }
+        return array[index];
+    }
+
+    /**
+     * @brief Get the capacity of the vector (at least N)
+     *
+     * @note Like SimpleVector::size(), this is the capacity, not the count of elements.
+    */
+    unsigned int size() const {
+        return capacity;
+    }
+
+    /**
+     * @brief Get the count of elements in the vector
+    */
+    unsigned int elements() const {
+        return count;
+    }
+
+    T& get(unsigned int index) {
+        return (*this)[index];
+    }
+
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    /**
+     * @brief Get the index of the specified element
+     * @return The index of the specified element, or 0 if the element is not found (as in SimpleVector)
+    */
+    int indexOf(const T& element) {
+        for (unsigned int i = 0; i < count; i++) {
+            if (array[i] == element) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    SimpleVectorIterator begin() {
+        return SimpleVectorIterator(array, array + count);
+    }
+
+    SimpleVectorIterator end() {
+        return SimpleVectorIterator(array + count, array + count);
+    }
+
+    const SimpleVectorIterator begin() const {
+        return SimpleVectorIterator(array, array + count);
+    }
+
+    const SimpleVectorIterator end() const {
+        return SimpleVectorIterator(array + count, array + count);
+    }
+};
+
+#endif // SMALLVECTOR_H
@@ -1,77 +1,325 @@
 #ifndef STACK_h
 #define STACK_h
 
+#include <Arduino.h>
+
+/**
+ * @brief Storage for a Stack: a fixed inline array of N elements, or (N == 0) a growable heap array
+ * @private
+*/
+template <class T, size_t N>
+class StackStorage {
+protected:
+    T stack[N]; // no heap use; lives wherever the Stack object lives (.bss, the call stack, another object)
+
+    StackStorage(size_t) {}
+
+    size_t storageCapacity() const {
+        return N;
+    }
+
+    bool grow(size_t, size_t) {
+        return false;
+    }
+};
+
 template <class T>
-class Stack {
-private:
-    int *stack;
-    int top;
-    int size;
-    void resize(){
-        int *newStack = new int[size * 2];
-        copy(newStack);
+class StackStorage<T, 0> {
+protected:
+    T* stack; // doubled when full
+    size_t size;
+
+    StackStorage(size_t initialCapacity) : size(initialCapacity ? initialCapacity : 1) {
+        stack = new T[size];
+    }
+
+    StackStorage(const StackStorage& other) : stack(new T[other.size]), size(other.size) {
+        for (size_t i = 0; i < size; i++) {
+            stack[i] = other.stack[i];
+        }
+    }
+
+    StackStorage& operator=(const StackStorage& other) {
+        if (this != &other) {
+            T* newStack = new T[other.size];
+            for (size_t i = 0; i < other.size; i++) {
+                newStack[i] = other.stack[i];
+            }
+            delete[] stack;
+            stack = newStack;
+            size = other.size;
+        }
+        return *this;
+    }
+
+    ~StackStorage() {
         delete[] stack;
-        stack = newStack;
-        size *= 2;
     }
-    void copy(int *newStack){
-        for(int i = 0; i <= top; i++){
+
+    size_t storageCapacity() const {
+        return size;
+    }
+
+    // Double the capacity until minCapacity elements fit, keeping the first used elements
+    bool grow(size_t used, size_t minCapacity) {
+        size_t newSize = size * 2;
+        while (newSize < minCapacity) {
+            newSize *= 2;
+        }
+        T* newStack = new T[newSize];
+        if (!newStack) {
+            return false;
+        }
+        for (size_t i = 0; i < used; i++) {
             newStack[i] = stack[i];
         }
+        delete[] stack;
+        stack = newStack;
+        size = newSize;
+        return true;
+    }
+};
+
+/**
+ * @brief A LIFO stack
+ *
+ * Stack<T> starts with 10 slots (or the size passed to the constructor) and doubles when full. Stack<T, N> keeps its
+ * N slots inside the object and never allocates; push() fails when it is full. The fixed form is meant for explicit
+ * traversal stacks on small parts: Stack<Node*, 32> costs 32 pointers wherever it is declared and nothing else.
+ *
+ * @tparam T The type of the elements
+ * @tparam N The fixed capacity, or 0 for a growable stack
+*/
+template <class T, size_t N = 0>
+class Stack : private StackStorage<T, N> {
+private:
+    typedef StackStorage<T, N> Storage;
+
+    size_t used; // number of elements; the top is stack[used - 1]
+
+    // Make room for extra more elements; a fixed stack only reports whether they fit.
+    bool reserve(size_t extra) {
+        if (extra <= Storage::storageCapacity() - used) {
+            return true;
+        }
+        return Storage::grow(used, used + extra);
     }
+
 public:
-    Stack(){
-        stack = new T[10];
-        top = -1;
-        size = 10;
+    /**
+     * @brief Construct a new Stack object
+     *
+     * @param initialCapacity - the starting capacity of a growable stack (ignored for Stack<T, N>)
+    */
+    Stack(size_t initialCapacity = 10) : Storage(initialCapacity), used(0) {}
+
+    /**
+     * @brief Push a value onto the top of the stack
+     *
+     * @param value - the value to push
+     * @return bool - false if a fixed capacity stack is full (or a growable one is out of memory)
+    */
+    bool push(const T& value) {
+        if (!reserve(1)) {
+            return false;
+        }
+        Storage::stack[used++] = value;
+        return true;
     }
 
-    ~Stack(){
-        delete[] stack;
+    /**
+     * @brief Push n values; values[n - 1] ends up on top
+     *
+     * A growable stack makes room for all of them at once. A fixed stack pushes nothing unless all of them fit, so a
+     * failed pushRange() leaves the stack unchanged.
+     *
+     * @param values - the values to push
+     * @param n - the number of values
+     * @return bool - true if all n values were pushed
+    */
+    bool pushRange(const T* values, size_t n) {
+        if (!reserve(n)) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            Storage::stack[used++] = values[i];
+        }
+        return true;
     }
-    void push(int value){
-        if(isFull()){
-            resize();
+
+    /**
+     * @brief Remove the value on top of the stack
+     *
+     * @param value - receives the removed value
+     * @return bool - false if the stack is empty
+    */
+    bool pop(T& value) {
+        if (isEmpty()) {
+            return false;
         }
-        stack[++top] = value;
+        value = Storage::stack[--used];
+        return true;
+    }
+
+    /**
+     * @brief Remove the value on top of the stack
+     *
+     * @return T - the removed value, or a default constructed T if the stack is empty
+    */
+    T pop() {
+        T value = T();
+        pop(value);
+        return value;
     }
 
-    int pop(){
-        if(isEmpty()){
-            return -1;
+    /**
+     * @brief Pop up to n values in pop order: out[0] is the old top
+     *
+     * @param out - receives the removed values
+     * @param n - the maximum number of values to remove
+     * @return size_t - the number of values removed
+    */
+    size_t popRange(T* out, size_t n) {
+        if (n > used) {
+            n = used;
         }
-        return stack[top--];
+        for (size_t i = 0; i < n; i++) {
+            out[i] = Storage::stack[--used];
+        }
+        return n;
     }
 
-    int peek(){
-        if(isEmpty()){
-            return -1;
+    /**
+     * @brief Get the value on top of the stack without removing it
+     *
+     * @return T - the top value, or a default constructed T if the stack is empty
+    */
+    T peek() const {
+        if (isEmpty()) {
+            return T();
         }
-        return stack[top];
+        return Storage::stack[used - 1];
     }
-    bool isEmpty(){
-        return top == -1;
-    
+
+    bool isEmpty() const {
+        return used == 0;
     }
-    bool isFull(){
-        return top == size - 1;
+
+    /**
+     * @brief Check if every slot is in use
+     *
+     * @return bool - true if the stack is full (a growable stack grows on the next push), false otherwise
+    */
+    bool isFull() const {
+        return used == Storage::storageCapacity();
     }
-    void print(){
-        for(int i = 0; i <= top; i++){
-            Serial.println(stack[i]);
+
+    /**
+     * @brief Print the elements, bottom first
+    */
+    void print() const {
+        for (size_t i = 0; i < used; i++) {
+            Serial.println(Storage::stack[i]);
         }
         Serial.println();
     }
 
-    uint16_t count (){
-        return top + 1;
+    size_t count() const {
+        return used;
+    }
+
+    size_t capacity() const {
+        return Storage::storageCapacity();
+    }
+
+    /**
+     * @brief Remove every element. The capacity is kept.
+    */
+    void clear() {
+        used = 0;
+    }
+};
+
+/**
+ * @brief A stack that keeps its first N elements inside the object and spills the rest to a growable Stack
+ *
+ * Meant for the explicit traversal stacks of trees with no depth bound: a walk of a shallow tree never allocates,
+ * and a degenerate one still completes as long as the heap can hold the part of the path past N.
+ *
+ * @tparam T The type of the elements
+ * @tparam N The number of elements kept inside the object
+*/
+template <class T, size_t N>
+class SpillStack {
+private:
+    Stack<T, N> inlineElements;
+    Stack<T>* spilled; // Elements above the first N, allocated on the first overflow
+
+    SpillStack(const SpillStack&);
+    SpillStack& operator=(const SpillStack&);
+
+public:
+    SpillStack() : spilled(nullptr) {}
+
+    ~SpillStack() {
+        delete spilled;
+    }
+
+    /**
+     * @brief Push a value onto the top of the stack
+     *
+     * @return bool - false only if the heap cannot hold a spilled element
+    */
+    bool push(const T& value) {
+        if ((spilled == nullptr || spilled->isEmpty()) && inlineElements.push(value)) {
+            return true;
+        }
+        if (spilled == nullptr) {
+            spilled = new Stack<T>(N > 0 ? N : 10);
+            if (spilled == nullptr) {
+                return false;
+            }
+        }
+        return spilled->push(value);
+    }
+
+    bool pop(T& value) {
+        if (spilled != nullptr && spilled->pop(value)) {
+            return true;
+        }
+        return inlineElements.pop(value);
+    }
+
+    T pop() {
+        T value = T();
+        pop(value);
+        return value;
+    }
+
+    T peek() const {
+        if (spilled != nullptr && !spilled->isEmpty()) {
+            return spilled->peek();
+        }
+        return inlineElements.peek();
+    }
+
+    bool isEmpty() const {
+        return inlineElements.isEmpty() && (spilled == nullptr || spilled->isEmpty());
+    }
+
+    size_t count() const {
+        return inlineElements.count() + (spilled != nullptr ? spilled->count() : 0);
     }
 
-    void clear(){
-        for(int i = 0; i <= top; i++){
-            stack[i] = 0;
+    /**
+     * @brief Remove every element. Spilled storage is kept for the next overflow.
+    */
+    void clear() {
+        inlineElements.clear();
+        if (spilled != nullptr) {
+            spilled->clear();
         }
     }
 };
 
-#endif // STACK_h
\ No newline at end of file
+#endif // STACK_h
@@ -2,13 +2,36 @@
 #define CUSTOM_STRING_H
 
 #include <MathLib.h>
-#include <stdarg.h> 
+#include <limits.h>
+
+/**
+ * @brief Formats into a char array or a Custom_String::String with the format STRing checked at compile time.
+ *
+ * The format STRing must be a literal. A specifier that does not match its argument's type, a missing argument or a
+ * surplus argument is reported by static_assert. For char arrays the worst-case length of the fixed-width arguments is
+ * checked against the array size as well; '%s' arguments are truncated at run time if they do not fit.
+ *
+ * Example: CS_FORMAT(line, "T=%.1f C, fan=%d", temperature, fanSpeed);
+ */
+#define CS_FORMAT(dest, fmt, ...) \
+    do { \
+        static_assert(Custom_String::Formatter::matches(fmt, decltype(Custom_String::Formatter::argList(__VA_ARGS__))()), \
+                      "CS_FORMAT: format string does not match the argument types"); \
+        static_assert(Custom_String::Formatter::Capacity<decltype(dest)>::value == 0 || \
+                      Custom_String::Formatter::fixedBound(fmt, decltype(Custom_String::Formatter::argList(__VA_ARGS__))()) < \
+                      Custom_String::Formatter::Capacity<decltype(dest)>::value, \
+                      "CS_FORMAT: destination buffer is too small for the formatted result"); \
+        Custom_String::Formatter::into(dest, fmt, ##__VA_ARGS__); \
+    } while (0)
+
 /**
  * Custom String class
  * Wrapped in a struct to avoid conflicts with the standard String class
  * 
 */
 struct Custom_String {
+    struct Formatter;
+
     class String {
     private:
         char* Buffer; // Pointer to dynamically allocated Buffer
@@ -93,27 +116,51 @@ struct Custom_String {
             return LEN;
         }
 
+        // The Formatter writes every number and text argument through FTOA, ITOA, UTOA and putText
+        friend struct Formatter;
+
         /**
          * @brief Converts a float to a string.
          *
-         * @param n The float to convert.
-         * @param res The buffer to store the resulting string. This buffer must be large enough to hold the string representation of the float, including the decimal point and null terminator.
-         * @param afterpoint The number of digits to include after the decimal point.
-         * @return The original float value.
+         * @param n The value to convert.
+         * @param res The buffer to store the resulting string. Characters that would go past end are dropped, and the null terminator is written at the returned position, so the caller owns at least (end - res + 1) bytes.
+         * @param end The end of the space for characters in res.
+         * @param afterpoint The number of digits to include after the decimal point. The last one is rounded.
+         * @return Pointer to the null terminator.
          *
-         * The function works by first converting the integer part of the float to a string, then adding a decimal point to the string, and finally converting the fractional part of the float to a string.
-         * The fractional part is first multiplied by 10^afterpoint to shift the decimal point to the right, then it's converted to an integer and that integer is converted to a string.
-        */
-        float FTOA(float n, char* res, int afterpoint) {
-            int ipart = (int)n;
-            float fpart = n - (float)ipart;
-            int i = ITOA(ipart, res, 10);
-            if (afterpoint != 0) {
-                res[i] = '.';
-                fpart = fpart * Pow(10, afterpoint);
-                ITOA((int)fpart, res + i + 1, 10);
+         * The function works by first converting the integer part of the float with UTOA, then adding a decimal point, and finally producing the fractional part one digit at a time by multiplying it by 10, so zeros right after the point are kept.
+         * NaN is written as "nan" and values an unsigned long cannot hold as "ovf", the same limit Print::printFloat uses.
+        */
+        static char* FTOA(double n, char* res, char* end, unsigned int afterpoint) {
+            if (n != n) {
+                return putText(res, end, "nan");
+            }
+            if (n < 0) {
+                if (res < end) *res++ = '-';
+                n = -n;
             }
-            return n;
+            if (n > 4294967040.0) {
+                return putText(res, end, "ovf");
+            }
+            double rounding = 0.5;
+            for (unsigned int i = 0; i < afterpoint; ++i) {
+                rounding /= 10.0;
+            }
+            n += rounding;
+            unsigned long ipart = (unsigned long)n;
+            double fpart = n - (double)ipart;
+            res = UTOA(ipart, res, end, 10);
+            if (afterpoint > 0 && res < end) {
+                *res++ = '.';
+            }
+            for (unsigned int i = 0; i < afterpoint && res < end; ++i) {
+                fpart *= 10.0;
+                unsigned int digit = (unsigned int)fpart;
+                *res++ = '0' + digit;
+                fpart -= digit;
+            }
+            *res = '\0';
+            return res;
         }
 
 
@@ -121,32 +168,51 @@ struct Custom_String {
          * Converts an integer to a string.
          *
          * @param value The integer to convert.
-         * @param STR The buffer to store the resulting string. This buffer must be large enough to hold the string representation of the integer, including the negative sign (if applicable) and null terminator.
+         * @param STR The buffer to store the resulting string. Characters that would go past end are dropped, and the null terminator is written at the returned position, so the caller owns at least (end - STR + 1) bytes.
+         * @param end The end of the space for characters in STR.
          * @param base The base to use for the conversion. This must be between 2 and 16. For base 10, digits are '0'-'9'. For bases 11-16, digits are 'a'-'f'.
-         * @return The length of the resulting string, not including the null terminator.
+         * @return Pointer to the null terminator.
+         *
+         * A negative value is written as a '-' followed by UTOA of its magnitude, which is computed as an unsigned long so the most negative long converts as well.
+         */
+        static char* ITOA(long value, char* STR, char* end, unsigned int base) {
+            if (value < 0) {
+                if (STR < end) *STR++ = '-';
+                return UTOA(0UL - (unsigned long)value, STR, end, base);
+            }
+            return UTOA((unsigned long)value, STR, end, base);
+        }
+
+        /**
+         * Converts an unsigned integer to a string.
          *
-         * The function works by repeatedly dividing the integer by the base and storing the remainder as a digit in the string. The digits are stored in reverse order, so the string is reversed at the end.
-         * If the integer is negative, a negative sign is added to the end of the string (which becomes the beginning after the string is reversed).
+         * @see ITOA
+         *
+         * The function works by repeatedly dividing the integer by the base and storing the remainder as a digit. The digits come out least significant first, so they are collected in a scratch buffer and copied forward, which keeps the leading digits when the result is cut off at end.
          */
-        int ITOA(int value, char* STR, int base) {
-            static char digits[] = "0123456789abcdef";
-            char* ptr = STR, *ptr1 = STR, tmp_char;
-            int tmp_value;
+        static char* UTOA(unsigned long value, char* STR, char* end, unsigned int base) {
+            static const char digits[] = "0123456789abcdef";
+            char scratch[sizeof(unsigned long) * CHAR_BIT]; // Enough digits for any base down to 2
+            unsigned int count = 0;
             do {
-                tmp_value = value;
+                scratch[count++] = digits[value % base];
                 value /= base;
-                *ptr++ = digits[ABS(tmp_value % base)];
             } while (value);
-            // Apply negative sign
-            if (tmp_value < 0) *ptr++ = '-';
-            *ptr-- = '\0';
-            while(ptr1 < ptr) {
-                tmp_char = *ptr;
-                *ptr--= *ptr1;
-                *ptr1++ = tmp_char;
+            while (count > 0 && STR < end) {
+                *STR++ = scratch[--count];
             }
-            return ptr - STR;
-        } 
+            *STR = '\0';
+            return STR;
+        }
+
+        // Copies text, dropping what would go past end, and null-terminates it like the conversions above
+        static char* putText(char* out, char* end, const char* text) {
+            while (*text != '\0' && out < end) {
+                *out++ = *text++;
+            }
+            *out = '\0';
+            return out;
+        }
 
         // Ensure the Buffer has enough capacity to store a STRing of the given length
         /**
@@ -257,7 +323,7 @@ struct Custom_String {
         */
         String(int value) : String() {
             char temp[12]; // 12 characters is enough for 32-bit integer
-            SPRINTF(temp, "%d", value);
+            Formatter::into(temp, "%d", value);
             Copy(temp);
         }
 
@@ -271,7 +337,7 @@ struct Custom_String {
         */
         String(float value) : String() {
             char temp[32]; // 32 characters is enough for 32-bit float
-            SPRINTF(temp, "%f", value);
+            Formatter::into(temp, "%f", value);
             Copy(temp);
         }
 
@@ -394,38 +460,15 @@ struct Custom_String {
          * A simplified implementation of the sprintf function.
          *
          * @param STR The buffer to store the resulting formatted string. This buffer must be large enough to hold the formatted string, including the null terminator.
-         * @param Format The format string. It can contain literal characters and format specifiers. Currently, only '%d' (for integers) and '%f' (for floats) are supported.
-         * @param ... The values to format according to the format string.
+         * @param Format The format string. It can contain literal characters and format specifiers. Supported specifiers are '%d', '%i', '%u', '%x', '%c', '%s', '%f' and '%.Nf'.
+         * @param args The values to format according to the format string.
          *
-         * This function works by iterating over the format string. When it encounters a literal character, it copies it to the output string. 
-         * When it encounters a format specifier, it retrieves the next argument from the argument list and formats it according to the specifier, 
-         * then appends the formatted value to the output string. 
-         * The formatted value is converted to a string using the ITOA function for integers and the FTOA function for floats.
+         * The arguments are forwarded to Custom_String::Formatter, so every value is converted according to its real type instead of being pulled out of a va_list.
+         * The buffer is assumed to hold Formatter::sizeBound() characters plus the null terminator; use CS_FORMAT to have that checked at compile time.
          */
-        void SPRINTF(char* STR, const char* Format, ...) {
-            va_list args;
-            va_start(args, Format);
-
-            while (*Format != '\0') {
-                if (*Format == '%') {
-                    Format++;
-                    if (*Format == 'd') {
-                        int i = va_arg(args, int);
-                        ITOA(i, STR, 10);
-                        while (*STR != '\0') STR++;
-                    } else if (*Format == 'f') {
-                        float f = (float)va_arg(args, double);
-                        FTOA(f, STR, 2);  // 2 decimal places
-                        while (*STR != '\0') STR++;
-                    }
-                } else {
-                    *STR = *Format;
-                    STR++;
-                }
-                Format++;
-            }
-            *STR = '\0';
-            va_end(args);
+        template <typename... Args>
+        void SPRINTF(char* STR, const char* Format, const Args&... args) {
+            Formatter::write(STR, STR + Formatter::sizeBound(Format, args...), Format, args...);
         }
 
 
@@ -464,7 +507,7 @@ struct Custom_String {
         */
         String& operator=(int value) {
             char temp[12]; // 12 characters is enough for 32-bit integer
-            SPRINTF(temp, "%d", value);
+            Formatter::into(temp, "%d", value);
             *this = temp;
             return *this;
         }
@@ -478,7 +521,7 @@ struct Custom_String {
         */
         String& operator=(float value) {
             char temp[32]; // 32 characters is enough for 32-bit float
-            SPRINTF(temp, "%f", value);
+            Formatter::into(temp, "%f", value);
             *this = temp;
             return *this;
         }
@@ -492,8 +535,9 @@ struct Custom_String {
          * @param c - The character to append
         */
         void append(char c) {
-            Reallocate(Length + 2); // +1 for the new character, +1 for null terminator
-            Buffer[Length++] = c;
+            unsigned int oldLength = Length;
+            Reallocate(oldLength + 2); // +1 for the new character, +1 for null terminator (Length becomes oldLength + 1)
+            Buffer[oldLength] = c;
         }
 
         // Append a C-STRing to the STRing
@@ -504,11 +548,10 @@ struct Custom_String {
         */
         void append(const char* STR) {
             if (STR) {
-                unsigned int newLength = Length + STR_LEN(STR);
-                Reallocate(newLength + 1); // +1 for null terminator
-                for (unsigned int i = 0; i < STR_LEN(STR); ++i) {
-                    Buffer[Length++] = STR[i];
-                }
+                unsigned int oldLength = Length;
+                unsigned int strLength = STR_LEN(STR);
+                Reallocate(oldLength + strLength + 1); // +1 for null terminator (Length becomes the new length)
+                memcpy(Buffer + oldLength, STR, strLength);
             }
         }
 
@@ -674,49 +717,25 @@ struct Custom_String {
             return value * sign;
         }
 
-        // Format STRing (basic implementation)
+        // Format STRing
         /**
-         * @brief Format STRing (basic implementation)
+         * @brief Format STRing
+         * 
+         * @param fmt - The format STRing (see SPRINTF for the supported specifiers)
+         * @param args - The values to format
          * 
-         * @param fmt - The format STRing
+         * The Buffer is sized once from Formatter::sizeBound() and the result is written straight into it,
+         * so formatting costs one allocation no matter how many specifiers the format STRing contains.
         */
-        void Format(const char* fmt, ...) {
-            va_list args;
-            va_start(args, fmt);
-
-            // Clear the current STRing
-            Reallocate(1);
-            Buffer[0] = '\0';
-            Length = 0;
-
-            // Process the Format STRing
-            while (*fmt) {
-                if (*fmt == '%') {
-                    fmt++;
-                    if (*fmt == 's') {
-                        // Handle STRing argument
-                        const char* STR = va_arg(args, const char*);
-                        while (*STR) {
-                            append(*STR++);
-                        }
-                    } else if (*fmt == 'd') {
-                        // Handle integer argument
-                        int value = va_arg(args, int);
-                        char STR[12];  // Buffer for integer STRing representation
-                        ITOA(value, STR, 10);
-                        char* p = STR;
-                        while (*p) {
-                            append(*p++);
-                        }
-                    }
-                } else {
-                    // Handle normal character
-                    append(*fmt);
-                }
-                fmt++;
-            }
-
-            va_end(args);
+        template <typename... Args>
+        void Format(const char* fmt, const Args&... args) {
+            unsigned int bound = Formatter::sizeBound(fmt, args...);
+            char* newBuffer = new char[bound + 1];
+            // Write before releasing the old Buffer so the STRing may be passed as one of its own arguments
+            Length = Formatter::write(newBuffer, newBuffer + bound, fmt, args...) - newBuffer;
+            delete[] Buffer;
+            Buffer = newBuffer;
+            capacity = bound + 1;
         }
 
        
@@ -736,10 +755,8 @@ struct Custom_String {
                 end = Length - 1;
             }
             String result;
-            result.Reallocate(end - start + 2);
-            for (unsigned int i = start; i <= end; ++i) {
-                result.append(Buffer[i]);
-            }
+            result.Reallocate(end - start + 2); // Length becomes end - start + 1
+            memcpy(result.Buffer, Buffer + start, end - start + 1);
             return result;
         }
 
@@ -1099,6 +1116,271 @@ struct Custom_String {
 
 
     };
+
+    /**
+     * @brief Type-safe formatter behind String::Format, String::SPRINTF and CS_FORMAT.
+     *
+     * Arguments are passed as a variadic template pack instead of a va_list, so each value is converted by its real type.
+     * The constexpr helpers (matches, fixedBound) let CS_FORMAT validate a literal format STRing while compiling, and
+     * sizeBound gives the worst-case output length so callers can size their Buffer once before writing into it.
+     *
+     * Supported specifiers: %d %i (integers), %u %x (integers, unsigned/hex), %c (char), %s (text), %f and %.Nf (floating point), %%.
+     */
+    struct Formatter {
+        enum ArgKind { KIND_NONE, KIND_SIGNED, KIND_UNSIGNED, KIND_FLOAT, KIND_CHAR, KIND_TEXT };
+
+        static const unsigned int DEFAULT_PRECISION = 2; // Same number of decimals SPRINTF has always produced for '%f'
+
+        template <typename... Args> struct Arg_List {};
+        template <typename T> struct Tag {};
+        template <int K> struct Kind {};
+
+        // Capacity of a destination, 0 for destinations that grow (Custom_String::String)
+        template <typename T> struct Capacity { static const size_t value = 0; };
+        template <size_t N> struct Capacity<char[N]> { static const size_t value = N; };
+        template <size_t N> struct Capacity<char (&)[N]> { static const size_t value = N; };
+
+        // Only used inside decltype() to turn a macro argument list into an Arg_List type
+        template <typename... Args>
+        static Arg_List<Args...> argList(const Args&...);
+
+        // Argument classification
+        static constexpr int kindOf(Tag<signed char>) { return KIND_SIGNED; }
+        static constexpr int kindOf(Tag<short>) { return KIND_SIGNED; }
+        static constexpr int kindOf(Tag<int>) { return KIND_SIGNED; }
+        static constexpr int kindOf(Tag<long>) { return KIND_SIGNED; }
+        static constexpr int kindOf(Tag<bool>) { return KIND_SIGNED; }
+        static constexpr int kindOf(Tag<unsigned char>) { return KIND_UNSIGNED; }
+        static constexpr int kindOf(Tag<unsigned short>) { return KIND_UNSIGNED; }
+        static constexpr int kindOf(Tag<unsigned int>) { return KIND_UNSIGNED; }
+        static constexpr int kindOf(Tag<unsigned long>) { return KIND_UNSIGNED; }
+        static constexpr int kindOf(Tag<float>) { return KIND_FLOAT; }
+        static constexpr int kindOf(Tag<double>) { return KIND_FLOAT; }
+        static constexpr int kindOf(Tag<char>) { return KIND_CHAR; }
+        static constexpr int kindOf(Tag<char*>) { return KIND_TEXT; }
+        static constexpr int kindOf(Tag<const char*>) { return KIND_TEXT; }
+        static constexpr int kindOf(Tag<String>) { return KIND_TEXT; }
+        template <size_t N> static constexpr int kindOf(Tag<char[N]>) { return KIND_TEXT; }
+        template <typename T> static constexpr int kindOf(Tag<T>) { return KIND_NONE; }
+
+        // Decimal digits of the largest size-byte value; 28/93 is just above log10(2). Hex needs only 2 * size.
+        static constexpr unsigned int digitsOf(unsigned int size) {
+            return size * CHAR_BIT * 28 / 93 + 1;
+        }
+
+        // Worst-case characters for a fixed-width argument (sign included), 0 for text. A char may be printed with %d.
+        static constexpr unsigned int widthOf(int kind, unsigned int size, unsigned int precision) {
+            return kind == KIND_FLOAT ? 11 + 1 + precision // sign + 10 integer digits, '.', decimals
+                 : kind == KIND_SIGNED || kind == KIND_UNSIGNED || kind == KIND_CHAR ? 1 + digitsOf(size)
+                 : 0;
+        }
+
+        // Format STRing scanning, f points at a '%'. A precision may have any number of digits ("%.10f").
+        static constexpr unsigned int digitCount(const char* f) {
+            return *f >= '0' && *f <= '9' ? 1 + digitCount(f + 1) : 0;
+        }
+        static constexpr unsigned int numberAt(const char* f, unsigned int value) {
+            return *f >= '0' && *f <= '9' ? numberAt(f + 1, value * 10 + (unsigned int)(*f - '0')) : value;
+        }
+        static constexpr const char* specCharAt(const char* f) {
+            return f[1] == '.' ? f + 2 + digitCount(f + 2) : f + 1;
+        }
+        static constexpr char specChar(const char* f) {
+            return *specCharAt(f);
+        }
+        // Stops at a terminator, so a '%' at the very end of a run-time format is not read past
+        static constexpr unsigned int specLength(const char* f) {
+            return (unsigned int)(specCharAt(f) - f) + (specChar(f) != '\0' ? 1 : 0);
+        }
+        static constexpr unsigned int specPrecision(const char* f) {
+            return f[1] == '.' && digitCount(f + 2) > 0 ? numberAt(f + 2, 0) : DEFAULT_PRECISION;
+        }
+        static constexpr bool specWellFormed(const char* f) {
+            return f[1] != '.' || (digitCount(f + 2) > 0 && specChar(f) == 'f');
+        }
+        static constexpr bool accepts(char spec, int kind) {
+            return spec == 'd' || spec == 'i' || spec == 'u' || spec == 'x'
+                       ? (kind == KIND_SIGNED || kind == KIND_UNSIGNED || kind == KIND_CHAR)
+                 : spec == 'f' ? kind == KIND_FLOAT
+                 : spec == 'c' ? kind == KIND_CHAR
+                 : spec == 's' ? kind == KIND_TEXT
+                 : false;
+        }
+
+        /**
+         * @brief Checks at compile time that every specifier in fmt has a matching argument and vice versa.
+         */
+        static constexpr bool matches(const char* f, Arg_List<>) {
+            return *f == '\0' ? true
+                 : *f != '%' ? matches(f + 1, Arg_List<>())
+                 : f[1] == '%' ? matches(f + 2, Arg_List<>())
+                 : false; // Specifier without an argument
+        }
+        template <typename First, typename... Rest>
+        static constexpr bool matches(const char* f, Arg_List<First, Rest...>) {
+            return *f == '\0' ? false // More arguments than specifiers
+                 : *f != '%' ? matches(f + 1, Arg_List<First, Rest...>())
+                 : f[1] == '%' ? matches(f + 2, Arg_List<First, Rest...>())
+                 : specWellFormed(f) && accepts(specChar(f), kindOf(Tag<First>())) &&
+                   matches(f + specLength(f), Arg_List<Rest...>());
+        }
+
+        /**
+         * @brief Worst-case output length of fmt, counting literal characters and fixed-width arguments only.
+         */
+        static constexpr unsigned int fixedBound(const char* f, Arg_List<>) {
+            return *f == '\0' ? 0
+                 : *f == '%' && f[1] == '%' ? 1 + fixedBound(f + 2, Arg_List<>())
+                 : 1 + fixedBound(f + 1, Arg_List<>());
+        }
+        template <typename First, typename... Rest>
+        static constexpr unsigned int fixedBound(const char* f, Arg_List<First, Rest...>) {
+            return *f == '\0' ? 0
+                 : *f != '%' ? 1 + fixedBound(f + 1, Arg_List<First, Rest...>())
+                 : f[1] == '%' ? 1 + fixedBound(f + 2, Arg_List<First, Rest...>())
+                 : widthOf(kindOf(Tag<First>()), sizeof(First), specPrecision(f)) +
+                   fixedBound(f + specLength(f), Arg_List<Rest...>());
+        }
+
+        /**
+         * @brief Worst-case output length of fmt for the given arguments, not including the null terminator.
+         *
+         * Walks fmt the way write() does: literal runs count their length, each specifier its widest expansion at
+         * its own precision, and text arguments their actual length.
+         */
+        static unsigned int sizeBound(const char* fmt) {
+            return strlen(fmt);
+        }
+        template <typename First, typename... Rest>
+        static unsigned int sizeBound(const char* fmt, const First& first, const Rest&... rest) {
+            unsigned int literal = 0;
+            for (; *fmt != '\0'; fmt++, literal++) {
+                if (*fmt == '%') {
+                    if (fmt[1] != '%') {
+                        return literal + argWidth(first, specPrecision(fmt), Kind<kindOf(Tag<First>())>()) +
+                               sizeBound(fmt + specLength(fmt), rest...);
+                    }
+                    fmt++;
+                }
+            }
+            return literal;
+        }
+
+        /**
+         * @brief Formats into a fixed-size char array, truncating if the result does not fit.
+         *
+         * @return unsigned int - The number of characters written, not including the null terminator.
+        */
+        template <size_t N, typename... Args>
+        static unsigned int into(char (&dest)[N], const char* fmt, const Args&... args) {
+            return write(dest, dest + N - 1, fmt, args...) - dest;
+        }
+
+        /**
+         * @brief Formats into a Custom_String::String, replacing its contents.
+         *
+         * @return unsigned int - The length of the resulting STRing.
+        */
+        template <typename... Args>
+        static unsigned int into(String& dest, const char* fmt, const Args&... args) {
+            dest.Format(fmt, args...);
+            return dest.size();
+        }
+
+        /**
+         * @brief Writes the formatted result into [out, end) and null-terminates it at the returned position.
+         *
+         * end must leave room for the terminator, i.e. the caller owns at least (end - out + 1) bytes.
+         * Each argument is converted by its own type; a specifier only selects the base or the precision.
+         *
+         * @return char* - Pointer to the null terminator.
+        */
+        static char* write(char* out, char* end, const char* fmt) {
+            while (*fmt != '\0' && out < end) {
+                if (*fmt == '%' && fmt[1] == '%') {
+                    fmt++;
+                }
+                *out++ = *fmt++;
+            }
+            *out = '\0';
+            return out;
+        }
+        template <typename First, typename... Rest>
+        static char* write(char* out, char* end, const char* fmt, const First& first, const Rest&... rest) {
+            while (*fmt != '\0' && out < end) {
+                if (*fmt == '%') {
+                    if (fmt[1] == '%') {
+                        fmt++;
+                    } else {
+                        out = putArg(out, end, specChar(fmt), specPrecision(fmt), first, Kind<kindOf(Tag<First>())>());
+                        return write(out, end, fmt + specLength(fmt), rest...);
+                    }
+                }
+                *out++ = *fmt++;
+            }
+            *out = '\0';
+            return out;
+        }
+
+    private:
+        template <typename T>
+        static unsigned int argWidth(const T&, unsigned int, Kind<KIND_NONE>) {
+            static_assert(sizeof(T) == 0, "Custom_String::Formatter: unsupported argument type");
+            return 0;
+        }
+        template <typename T, int K>
+        static unsigned int argWidth(const T&, unsigned int precision, Kind<K>) {
+            return widthOf(K, sizeof(T), precision);
+        }
+        template <typename T>
+        static unsigned int argWidth(const T& value, unsigned int, Kind<KIND_TEXT>) {
+            return strlen(textOf(value));
+        }
+
+        static const char* textOf(const char* value) { return value ? value : ""; }
+        static const char* textOf(const String& value) { return value.C_STR(); }
+
+        // Two's complement bits of a size-byte value, so %x of a negative int prints its own width, not a long's
+        static constexpr unsigned long maskOf(unsigned int size) {
+            return size >= sizeof(unsigned long) ? ~0UL : (1UL << (size * CHAR_BIT)) - 1;
+        }
+
+        template <typename T>
+        static char* putArg(char* out, char* end, char spec, unsigned int, const T& value, Kind<KIND_SIGNED>) {
+            if (spec == 'x') {
+                return String::UTOA((unsigned long)value & maskOf(sizeof(T)), out, end, 16);
+            }
+            return String::ITOA((long)value, out, end, 10);
+        }
+        template <typename T>
+        static char* putArg(char* out, char* end, char spec, unsigned int, const T& value, Kind<KIND_UNSIGNED>) {
+            return String::UTOA((unsigned long)value, out, end, spec == 'x' ? 16 : 10);
+        }
+        template <typename T>
+        static char* putArg(char* out, char* end, char, unsigned int precision, const T& value, Kind<KIND_FLOAT>) {
+            return String::FTOA((double)value, out, end, precision);
+        }
+        template <typename T>
+        static char* putArg(char* out, char* end, char spec, unsigned int, const T& value, Kind<KIND_CHAR>) {
+            if (spec == 'c') {
+                if (out < end) *out++ = value;
+                return out;
+            }
+            if (spec == 'x') {
+                return String::UTOA((unsigned long)value & maskOf(sizeof(T)), out, end, 16);
+            }
+            return String::ITOA((long)value, out, end, 10);
+        }
+        template <typename T>
+        static char* putArg(char* out, char* end, char, unsigned int, const T& value, Kind<KIND_TEXT>) {
+            return String::putText(out, end, textOf(value));
+        }
+        template <typename T>
+        static char* putArg(char* out, char* end, char, unsigned int, const T&, Kind<KIND_NONE>) {
+            static_assert(sizeof(T) == 0, "Custom_String::Formatter: unsupported argument type");
+            return out;
+        }
+    };
     
 };
 
@@ -0,0 +1,45 @@
+/*
+    Example Name: Example For StringPool Library
+
+    Basic example for the StringPool library. This example demonstrates interning strings and comparing them by Id.
+
+    The circuit:
+    This Library does not Require any Circuits to run.
+
+    Created  month day year   // 10/18/2026
+    By author's name braydenanderson2014 (Brayden Anderson)
+    Modified day month year  // 10/18/2026
+    By author's name  braydenanderson2014 (Brayden Anderson)
+
+    https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
+
+*/
+#include <StringPool.h>
+
+StringPool pool; // A private pool; InternedString uses StringPool::shared()
+
+void setup()
+{
+    Serial.begin(9600); // initialize serial communication at 9600 bits per second
+
+    StringPool::Id red = pool.intern("red");     // Adds "red" and returns its Id
+    StringPool::Id green = pool.intern("green"); // Adds "green"
+    StringPool::Id again = pool.intern("red");   // Already there, returns the same Id
+
+    Serial.println(red == again);                // 1
+    Serial.println(red == green);                // 0
+    Serial.println(pool.c_str(green));           // green
+    Serial.println(pool.length(green));          // 5
+    Serial.println(pool.count());                // 2 distinct strings
+    Serial.println(pool.find("blue") == StringPool::NONE); // 1, find() does not add
+
+    InternedString a = "mode";                   // Interned in the shared pool
+    InternedString b = String("mode");
+    Serial.println(a == b);                      // 1, compares two Ids
+    Serial.println(a.c_str());                   // mode
+}
+
+void loop()
+{
+    // Nothing to do here
+}
@@ -0,0 +1,386 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <Arduino.h>
+
+/**
+ * @brief A pool of interned strings.
+ *
+ * Every distinct string is stored once, back to back and null-terminated, in one contiguous byte store and is
+ * identified by a stable 16-bit Id. Containers can hold the Id instead of a String: two keys are equal exactly when
+ * their Ids are equal, so comparing them is an integer compare.
+ *
+ * @note Strings are never removed individually; clear() drops all of them and invalidates every Id.
+ * @note Pointers returned by c_str() stay valid until the next intern() call that has to grow the byte store.
+*/
+class StringPool {
+public:
+    typedef uint16_t Id;
+
+    static const Id NONE = 0xFFFF; // Returned when a string is not in the pool (or the pool is full)
+
+    /**
+     * @brief Constructor
+     * @param initialBytes Initial size of the byte store
+     * @param initialStrings Initial number of strings before the tables grow
+    */
+    StringPool(unsigned int initialBytes = 64, unsigned int initialStrings = 8)
+        : bytes(nullptr), used(0), byteCapacity(0), offsets(nullptr), stringCount(0), offsetCapacity(0), slots(nullptr), slotMask(0) {
+        reserve(initialBytes, initialStrings);
+    }
+
+    /**
+     * @brief Copy constructor; the copy has the same strings under the same Ids
+    */
+    StringPool(const StringPool& other)
+        : bytes(nullptr), used(0), byteCapacity(0), offsets(nullptr), stringCount(0), offsetCapacity(0), slots(nullptr), slotMask(0) {
+        copyFrom(other);
+    }
+
+    StringPool& operator=(const StringPool& other) {
+        if (this != &other) {
+            release();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destructor
+    */
+    ~StringPool() {
+        release();
+    }
+
+    /**
+     * @brief Returns the pool shared by every InternedString; it lives for the whole program and is never cleared
+    */
+    static StringPool& shared() {
+        static StringPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Adds a string to the pool if it is not there yet
+     * @param text The characters to intern
+     * @param length The number of characters
+     * @return The Id of the string, or NONE if the pool is out of memory or Ids
+    */
+    Id intern(const char* text, unsigned int length) {
+        if (!slots) {
+            return NONE;
+        }
+        uint32_t h = hash(text, length);
+        unsigned int slot = h & slotMask;
+        while (slots[slot] != NONE) {
+            if (matches(slots[slot], text, length)) {
+                return slots[slot];
+            }
+            slot = (slot + 1) & slotMask;
+        }
+        if ((unsigned long)stringCount + 1 >= NONE || (unsigned long)used + length + 1 > 0xFFFFu) {
+            return NONE;
+        }
+        if (used + length + 1 > byteCapacity && !growBytes(used + length + 1)) {
+            return NONE;
+        }
+        if (stringCount == offsetCapacity && !growOffsets()) {
+            return NONE;
+        }
+        // Keep the slot table at most half full, so a probe always reaches an empty slot. The table grows before the
+        // string is added: if it cannot, the string is refused rather than letting the table fill up.
+        if (((unsigned long)stringCount + 1) * 2 > (unsigned long)slotMask + 1) {
+            if (!rehash(((unsigned long)slotMask + 1) * 2)) {
+                return NONE;
+            }
+            slot = h & slotMask;
+            while (slots[slot] != NONE) {
+                slot = (slot + 1) & slotMask;
+            }
+        }
+        Id id = stringCount++;
+        offsets[id] = used;
+        memcpy(bytes + used, text, length);
+        bytes[used + length] = '\0';
+        used += length + 1;
+
+        slots[slot] = id;
+        return id;
+    }
+
+    Id intern(const char* text) {
+        return intern(text, strlen(text));
+    }
+
+    Id intern(const String& text) {
+        return intern(text.c_str(), text.length());
+    }
+
+    /**
+     * @brief Looks a string up without adding it
+     * @return The Id of the string, or NONE if it has not been interned
+    */
+    Id find(const char* text, unsigned int length) const {
+        if (!slots) {
+            return NONE;
+        }
+        unsigned int slot = hash(text, length) & slotMask;
+        while (slots[slot] != NONE) {
+            if (matches(slots[slot], text, length)) {
+                return slots[slot];
+            }
+            slot = (slot + 1) & slotMask;
+        }
+        return NONE;
+    }
+
+    Id find(const char* text) const {
+        return find(text, strlen(text));
+    }
+
+    /**
+     * @brief Returns the characters of an interned string, or "" for NONE
+    */
+    const char* c_str(Id id) const {
+        if (id >= stringCount) {
+            return "";
+        }
+        return bytes + offsets[id];
+    }
+
+    /**
+     * @brief Returns the length of an interned string without scanning it
+    */
+    unsigned int length(Id id) const {
+        if (id >= stringCount) {
+            return 0;
+        }
+        unsigned int end = (unsigned int)id + 1 < stringCount ? offsets[id + 1] : used;
+        return end - offsets[id] - 1;
+    }
+
+    /**
+     * @brief Returns the number of interned strings
+    */
+    unsigned int count() const {
+        return stringCount;
+    }
+
+    /**
+     * @brief Returns the bytes held by the pool (byte store and both tables)
+    */
+    unsigned int bytesUsed() const {
+        return byteCapacity + offsetCapacity * sizeof(uint16_t) + ((unsigned int)slotMask + 1) * sizeof(Id);
+    }
+
+    /**
+     * @brief Drops every string. All previously returned Ids become invalid.
+    */
+    void clear() {
+        used = 0;
+        stringCount = 0;
+        for (unsigned long i = 0; slots && i <= slotMask; i++) {
+            slots[i] = NONE;
+        }
+    }
+
+private:
+    char* bytes;             // Contiguous null-terminated strings
+    uint16_t used;           // Bytes of the store in use
+    uint16_t byteCapacity;   // Allocated size of the store
+    uint16_t* offsets;       // Start of each string in the store, indexed by Id
+    Id stringCount;
+    Id offsetCapacity;
+    Id* slots;               // Open-addressing hash table of Ids, NONE marks an empty slot
+    uint16_t slotMask;       // Slot count - 1 (the slot count is a power of two)
+
+    // FNV-1a
+    static uint32_t hash(const char* text, unsigned int length) {
+        uint32_t h = 2166136261UL;
+        for (unsigned int i = 0; i < length; i++) {
+            h = (h ^ (unsigned char)text[i]) * 16777619UL;
+        }
+        return h;
+    }
+
+    bool matches(Id id, const char* text, unsigned int length) const {
+        return this->length(id) == length && memcmp(bytes + offsets[id], text, length) == 0;
+    }
+
+    void reserve(unsigned int initialBytes, unsigned int initialStrings) {
+        bytes = new char[initialBytes];
+        byteCapacity = bytes ? initialBytes : 0;
+        offsets = new uint16_t[initialStrings];
+        offsetCapacity = offsets ? initialStrings : 0;
+        unsigned long slotCount = 4;
+        while (slotCount < (unsigned long)initialStrings * 2) {
+            slotCount <<= 1;
+        }
+        rehash(slotCount); // On failure slots stays nullptr and intern() returns NONE
+    }
+
+    // Copies the arrays as they are, so every Id keeps its string and its slot. Left empty if memory runs out.
+    void copyFrom(const StringPool& other) {
+        bytes = new char[other.byteCapacity];
+        offsets = new uint16_t[other.offsetCapacity];
+        slots = new Id[(unsigned long)other.slotMask + 1];
+        if (!bytes || !offsets || !slots || !other.slots) {
+            release();
+            return;
+        }
+        memcpy(bytes, other.bytes, other.used);
+        memcpy(offsets, other.offsets, other.stringCount * sizeof(uint16_t));
+        memcpy(slots, other.slots, ((unsigned long)other.slotMask + 1) * sizeof(Id));
+        used = other.used;
+        byteCapacity = other.byteCapacity;
+        stringCount = other.stringCount;
+        offsetCapacity = other.offsetCapacity;
+        slotMask = other.slotMask;
+    }
+
+    void release() {
+        delete[] bytes;
+        delete[] offsets;
+        delete[] slots;
+        bytes = nullptr;
+        offsets = nullptr;
+        slots = nullptr;
+        used = 0;
+        byteCapacity = 0;
+        stringCount = 0;
+        offsetCapacity = 0;
+        slotMask = 0;
+    }
+
+    bool growBytes(unsigned int needed) {
+        unsigned long newCapacity = byteCapacity ? (unsigned long)byteCapacity * 2 : 16;
+        while (newCapacity < needed) {
+            newCapacity *= 2;
+        }
+        if (newCapacity > 0xFFFFu) {
+            newCapacity = 0xFFFFu;
+        }
+        char* newBytes = new char[newCapacity];
+        if (!newBytes) {
+            return false;
+        }
+        memcpy(newBytes, bytes, used);
+        delete[] bytes;
+        bytes = newBytes;
+        byteCapacity = newCapacity;
+        return true;
+    }
+
+    bool growOffsets() {
+        unsigned long newCapacity = offsetCapacity ? (unsigned long)offsetCapacity * 2 : 8;
+        if (newCapacity > NONE) {
+            newCapacity = NONE;
+        }
+        uint16_t* newOffsets = new uint16_t[newCapacity];
+        if (!newOffsets) {
+            return false;
+        }
+        memcpy(newOffsets, offsets, stringCount * sizeof(uint16_t));
+        delete[] offsets;
+        offsets = newOffsets;
+        offsetCapacity = newCapacity;
+        return true;
+    }
+
+    // Rebuilds the slot table from the byte store; the Ids themselves never change.
+    // Returns false, keeping the old table, if the slot count is past what slotMask holds or memory runs out.
+    bool rehash(unsigned long slotCount) {
+        if (slotCount - 1 > 0xFFFFu) {
+            return false;
+        }
+        Id* newSlots = new Id[slotCount];
+        if (!newSlots) {
+            return false;
+        }
+        for (unsigned long i = 0; i < slotCount; i++) {
+            newSlots[i] = NONE;
+        }
+        for (Id id = 0; id < stringCount; id++) {
+            unsigned int slot = hash(bytes + offsets[id], length(id)) & (slotCount - 1);
+            while (newSlots[slot] != NONE) {
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            newSlots[slot] = id;
+        }
+        delete[] slots;
+        slots = newSlots;
+        slotMask = slotCount - 1;
+        return true;
+    }
+};
+
+/**
+ * @brief A string key stored as a StringPool::Id in the shared pool.
+ *
+ * Two bytes per key, and operator== is an integer compare. Constructing one from text interns the text, so use
+ * it for keys fixed by the program (setting names, command words). The shared pool is never emptied, so keys read
+ * from files or typed by a user belong in a StringPool that their owner can clear().
+*/
+class InternedString {
+public:
+    InternedString() : id(StringPool::NONE) {}
+
+    InternedString(const char* text) : id(StringPool::shared().intern(text)) {}
+
+    InternedString(const String& text) : id(StringPool::shared().intern(text)) {}
+
+    /**
+     * @brief Looks a key up without interning it
+     * @return The interned key, or an InternedString that matches nothing if the text was never interned
+    */
+    static InternedString lookup(const String& text) {
+        return fromId(StringPool::shared().find(text.c_str(), text.length()));
+    }
+
+    static InternedString lookup(const char* text) {
+        return fromId(StringPool::shared().find(text));
+    }
+
+    /**
+     * @brief Wraps an Id that was obtained from StringPool::shared()
+    */
+    static InternedString fromId(StringPool::Id id) {
+        InternedString result;
+        result.id = id;
+        return result;
+    }
+
+    StringPool::Id getId() const {
+        return id;
+    }
+
+    const char* c_str() const {
+        return StringPool::shared().c_str(id);
+    }
+
+    unsigned int length() const {
+        return StringPool::shared().length(id);
+    }
+
+    String toString() const {
+        return String(c_str());
+    }
+
+    // Lets an InternedString be printed or passed wherever a C string is expected
+    operator const char*() const {
+        return c_str();
+    }
+
+    bool operator==(const InternedString& other) const {
+        return id == other.id;
+    }
+
+    bool operator!=(const InternedString& other) const {
+        return id != other.id;
+    }
+
+private:
+    StringPool::Id id;
+};
+
+#endif // STRING_POOL_H
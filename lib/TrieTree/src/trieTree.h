@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <Map.h>
 #include <SimpleVector.h>
+#include <StringPool.h>
 
 class TrieTree {
     private:
@@ -24,14 +25,40 @@ class TrieTree {
             }
         }
 
-        void findAllWords(TrieNode* node, String prefix, SimpleVector<String>& words){
+        // word is one buffer shared by the whole walk: each level appends its character and removes it again,
+        // instead of building a new prefix String per node.
+        void findAllWords(TrieNode* node, String& word, SimpleVector<String>& words){
             if(node->isEndOfWord){
-                words.push_back(prefix);
+                words.push_back(word);
             }
             for (auto pair : node->children){
-                findAllWords(pair.second, prefix + pair.first, words);
+                word += pair.first;
+                findAllWords(pair.second, word, words);
+                word.remove(word.length() - 1);
             }
         }
+
+        void findAllWordIds(TrieNode* node, String& word, SimpleVector<StringPool::Id>& ids, StringPool& pool){
+            if(node->isEndOfWord){
+                ids.push_back(pool.intern(word));
+            }
+            for (auto pair : node->children){
+                word += pair.first;
+                findAllWordIds(pair.second, word, ids, pool);
+                word.remove(word.length() - 1);
+            }
+        }
+
+        TrieNode* findNode(const String& prefix){
+            TrieNode* node = root;
+            for (char ch : prefix){
+                if(node->children.count(ch) == 0){
+                    return nullptr;
+                }
+                node = node->children[ch];
+            }
+            return node;
+        }
     public:
         TrieTree() : root(new TrieNode()) {}
 
@@ -83,26 +110,32 @@ class TrieTree {
 
         SimpleVector<String> autoComplete(String prefix){
             SimpleVector<String> words;
-            TrieNode* node = root;
-            for (char ch : prefix){
-                if(node->children.count(ch) == 0){
-                    return words;
-                }
-                node = node->children[ch];
+            TrieNode* node = findNode(prefix);
+            if(node){
+                findAllWords(node, prefix, words);
             }
-            findAllWords(node, prefix, words);
             return words;
         }
 
+        /**
+         * @brief Collects the completions of prefix as Ids in a StringPool instead of separate Strings
+         * @param prefix The prefix to complete
+         * @param ids Receives one Id per completion; repeated queries for the same words reuse the same Ids
+         * @param pool The pool the words are interned in. Owned by the caller, who can clear() it once the Ids are no
+         * longer needed; completions of arbitrary prefixes would otherwise accumulate for the whole run.
+        */
+        void autoCompleteIds(String prefix, SimpleVector<StringPool::Id>& ids, StringPool& pool){
+            TrieNode* node = findNode(prefix);
+            if(node){
+                findAllWordIds(node, prefix, ids, pool);
+            }
+        }
+
         void findAllWordsWithPrefix(String prefix, SimpleVector<String>& words){
-            TrieNode* node = root;
-            for (char ch : prefix){
-                if(node->children.count(ch) == 0){
-                    return;
-                }
-                node = node->children[ch];
+            TrieNode* node = findNode(prefix);
+            if(node){
+                findAllWords(node, prefix, words);
             }
-            findAllWords(node, prefix, words);
         }
 
         void clear(){
@@ -122,14 +155,10 @@ class TrieTree {
         }
 
         void findAllWordsWithSuffix(String suffix, SimpleVector<String>& words){
-            TrieNode* node = root;
-            for (char ch : suffix){
-                if(node->children.count(ch) == 0){
-                    return;
-                }
-                node = node->children[ch];
+            TrieNode* node = findNode(suffix);
+            if(node){
+                findAllWords(node, suffix, words);
             }
-            findAllWords(node, suffix, words);
         }
 
         void deleteWord(String word){
@@ -0,0 +1,95 @@
+/*
+    Example Name: Disk Index Example For B+ Tree Library
+
+    Keeps an index of a log file on an SD card in a DiskBPlusTree: key = sample timestamp, value = byte offset of the
+    record in the log. Only 4 pages of 512 bytes of the index are in RAM at a time, so the index can be far larger
+    than RAM. The index is rebuilt with bulkLoad() when it is missing, then each new record is added with put(), and a
+    time window is read back with rangeScan().
+
+    The same code runs on LittleFS (ESP32, ESP8266, RP2040): include LittleFS.h, use fs::File and open the index file
+    with "r+" (or "w+" when it does not exist yet).
+
+    The circuit:
+    An SD card module on the SPI bus, chip select on pin 4.
+
+    Created  month day year   // 10/18/2026
+    By author's name braydenanderson2014 (Brayden Anderson)
+    Modified day month year  // 10/18/2026
+    By author's name  braydenanderson2014 (Brayden Anderson)
+
+    https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
+
+*/
+#include <SPI.h>
+#include <SD.h>
+#include <DiskBPlusTree.h>
+
+struct Sample {
+    uint32_t timestamp;
+    int16_t reading;
+};
+
+DiskBPlusTree<uint32_t, uint32_t, File> sampleIndex; // timestamp -> offset of the Sample in the log
+File logFile;
+File indexFile;
+
+void setup() {
+    Serial.begin(9600);
+    if (!SD.begin(4)) {
+        Serial.println("SD card failed");
+        return;
+    }
+
+    bool rebuild = !SD.exists("samples.idx");
+    logFile = SD.open("samples.log", O_READ | O_WRITE | O_CREAT);
+    indexFile = SD.open("samples.idx", O_READ | O_WRITE | O_CREAT); // not FILE_WRITE: that appends every write
+    if (!sampleIndex.begin(indexFile)) {
+        Serial.println("samples.idx is not an index of uint32_t keys and values");
+        return;
+    }
+
+    if (rebuild) {
+        // The log is written in timestamp order, so it is already sorted input for bulkLoad()
+        uint32_t offset = 0;
+        sampleIndex.bulkLoad([&offset](uint32_t& key, uint32_t& value) {
+            Sample sample;
+            logFile.seek(offset);
+            if (logFile.read(&sample, sizeof(sample)) != sizeof(sample)) {
+                return false;
+            }
+            key = sample.timestamp;
+            value = offset;
+            offset += sizeof(sample);
+            return true;
+        });
+        sampleIndex.flush();
+    }
+    Serial.print("Indexed samples: ");
+    Serial.println(sampleIndex.size());
+}
+
+void loop() {
+    // Log a sample and index it
+    Sample sample = { millis(), (int16_t)analogRead(A0) };
+    uint32_t offset = logFile.size();
+    logFile.seek(offset);
+    logFile.write((const uint8_t*)&sample, sizeof(sample));
+    logFile.flush();
+    sampleIndex.put(sample.timestamp, offset);
+    sampleIndex.flush();
+
+    // Read back the samples of the last ten seconds
+    uint32_t now = millis();
+    uint32_t count = sampleIndex.rangeScan(now > 10000 ? now - 10000 : 0, now, [](const uint32_t& timestamp, const uint32_t& offset) {
+        Sample found;
+        logFile.seek(offset);
+        logFile.read(&found, sizeof(found));
+        Serial.print(timestamp);
+        Serial.print(": ");
+        Serial.println(found.reading);
+    });
+    Serial.print(count);
+    Serial.println(" samples in the last 10 s");
+
+    delay(1000);
+}
@@ -8,7 +8,7 @@
 
     Created  month day year   // 03/01/2024
     By author's name braydenanderson2014 (Brayden Anderson)
-    Modified day month year  // 03/01/2024
+    Modified day month year  // 10/18/2026
     By author's name  braydenanderson2014 (Brayden Anderson)
 
     https://github.com/braydenanderson2014/C-Arduino-Libraries/tree/Release/README.md
@@ -51,6 +51,13 @@ void setup(){
     } else {
         Serial.println("Key not found");
     }
+
+    // Range scan: every key from 7 to 20 (both included), read along the linked leaves
+    for (int key : tree.rangeScan(7, 20)) {
+        Serial.print(key);
+        Serial.print(" ");
+    }
+    Serial.println();
 }
 
 void loop(){
@@ -0,0 +1,1023 @@
+#ifndef DISK_B_PLUS_TREE_h
+#define DISK_B_PLUS_TREE_h
+
+#include <Arduino.h>
+
+// Bytes per node page. 512 matches the SD card block size, so every page read or write is one block transfer.
+#ifndef DISKBPLUSTREE_PAGE_SIZE
+#define DISKBPLUSTREE_PAGE_SIZE 512
+#endif
+
+// Pages cached in RAM by a DiskBPlusTree (each costs DISKBPLUSTREE_PAGE_SIZE plus a few bytes). At least 3.
+#ifndef DISKBPLUSTREE_POOL_PAGES
+#define DISKBPLUSTREE_POOL_PAGES 4
+#endif
+
+// Deepest tree a DiskBPlusTree will grow to; sizes the root-to-leaf path kept by put().
+#ifndef DISKBPLUSTREE_MAX_HEIGHT
+#define DISKBPLUSTREE_MAX_HEIGHT 12
+#endif
+
+/**
+ * @brief An LRU cache of fixed size pages of a file, with dirty page write-back
+ *
+ * fetch() and create() pin the page they return; the caller release()s it when done, and only unpinned pages are
+ * evicted. A dirty page is written back when it is evicted or on flush().
+ *
+ * FileType is any file class with seek(uint32_t), read(buffer, size), write(buffer, size), size() and flush(): File
+ * from SD.h and fs::File from LittleFS both fit.
+ *
+ * @tparam FileType The file class
+ * @tparam Frames The number of pages kept in RAM
+*/
+template <typename FileType, size_t Frames>
+class DiskPagePool {
+public:
+    static const size_t PAGE_SIZE = DISKBPLUSTREE_PAGE_SIZE;
+
+private:
+    static const uint32_t NO_PAGE = 0xFFFFFFFFUL;
+
+    struct Frame {
+        uint8_t data[PAGE_SIZE];
+        uint32_t page;  // page held by the frame, or NO_PAGE
+        uint32_t used;  // clock value of the last fetch, for LRU
+        uint8_t pins;
+        bool dirty;
+    };
+
+    Frame frames[Frames];
+    FileType* file;
+    uint32_t pagesOnDisk; // pages that exist in the file
+    uint32_t clock;
+    uint32_t reads;
+    uint32_t writes;
+
+    Frame* frameOf(const uint8_t* data) {
+        for (size_t i = 0; i < Frames; i++) {
+            if (frames[i].data == data) {
+                return &frames[i];
+            }
+        }
+        return nullptr;
+    }
+
+    bool readPage(uint32_t page, uint8_t* data) {
+        reads++;
+        return file->seek(page * PAGE_SIZE) && static_cast<size_t>(file->read(data, PAGE_SIZE)) == PAGE_SIZE;
+    }
+
+    bool writePage(uint32_t page, const uint8_t* data) {
+        // SD cannot seek past the end of a file, so a gap (pages created after this one were written first) is
+        // filled with zero pages
+        static const uint8_t zeros[16] = { 0 };
+        while (pagesOnDisk < page) {
+            if (!file->seek(pagesOnDisk * PAGE_SIZE)) {
+                return false;
+            }
+            for (size_t i = 0; i < PAGE_SIZE; i += sizeof(zeros)) {
+                if (file->write(zeros, sizeof(zeros)) != sizeof(zeros)) {
+                    return false;
+                }
+            }
+            pagesOnDisk++;
+        }
+        writes++;
+        if (!file->seek(page * PAGE_SIZE) || file->write(data, PAGE_SIZE) != PAGE_SIZE) {
+            return false;
+        }
+        if (page == pagesOnDisk) {
+            pagesOnDisk++;
+        }
+        return true;
+    }
+
+    bool writeBack(Frame& frame) {
+        if (frame.dirty) {
+            if (!writePage(frame.page, frame.data)) {
+                return false;
+            }
+            frame.dirty = false;
+        }
+        return true;
+    }
+
+    Frame* find(uint32_t page) {
+        for (size_t i = 0; i < Frames; i++) {
+            if (frames[i].page == page) {
+                return &frames[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // A free frame, or the least recently used unpinned one after writing it back; nullptr if every frame is pinned
+    Frame* victim() {
+        Frame* best = nullptr;
+        for (size_t i = 0; i < Frames; i++) {
+            Frame& frame = frames[i];
+            if (frame.page == NO_PAGE) {
+                return &frame;
+            }
+            if (frame.pins == 0 && (best == nullptr || frame.used < best->used)) {
+                best = &frame;
+            }
+        }
+        if (best == nullptr || !writeBack(*best)) {
+            return nullptr;
+        }
+        best->page = NO_PAGE;
+        return best;
+    }
+
+    uint8_t* pin(Frame* frame) {
+        frame->pins++;
+        frame->used = ++clock;
+        return frame->data;
+    }
+
+public:
+    DiskPagePool() : file(nullptr), pagesOnDisk(0), clock(0), reads(0), writes(0) {
+        discard();
+    }
+
+    /**
+     * @brief Use a file. Cached pages of a previous file must have been flushed.
+     *
+     * @param pages - the number of whole pages in the file
+    */
+    void attach(FileType& newFile, uint32_t pages) {
+        discard();
+        file = &newFile;
+        pagesOnDisk = pages;
+    }
+
+    /**
+     * @brief Get a page, reading it from the file unless it is cached, and pin it
+     *
+     * @return uint8_t* - the page data, or nullptr on a read error or when every frame is pinned
+    */
+    uint8_t* fetch(uint32_t page) {
+        Frame* frame = find(page);
+        if (frame == nullptr) {
+            frame = victim();
+            if (frame == nullptr || !readPage(page, frame->data)) {
+                return nullptr;
+            }
+            frame->page = page;
+            frame->dirty = false;
+            frame->pins = 0;
+        }
+        return pin(frame);
+    }
+
+    /**
+     * @brief Get a zeroed, dirty frame for a page that is not in the file yet (no read), and pin it
+    */
+    uint8_t* create(uint32_t page) {
+        Frame* frame = find(page);
+        if (frame == nullptr) {
+            frame = victim();
+            if (frame == nullptr) {
+                return nullptr;
+            }
+            frame->page = page;
+            frame->pins = 0;
+        }
+        memset(frame->data, 0, PAGE_SIZE);
+        frame->dirty = true;
+        return pin(frame);
+    }
+
+    void markDirty(uint8_t* data) {
+        frameOf(data)->dirty = true;
+    }
+
+    void release(uint8_t* data) {
+        frameOf(data)->pins--;
+    }
+
+    /**
+     * @brief Write every dirty page back, lowest page first, and flush the file
+    */
+    bool flush() {
+        while (true) {
+            Frame* lowest = nullptr;
+            for (size_t i = 0; i < Frames; i++) {
+                if (frames[i].dirty && (lowest == nullptr || frames[i].page < lowest->page)) {
+                    lowest = &frames[i];
+                }
+            }
+            if (lowest == nullptr) {
+                break;
+            }
+            if (!writeBack(*lowest)) {
+                return false;
+            }
+        }
+        file->flush();
+        return true;
+    }
+
+    /**
+     * @brief Drop every cached page without writing it back
+    */
+    void discard() {
+        for (size_t i = 0; i < Frames; i++) {
+            frames[i].page = NO_PAGE;
+            frames[i].pins = 0;
+            frames[i].dirty = false;
+            frames[i].used = 0;
+        }
+    }
+
+    uint32_t pageReads() const {
+        return reads;
+    }
+
+    uint32_t pageWrites() const {
+        return writes;
+    }
+};
+
+/**
+ * @brief A B+ Tree stored in a file, one node per DISKBPLUSTREE_PAGE_SIZE page, for indexes larger than RAM
+ *
+ * Leaves hold keys and values and are chained in key order; internal nodes hold separator keys and child page
+ * numbers. Only DISKBPLUSTREE_POOL_PAGES pages are in RAM at a time (a DiskPagePool with LRU eviction and dirty page
+ * write-back), so a lookup costs one page read per level on a cache miss: a 4 level tree of 8 byte entries indexes
+ * over 10 million records.
+ *
+ * Page 0 holds a header (sizes, root page, record count); pages are never freed, and records are not removed (the
+ * index is for append-mostly logs). Appending keys in increasing order keeps every page full, and bulkLoad() builds
+ * a tree from sorted input bottom up, writing each page once.
+ *
+ * Call flush() before the file is closed: changes stay in the pool until their page is evicted or flushed.
+ *
+ * @tparam Key The key type, compared with <; copied to disk byte for byte, so no pointers (String will not work)
+ * @tparam Value The value type, copied byte for byte too (e.g. the offset of a record in the log file)
+ * @tparam FileType File (SD.h), fs::File (LittleFS) or any class with the same seek/read/write/size/flush methods
+ * @tparam PoolPages The number of pages cached in RAM
+*/
+template <typename Key, typename Value, typename FileType, size_t PoolPages = DISKBPLUSTREE_POOL_PAGES>
+class DiskBPlusTree {
+    static_assert(PoolPages >= 3, "DiskBPlusTree needs at least 3 pool pages");
+
+public:
+    static const size_t PAGE_SIZE = DISKBPLUSTREE_PAGE_SIZE;
+
+private:
+    typedef DiskPagePool<FileType, PoolPages> Pool;
+
+    // Node page: leaf flag (1), unused (1), key count (2), next leaf page (4), then the keys, then the values (leaf)
+    // or the child page numbers (internal)
+    static const size_t NODE_HEADER = 8;
+    static const size_t LEAF_CAPACITY = (PAGE_SIZE - NODE_HEADER) / (sizeof(Key) + sizeof(Value));
+    static const size_t INNER_CAPACITY = (PAGE_SIZE - NODE_HEADER - sizeof(uint32_t)) / (sizeof(Key) + sizeof(uint32_t));
+    static_assert(LEAF_CAPACITY >= 3 && INNER_CAPACITY >= 3, "DiskBPlusTree key and value too large for a page");
+
+    static const uint32_t MAGIC = 0x31545042UL; // "BPT1"
+
+    Pool pool;
+    bool attached;
+    bool headerDirty;
+    uint32_t root;      // root page, 0 if the tree is empty
+    uint32_t pages;     // pages in use, including the header
+    uint32_t records;
+    uint32_t firstLeaf; // leftmost leaf, where an in order walk starts
+    uint16_t height;    // levels; 1 when the root is a leaf
+
+    static void put16(uint8_t* page, size_t offset, uint16_t value) {
+        memcpy(page + offset, &value, sizeof(value));
+    }
+
+    static void put32(uint8_t* page, size_t offset, uint32_t value) {
+        memcpy(page + offset, &value, sizeof(value));
+    }
+
+    static uint16_t get16(const uint8_t* page, size_t offset) {
+        uint16_t value;
+        memcpy(&value, page + offset, sizeof(value));
+        return value;
+    }
+
+    static uint32_t get32(const uint8_t* page, size_t offset) {
+        uint32_t value;
+        memcpy(&value, page + offset, sizeof(value));
+        return value;
+    }
+
+    // Node fields. Everything goes through memcpy, so a Key or Value never has to be aligned inside the page.
+    static bool isLeaf(const uint8_t* node) {
+        return node[0] != 0;
+    }
+
+    static void initNode(uint8_t* node, bool leaf) {
+        node[0] = leaf ? 1 : 0;
+    }
+
+    static uint16_t keyCount(const uint8_t* node) {
+        return get16(node, 2);
+    }
+
+    static void setKeyCount(uint8_t* node, uint16_t n) {
+        put16(node, 2, n);
+    }
+
+    static uint32_t nextLeaf(const uint8_t* node) {
+        return get32(node, 4);
+    }
+
+    static void setNextLeaf(uint8_t* node, uint32_t page) {
+        put32(node, 4, page);
+    }
+
+    static uint8_t* keySlot(uint8_t* node, size_t i) {
+        return node + NODE_HEADER + i * sizeof(Key);
+    }
+
+    static uint8_t* valueSlot(uint8_t* node, size_t i) {
+        return node + NODE_HEADER + LEAF_CAPACITY * sizeof(Key) + i * sizeof(Value);
+    }
+
+    static uint8_t* childSlot(uint8_t* node, size_t i) {
+        return node + NODE_HEADER + INNER_CAPACITY * sizeof(Key) + i * sizeof(uint32_t);
+    }
+
+    static Key keyAt(uint8_t* node, size_t i) {
+        Key key;
+        memcpy(&key, keySlot(node, i), sizeof(Key));
+        return key;
+    }
+
+    static Value valueAt(uint8_t* node, size_t i) {
+        Value value;
+        memcpy(&value, valueSlot(node, i), sizeof(Value));
+        return value;
+    }
+
+    static uint32_t childAt(uint8_t* node, size_t i) {
+        return get32(childSlot(node, i), 0);
+    }
+
+    static void setKey(uint8_t* node, size_t i, const Key& key) {
+        memcpy(keySlot(node, i), &key, sizeof(Key));
+    }
+
+    static void setValue(uint8_t* node, size_t i, const Value& value) {
+        memcpy(valueSlot(node, i), &value, sizeof(Value));
+    }
+
+    static void setChild(uint8_t* node, size_t i, uint32_t page) {
+        put32(childSlot(node, i), 0, page);
+    }
+
+    // Index of the first key not less than k (binary search)
+    static uint16_t keyIndex(uint8_t* node, const Key& k) {
+        uint16_t low = 0;
+        uint16_t high = keyCount(node);
+        while (low < high) {
+            uint16_t mid = (low + high) / 2;
+            if (keyAt(node, mid) < k) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    // Index of the child whose subtree holds k: keys equal to or greater than keys[i] are in child i + 1
+    static uint16_t childIndex(uint8_t* node, const Key& k) {
+        uint16_t low = 0;
+        uint16_t high = keyCount(node);
+        while (low < high) {
+            uint16_t mid = (low + high) / 2;
+            if (k < keyAt(node, mid)) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    }
+
+    // Insert an entry at position i of a leaf with room for it
+    static void insertLeafEntry(uint8_t* leaf, uint16_t i, const Key& key, const Value& value) {
+        uint16_t n = keyCount(leaf);
+        memmove(keySlot(leaf, i + 1), keySlot(leaf, i), (n - i) * sizeof(Key));
+        memmove(valueSlot(leaf, i + 1), valueSlot(leaf, i), (n - i) * sizeof(Value));
+        setKey(leaf, i, key);
+        setValue(leaf, i, value);
+        setKeyCount(leaf, n + 1);
+    }
+
+    // Insert separator key at position i and its right child at position i + 1 of an internal node with room for them
+    static void insertInnerEntry(uint8_t* node, uint16_t i, const Key& key, uint32_t child) {
+        uint16_t n = keyCount(node);
+        memmove(keySlot(node, i + 1), keySlot(node, i), (n - i) * sizeof(Key));
+        memmove(childSlot(node, i + 2), childSlot(node, i + 1), (n - i) * sizeof(uint32_t));
+        setKey(node, i, key);
+        setChild(node, i + 1, child);
+        setKeyCount(node, n + 1);
+    }
+
+    // Move keys [from, n) and children [childFrom, n] of node to the front of an empty node
+    static void moveInner(uint8_t* node, uint16_t from, uint16_t childFrom, uint8_t* right, uint16_t childTo) {
+        uint16_t n = keyCount(node);
+        memcpy(keySlot(right, 0), keySlot(node, from), (n - from) * sizeof(Key));
+        memcpy(childSlot(right, childTo), childSlot(node, childFrom), (n + 1 - childFrom) * sizeof(uint32_t));
+        setKeyCount(right, n - from);
+    }
+
+    uint32_t allocatePage() {
+        headerDirty = true;
+        return pages++;
+    }
+
+    // Smallest key in the subtree of a page
+    bool minKey(uint32_t page, Key& key) {
+        while (true) {
+            uint8_t* node = pool.fetch(page);
+            if (node == nullptr) {
+                return false;
+            }
+            bool leaf = isLeaf(node);
+            if (leaf) {
+                key = keyAt(node, 0);
+            } else {
+                page = childAt(node, 0);
+            }
+            pool.release(node);
+            if (leaf) {
+                return true;
+            }
+        }
+    }
+
+    // Leaf whose key range holds k
+    bool findLeaf(const Key& k, uint32_t& page) {
+        page = root;
+        for (uint16_t level = 1; level < height; level++) {
+            uint8_t* node = pool.fetch(page);
+            if (node == nullptr) {
+                return false;
+            }
+            page = childAt(node, childIndex(node, k));
+            pool.release(node);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Add a separator and the new page to its right to the parents on the path, splitting full ones
+     *
+     * @param path - the internal pages from the root down to the parent of the split page
+     * @param slot - the child index taken at each of them
+     * @param level - the number of pages on the path
+     * @param rightEdge - true if the path always took the last child (keys are being appended)
+    */
+    bool insertSeparator(const uint32_t* path, const uint16_t* slot, uint16_t level, Key key, uint32_t child, bool rightEdge) {
+        while (level > 0) {
+            level--;
+            uint8_t* node = pool.fetch(path[level]);
+            if (node == nullptr) {
+                return false;
+            }
+            uint16_t n = keyCount(node);
+            uint16_t i = slot[level];
+            if (n < INNER_CAPACITY) {
+                insertInnerEntry(node, i, key, child);
+                pool.markDirty(node);
+                pool.release(node);
+                return true;
+            }
+
+            uint32_t rightPage = allocatePage();
+            uint8_t* right = pool.create(rightPage);
+            if (right == nullptr) {
+                pool.release(node);
+                return false;
+            }
+            initNode(right, false);
+            Key up = key;
+            if (rightEdge) {
+                // Appending: the full node stays full and the new node starts with just the new child
+                setChild(right, 0, child);
+            } else {
+                // The node with the new entry would hold INNER_CAPACITY + 1 keys; the one at mid goes up
+                uint16_t mid = INNER_CAPACITY / 2;
+                if (i < mid) {
+                    up = keyAt(node, mid - 1);
+                    moveInner(node, mid, mid, right, 0);
+                    setKeyCount(node, mid - 1);
+                    insertInnerEntry(node, i, key, child);
+                } else if (i == mid) {
+                    moveInner(node, mid, mid + 1, right, 1);
+                    setChild(right, 0, child);
+                    setKeyCount(node, mid);
+                } else {
+                    up = keyAt(node, mid);
+                    moveInner(node, mid + 1, mid + 1, right, 0);
+                    setKeyCount(node, mid);
+                    insertInnerEntry(right, i - mid - 1, key, child);
+                }
+            }
+            pool.markDirty(node);
+            pool.release(node);
+            pool.release(right);
+            key = up;
+            child = rightPage;
+        }
+
+        // The root was split: the tree grows a level
+        uint32_t newRoot = allocatePage();
+        uint8_t* node = pool.create(newRoot);
+        if (node == nullptr) {
+            return false;
+        }
+        initNode(node, false);
+        setKeyCount(node, 1);
+        setKey(node, 0, key);
+        setChild(node, 0, root);
+        setChild(node, 1, child);
+        pool.release(node);
+        root = newRoot;
+        height++;
+        return true;
+    }
+
+public:
+    /**
+     * @brief Iterates records in key order along the leaf chain
+     *
+     * The current record is copied out, so key() and value() do not touch the file; next() reads a page only when it
+     * crosses into the next leaf. Any put() invalidates a cursor.
+    */
+    class Cursor {
+    private:
+        friend class DiskBPlusTree;
+
+        DiskBPlusTree* tree;
+        uint32_t page; // 0 once past the last record
+        uint16_t index;
+        Key currentKey;
+        Value currentValue;
+
+        Cursor(DiskBPlusTree* tree, uint32_t page, uint16_t index) : tree(tree), page(page), index(index) {
+            load();
+        }
+
+        // Copy out the record at page/index, moving on to the next leaf when index is past the end of this one
+        void load() {
+            while (page != 0) {
+                uint8_t* leaf = tree->pool.fetch(page);
+                if (leaf == nullptr) {
+                    page = 0;
+                    return;
+                }
+                if (index < keyCount(leaf)) {
+                    currentKey = keyAt(leaf, index);
+                    currentValue = valueAt(leaf, index);
+                    tree->pool.release(leaf);
+                    return;
+                }
+                uint32_t next = nextLeaf(leaf);
+                tree->pool.release(leaf);
+                page = next;
+                index = 0;
+            }
+        }
+
+    public:
+        /**
+         * @brief Check if the cursor is on a record
+        */
+        bool valid() const {
+            return page != 0;
+        }
+
+        const Key& key() const {
+            return currentKey;
+        }
+
+        const Value& value() const {
+            return currentValue;
+        }
+
+        /**
+         * @brief Move to the next record
+         *
+         * @return bool - false once there are no more records
+        */
+        bool next() {
+            if (page == 0) {
+                return false;
+            }
+            index++;
+            load();
+            return page != 0;
+        }
+    };
+
+    DiskBPlusTree() : attached(false), headerDirty(false), root(0), pages(0), records(0), firstLeaf(0), height(0) {}
+
+    DiskBPlusTree(const DiskBPlusTree&) = delete;
+    DiskBPlusTree& operator=(const DiskBPlusTree&) = delete;
+
+    /**
+     * @brief Open the index in a file, or create an empty one if the file is empty
+     *
+     * The file must be open for reading and writing without append mode: on SD use
+     * SD.open(path, O_READ | O_WRITE | O_CREAT) (FILE_WRITE appends every write), on LittleFS "r+" (or "w+" to start over).
+     *
+     * @return bool - false if the file holds something else (another page size, key or value type) or cannot be read
+    */
+    bool begin(FileType& file) {
+        uint32_t size = file.size();
+        pool.attach(file, size / PAGE_SIZE);
+        attached = false;
+        if (size < PAGE_SIZE) {
+            uint8_t* header = pool.create(0);
+            pool.release(header);
+            root = 0;
+            pages = 1;
+            records = 0;
+            firstLeaf = 0;
+            height = 0;
+            headerDirty = true;
+            attached = true;
+            return flush();
+        }
+
+        uint8_t* header = pool.fetch(0);
+        if (header == nullptr) {
+            return false;
+        }
+        bool valid = get32(header, 0) == MAGIC && get16(header, 4) == PAGE_SIZE && get16(header, 6) == sizeof(Key) &&
+                     get16(header, 8) == sizeof(Value);
+        height = get16(header, 10);
+        root = get32(header, 12);
+        pages = get32(header, 16);
+        records = get32(header, 20);
+        firstLeaf = get32(header, 24);
+        pool.release(header);
+        headerDirty = false;
+        attached = valid;
+        return valid;
+    }
+
+    /**
+     * @brief Write every changed page and the header back to the file
+    */
+    bool flush() {
+        if (!attached) {
+            return false;
+        }
+        if (headerDirty) {
+            uint8_t* header = pool.fetch(0);
+            if (header == nullptr) {
+                return false;
+            }
+            put32(header, 0, MAGIC);
+            put16(header, 4, PAGE_SIZE);
+            put16(header, 6, sizeof(Key));
+            put16(header, 8, sizeof(Value));
+            put16(header, 10, height);
+            put32(header, 12, root);
+            put32(header, 16, pages);
+            put32(header, 20, records);
+            put32(header, 24, firstLeaf);
+            pool.markDirty(header);
+            pool.release(header);
+            headerDirty = false;
+        }
+        return pool.flush();
+    }
+
+    /**
+     * @brief Flush and stop using the file
+    */
+    bool end() {
+        bool flushed = flush();
+        pool.discard();
+        attached = false;
+        return flushed;
+    }
+
+    /**
+     * @brief Insert a record, or replace the value of an existing key
+     *
+     * @return bool - false on a file error
+    */
+    bool put(const Key& key, const Value& value) {
+        if (!attached || height >= DISKBPLUSTREE_MAX_HEIGHT) {
+            return false;
+        }
+        if (root == 0) {
+            uint32_t page = allocatePage();
+            uint8_t* leaf = pool.create(page);
+            if (leaf == nullptr) {
+                return false;
+            }
+            initNode(leaf, true);
+            insertLeafEntry(leaf, 0, key, value);
+            pool.release(leaf);
+            root = firstLeaf = page;
+            height = 1;
+            records = 1;
+            return true;
+        }
+
+        // Walk down, remembering the path for the splits on the way back up
+        uint32_t path[DISKBPLUSTREE_MAX_HEIGHT];
+        uint16_t slot[DISKBPLUSTREE_MAX_HEIGHT];
+        bool rightEdge = true;
+        uint32_t page = root;
+        for (uint16_t level = 0; level + 1 < height; level++) {
+            uint8_t* node = pool.fetch(page);
+            if (node == nullptr) {
+                return false;
+            }
+            uint16_t i = childIndex(node, key);
+            rightEdge = rightEdge && i == keyCount(node);
+            path[level] = page;
+            slot[level] = i;
+            page = childAt(node, i);
+            pool.release(node);
+        }
+
+        uint8_t* leaf = pool.fetch(page);
+        if (leaf == nullptr) {
+            return false;
+        }
+        uint16_t n = keyCount(leaf);
+        uint16_t pos = keyIndex(leaf, key);
+        if (pos < n && !(key < keyAt(leaf, pos))) {
+            setValue(leaf, pos, value);
+            pool.markDirty(leaf);
+            pool.release(leaf);
+            return true;
+        }
+        records++;
+        headerDirty = true;
+        if (n < LEAF_CAPACITY) {
+            insertLeafEntry(leaf, pos, key, value);
+            pool.markDirty(leaf);
+            pool.release(leaf);
+            return true;
+        }
+
+        // Split the full leaf. Appending past the end of the last leaf leaves it full and starts a new one, so
+        // records logged in key order fill every page.
+        uint32_t rightPage = allocatePage();
+        uint8_t* right = pool.create(rightPage);
+        if (right == nullptr) {
+            pool.release(leaf);
+            return false;
+        }
+        initNode(right, true);
+        rightEdge = rightEdge && pos == n;
+        uint16_t split = rightEdge ? n : (n + 1) / 2;
+        memcpy(keySlot(right, 0), keySlot(leaf, split), (n - split) * sizeof(Key));
+        memcpy(valueSlot(right, 0), valueSlot(leaf, split), (n - split) * sizeof(Value));
+        setKeyCount(right, n - split);
+        setKeyCount(leaf, split);
+        setNextLeaf(right, nextLeaf(leaf));
+        setNextLeaf(leaf, rightPage);
+        if (pos < split) {
+            insertLeafEntry(leaf, pos, key, value);
+        } else {
+            insertLeafEntry(right, pos - split, key, value);
+        }
+        Key separator = keyAt(right, 0);
+        pool.markDirty(leaf);
+        pool.release(leaf);
+        pool.release(right);
+        return insertSeparator(path, slot, height - 1, separator, rightPage, rightEdge);
+    }
+
+    /**
+     * @brief Look up a key
+     *
+     * @param value - receives the value if the key is found
+     * @return bool - true if the key is in the index
+    */
+    bool get(const Key& key, Value& value) {
+        uint32_t page;
+        if (!attached || root == 0 || !findLeaf(key, page)) {
+            return false;
+        }
+        uint8_t* leaf = pool.fetch(page);
+        if (leaf == nullptr) {
+            return false;
+        }
+        uint16_t i = keyIndex(leaf, key);
+        bool found = i < keyCount(leaf) && !(key < keyAt(leaf, i));
+        if (found) {
+            value = valueAt(leaf, i);
+        }
+        pool.release(leaf);
+        return found;
+    }
+
+    bool contains(const Key& key) {
+        Value value;
+        return get(key, value);
+    }
+
+    /**
+     * @brief Get a cursor on the first record
+    */
+    Cursor first() {
+        return Cursor(this, attached ? firstLeaf : 0, 0);
+    }
+
+    /**
+     * @brief Get a cursor on the first record whose key is not less than key
+    */
+    Cursor lowerBound(const Key& key) {
+        uint32_t page;
+        if (!attached || root == 0 || !findLeaf(key, page)) {
+            return Cursor(this, 0, 0);
+        }
+        uint8_t* leaf = pool.fetch(page);
+        if (leaf == nullptr) {
+            return Cursor(this, 0, 0);
+        }
+        uint16_t i = keyIndex(leaf, key);
+        pool.release(leaf);
+        return Cursor(this, page, i);
+    }
+
+    /**
+     * @brief Call visit(key, value) for every record with lo <= key <= hi, in key order
+     *
+     * One descent, then the leaf chain: about height + k / LEAF_CAPACITY page reads.
+     *
+     * @return uint32_t - the number of records visited
+    */
+    template <typename Visit>
+    uint32_t rangeScan(const Key& lo, const Key& hi, Visit visit) {
+        uint32_t visited = 0;
+        uint32_t page;
+        if (!attached || root == 0 || hi < lo || !findLeaf(lo, page)) {
+            return 0;
+        }
+        uint8_t* leaf = pool.fetch(page);
+        uint16_t i = leaf != nullptr ? keyIndex(leaf, lo) : 0;
+        while (leaf != nullptr) {
+            uint16_t n = keyCount(leaf);
+            for (; i < n; i++) {
+                Key key = keyAt(leaf, i);
+                if (hi < key) {
+                    pool.release(leaf);
+                    return visited;
+                }
+                visit(key, valueAt(leaf, i));
+                visited++;
+            }
+            uint32_t next = nextLeaf(leaf);
+            pool.release(leaf);
+            leaf = next != 0 ? pool.fetch(next) : nullptr;
+            i = 0;
+        }
+        return visited;
+    }
+
+    /**
+     * @brief Build the index from records in strictly increasing key order, bottom up
+     *
+     * Leaves are filled completely and written in order, then each level of internal nodes is built over the one
+     * below, so every page is written once and nothing is searched or split. The index must be empty.
+     *
+     * @param next - called as next(key, value); fills in the next record and returns true, or returns false at the end
+     * @return bool - false if the index was not empty, a file error occurred, or a key was not greater than the one
+     * before it (the records before it are kept)
+    */
+    template <typename Source>
+    bool bulkLoad(Source next) {
+        if (!attached || root != 0) {
+            return false;
+        }
+        Key key;
+        Value value;
+        if (!next(key, value)) {
+            return true;
+        }
+
+        // Leaves, on consecutive pages
+        uint32_t firstPage = allocatePage();
+        uint32_t lastPage = firstPage;
+        uint8_t* leaf = pool.create(firstPage);
+        if (leaf == nullptr) {
+            return false;
+        }
+        initNode(leaf, true);
+        uint16_t n = 0;
+        bool sorted = true;
+        while (true) {
+            if (n == LEAF_CAPACITY) {
+                lastPage = allocatePage();
+                setKeyCount(leaf, n);
+                setNextLeaf(leaf, lastPage);
+                pool.release(leaf);
+                leaf = pool.create(lastPage);
+                if (leaf == nullptr) {
+                    return false;
+                }
+                initNode(leaf, true);
+                n = 0;
+            }
+            setKey(leaf, n, key);
+            setValue(leaf, n, value);
+            n++;
+            records++;
+            Key previous = key;
+            if (!next(key, value)) {
+                break;
+            }
+            if (!(previous < key)) {
+                sorted = false;
+                break;
+            }
+        }
+        setKeyCount(leaf, n);
+        pool.release(leaf);
+
+        // Internal levels: the children of each level are spread evenly over as few nodes as hold them
+        uint32_t levelFirst = firstPage;
+        uint32_t levelCount = lastPage - firstPage + 1;
+        height = 1;
+        while (levelCount > 1) {
+            uint32_t nodes = (levelCount + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+            uint32_t nextFirst = pages;
+            uint32_t child = levelFirst;
+            for (uint32_t j = 0; j < nodes; j++) {
+                uint32_t children = levelCount / nodes + (j < levelCount % nodes ? 1 : 0);
+                uint8_t* node = pool.create(allocatePage());
+                if (node == nullptr) {
+                    return false;
+                }
+                initNode(node, false);
+                for (uint32_t c = 0; c < children; c++, child++) {
+                    setChild(node, c, child);
+                    if (c > 0) {
+                        Key separator;
+                        if (!minKey(child, separator)) {
+                            pool.release(node);
+                            return false;
+                        }
+                        setKey(node, c - 1, separator);
+                    }
+                }
+                setKeyCount(node, children - 1);
+                pool.release(node);
+            }
+            levelFirst = nextFirst;
+            levelCount = nodes;
+            height++;
+        }
+        root = levelFirst;
+        firstLeaf = firstPage;
+        headerDirty = true;
+        return sorted;
+    }
+
+    /**
+     * @brief Get the number of records
+    */
+    uint32_t size() const {
+        return records;
+    }
+
+    bool isEmpty() const {
+        return records == 0;
+    }
+
+    /**
+     * @brief Get the number of levels (page reads for a lookup that misses the pool)
+    */
+    uint16_t getHeight() const {
+        return height;
+    }
+
+    /**
+     * @brief Get the number of pages in the file, including the header page
+    */
+    uint32_t pageCount() const {
+        return pages;
+    }
+
+    /**
+     * @brief Get the number of page reads and writes since the pool was created
+    */
+    uint32_t pageReads() const {
+        return pool.pageReads();
+    }
+
+    uint32_t pageWrites() const {
+        return pool.pageWrites();
+    }
+};
+#endif // DISK_B_PLUS_TREE_h
@@ -2,271 +2,694 @@
 #define B_PLUS_TREE_h
 
 #include <Arduino.h>
+#include <new>
+
 template <typename T>
 struct BPlusTreeNode {
-    T *keys;
+    T *keys;    // 2t - 1 key slots, stored in the same allocation as the node
     int t;      // Minimum degree (defines the range for number of keys)
-    BPlusTreeNode **C; // Array of child pointers
+    BPlusTreeNode **C; // Array of 2t child pointers (internal nodes only, nullptr in a leaf)
     int n;     // Current number of keys
     bool leaf; // Is true when node is leaf. Otherwise false
+    BPlusTreeNode *next; // Next leaf in key order (leaves only)
+    BPlusTreeNode *prev; // Previous leaf in key order (leaves only)
 };
 
+/**
+ * @brief A B+ Tree of minimum degree t
+ *
+ * Every key lives in a leaf; internal nodes only hold separator copies that route the search (keys equal to or greater
+ * than keys[i] are in C[i + 1]). The leaves are chained in key order through next/prev, so once lowerBound() has
+ * descended to the first key of a range, the rest of the range is read by walking the chain: a range query costs
+ * O(log n + k) instead of one descent per key.
+ *
+ * Like BTree, insert() splits full nodes and remove() fills thin nodes on the way down, in one root-to-leaf loop.
+ * Keys are unique; inserting a key that is already present does nothing.
+*/
 template <typename T>
 class BPlusTree {
 private:
     BPlusTreeNode<T> *root; // Pointer to root node
     int t;  // Minimum degree
+    unsigned char *block; // Nodes of the last buildFromSorted(), allocated together
+    size_t blockBytes;
 
-    void balance(BPlusTreeNode<T>* x) {
-    if (x->n < t - 1) {
-        // If x has fewer than t-1 keys, we need to balance it
-        // Find the sibling node
-        BPlusTreeNode<T>* sibling = getSibling(x);
-
-        if (sibling->n > t - 1) {
-            // If the sibling has more than t-1 keys, borrow a key from it
-            borrowKey(x, sibling);
-        } else {
-            // If the sibling has t-1 keys, merge x and the sibling
-            merge(x, sibling);
-        }
+    static size_t alignUp(size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
     }
-}
 
-BPlusTreeNode<T>* getSibling(BPlusTreeNode<T>* x) {
-    // Find the parent of x
-    BPlusTreeNode<T>* parent = findParent(root, x);
+    size_t keysOffset() const {
+        return alignUp(sizeof(BPlusTreeNode<T>), alignof(T));
+    }
 
-    // Find the index of x in the parent's child array
-    int i;
-    for (i = 0; i < parent->n; i++) {
-        if (parent->C[i] == x) {
-            break;
-        }
+    size_t childrenOffset() const {
+        return alignUp(keysOffset() + (2 * t - 1) * sizeof(T), alignof(BPlusTreeNode<T>*));
     }
 
-    // If x is the leftmost child, return the right sibling
-    if (i == 0) {
-        return parent->C[i + 1];
+    // Bytes of a leaf (keys only) or an internal node (keys and child pointers); also the distance between nodes in a block
+    size_t nodeBytes(bool leaf) const {
+        size_t alignment = alignof(BPlusTreeNode<T>) > alignof(T) ? alignof(BPlusTreeNode<T>) : alignof(T);
+        return alignUp(leaf ? keysOffset() + (2 * t - 1) * sizeof(T) : childrenOffset() + 2 * t * sizeof(BPlusTreeNode<T>*), alignment);
     }
 
-    // If x is the rightmost child, return the left sibling
-    if (i == parent->n) {
-        return parent->C[i - 1];
+    BPlusTreeNode<T>* createNode(bool leaf) {
+        return initNode(static_cast<unsigned char*>(::operator new(nodeBytes(leaf))), leaf);
     }
 
-    // If x is in the middle, return the left sibling
-    return parent->C[i - 1];
-}
+    // Construct a node and its keys (and, for an internal node, its child pointers) in memory of nodeBytes(leaf)
+    BPlusTreeNode<T>* initNode(unsigned char* memory, bool leaf) {
+        BPlusTreeNode<T>* node = new (memory) BPlusTreeNode<T>();
+        node->keys = reinterpret_cast<T*>(memory + keysOffset());
+        for (int i = 0; i < 2 * t - 1; i++) {
+            new (node->keys + i) T();
+        }
+        node->C = leaf ? nullptr : reinterpret_cast<BPlusTreeNode<T>**>(memory + childrenOffset());
+        node->t = t;
+        node->n = 0;
+        node->leaf = leaf;
+        node->next = nullptr;
+        node->prev = nullptr;
+        return node;
+    }
 
-BPlusTreeNode<T>* findParent(BPlusTreeNode<T>* x, BPlusTreeNode<T>* child) {
-    // If the root is the parent of x, return the root
-    if (x == child) {
-        return nullptr;
+    // Nodes from the block are only destroyed here; their memory goes back when the tree is cleared
+    void destroyNode(BPlusTreeNode<T>* node) {
+        for (int i = 0; i < 2 * t - 1; i++) {
+            node->keys[i].~T();
+        }
+        node->~BPlusTreeNode<T>();
+        unsigned char* memory = reinterpret_cast<unsigned char*>(node);
+        if (memory < block || memory >= block + blockBytes) {
+            ::operator delete(static_cast<void*>(node));
+        }
     }
 
-    // If the child is in the child array of x, then x is the parent
-    for (int i = 0; i < x->n + 1; i++) {
-        if (x->C[i] == child) {
-            return x;
+    // Recursion depth is the height of the tree, log_t(n)
+    void destroySubtree(BPlusTreeNode<T>* node) {
+        if (!node->leaf) {
+            for (int i = 0; i <= node->n; i++) {
+                destroySubtree(node->C[i]);
+            }
         }
+        destroyNode(node);
     }
 
-    // If the child is not in the child array of x, recursively find the parent
-    for (int i = 0; i < x->n + 1; i++) {
-        BPlusTreeNode<T>* parent = findParent(x->C[i], child);
-        if (parent != nullptr) {
-            return parent;
+    // Index of the first key in x that is not less than k (binary search)
+    static int keyIndex(BPlusTreeNode<T>* x, const T& k) {
+        int low = 0;
+        int high = x->n;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (x->keys[mid] < k) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
         }
+        return low;
     }
 
-    // If the child is not in any child array, return nullptr
-    return nullptr;
-}
+    // Index of the child of internal node x whose subtree holds k: the number of separators not greater than k
+    static int childIndex(BPlusTreeNode<T>* x, const T& k) {
+        int low = 0;
+        int high = x->n;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (k < x->keys[mid]) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    }
 
-void borrowKey(BPlusTreeNode<T>* x, BPlusTreeNode<T>* sibling) {
-    // Find the parent of x
-    BPlusTreeNode<T>* parent = findParent(root, x);
+    // Descend from the root to the leaf whose key range holds k
+    BPlusTreeNode<T>* findLeaf(const T& k) const {
+        BPlusTreeNode<T>* x = root;
+        while (x != nullptr && !x->leaf) {
+            x = x->C[childIndex(x, k)];
+        }
+        return x;
+    }
 
-    // Find the index of x in the parent's child array
-    int i;
-    for (i = 0; i < parent->n; i++) {
-        if (parent->C[i] == x) {
-            break;
+    static BPlusTreeNode<T>* leftmostLeaf(BPlusTreeNode<T>* x) {
+        while (!x->leaf) {
+            x = x->C[0];
         }
+        return x;
     }
 
-    // If x is the leftmost child, borrow a key from the right sibling
-    if (i == 0) {
-        // Move the parent's key to the left sibling
-        sibling->keys[sibling->n] = parent->keys[i];
-        sibling->n++;
+    static BPlusTreeNode<T>* rightmostLeaf(BPlusTreeNode<T>* x) {
+        while (!x->leaf) {
+            x = x->C[x->n];
+        }
+        return x;
+    }
 
-        // Move the first key of x to the parent
-        parent->keys[i] = x->keys[0];
+    // A utility function to split the full child y of x. i is the index of y in x->C[].
+    // A leaf keeps its first t - 1 keys and hands the last t to a new leaf linked after it; the first key of the new
+    // leaf is copied up as the separator. An internal node moves its middle key up, as in a B-Tree.
+    void splitChild(int i, BPlusTreeNode<T>* y, BPlusTreeNode<T>* x) {
+        BPlusTreeNode<T>* z = createNode(y->leaf);
+        T separator;
+        if (y->leaf) {
+            z->n = t;
+            for (int j = 0; j < t; j++) {
+                z->keys[j] = y->keys[j + t - 1];
+            }
+            separator = z->keys[0];
 
-        // Move the child pointer from the right sibling to x
-        if (!sibling->leaf) {
-            x->C[x->n + 1] = sibling->C[0];
-            for (int j = 0; j < sibling->n; j++) {
-                sibling->C[j] = sibling->C[j + 1];
+            // Link z into the leaf chain after y
+            z->prev = y;
+            z->next = y->next;
+            if (y->next != nullptr) {
+                y->next->prev = z;
             }
+            y->next = z;
+        } else {
+            z->n = t - 1;
+            for (int j = 0; j < t - 1; j++) {
+                z->keys[j] = y->keys[j + t];
+            }
+            for (int j = 0; j < t; j++) {
+                z->C[j] = y->C[j + t];
+            }
+            separator = y->keys[t - 1];
         }
+        y->n = t - 1;
 
-        // Move the keys of x to the left
-        for (int j = 0; j < x->n - 1; j++) {
-            x->keys[j] = x->keys[j + 1];
+        // Make room in x for the new child and the separator
+        for (int j = x->n; j >= i + 1; j--) {
+            x->C[j + 1] = x->C[j];
+        }
+        x->C[i + 1] = z;
+        for (int j = x->n - 1; j >= i; j--) {
+            x->keys[j + 1] = x->keys[j];
         }
+        x->keys[i] = separator;
+        x->n = x->n + 1;
+    }
+
+    // Function to borrow a key from C[idx-1] and insert it into C[idx]
+    void borrowFromPrev(BPlusTreeNode<T>* x, int idx) {
+        BPlusTreeNode<T>* child = x->C[idx];
+        BPlusTreeNode<T>* sibling = x->C[idx - 1];
 
-        // Move the child pointers of x to the left
-        for (int j = 0; j < x->n; j++) {
-            x->C[j] = x->C[j + 1];
+        for (int i = child->n - 1; i >= 0; i--) {
+            child->keys[i + 1] = child->keys[i];
+        }
+        if (child->leaf) {
+            // The last key of the left leaf moves over and becomes the new separator
+            child->keys[0] = sibling->keys[sibling->n - 1];
+            x->keys[idx - 1] = child->keys[0];
+        } else {
+            // Rotate through the parent: the separator comes down, the sibling's last key goes up
+            for (int i = child->n; i >= 0; i--) {
+                child->C[i + 1] = child->C[i];
+            }
+            child->keys[0] = x->keys[idx - 1];
+            child->C[0] = sibling->C[sibling->n];
+            x->keys[idx - 1] = sibling->keys[sibling->n - 1];
         }
+        child->n += 1;
+        sibling->n -= 1;
+    }
 
-        x->n--;
-    } else {
-        // If x is the rightmost child, borrow a key from the left sibling
-        // Move the parent's key to the right sibling
-        for (int j = sibling->n; j > 0; j--) {
-            sibling->keys[j] = sibling->keys[j - 1];
+    // Function to borrow a key from C[idx+1] and place it in C[idx]
+    void borrowFromNext(BPlusTreeNode<T>* x, int idx) {
+        BPlusTreeNode<T>* child = x->C[idx];
+        BPlusTreeNode<T>* sibling = x->C[idx + 1];
+
+        if (child->leaf) {
+            // The first key of the right leaf moves over; its new first key becomes the separator
+            child->keys[child->n] = sibling->keys[0];
+            x->keys[idx] = sibling->keys[1];
+        } else {
+            // Rotate through the parent: the separator comes down, the sibling's first key goes up
+            child->keys[child->n] = x->keys[idx];
+            child->C[child->n + 1] = sibling->C[0];
+            x->keys[idx] = sibling->keys[0];
+            for (int i = 1; i <= sibling->n; ++i) {
+                sibling->C[i - 1] = sibling->C[i];
+            }
         }
-        sibling->keys[0] = parent->keys[i - 1];
-        sibling->n++;
+        for (int i = 1; i < sibling->n; ++i) {
+            sibling->keys[i - 1] = sibling->keys[i];
+        }
+        child->n += 1;
+        sibling->n -= 1;
+    }
 
-        // Move the last key of x to the parent
-        parent->keys[i - 1] = x->keys[x->n - 1];
+    // A function to merge C[idx+1] into C[idx]; C[idx+1] is freed after merging
+    void merge(BPlusTreeNode<T>* x, int idx) {
+        BPlusTreeNode<T>* child = x->C[idx];
+        BPlusTreeNode<T>* sibling = x->C[idx + 1];
 
-        // Move the child pointer from the left sibling to x
-        if (!sibling->leaf) {
-            x->C[x->n + 1] = x->C[x->n];
+        if (child->leaf) {
+            // Leaves are concatenated; the separator only routed between them and is dropped
+            for (int i = 0; i < sibling->n; ++i) {
+                child->keys[child->n + i] = sibling->keys[i];
+            }
+            child->n += sibling->n;
+            child->next = sibling->next;
+            if (sibling->next != nullptr) {
+                sibling->next->prev = child;
+            }
+        } else {
+            // The separator comes down between the two halves, as in a B-Tree
+            child->keys[child->n] = x->keys[idx];
+            for (int i = 0; i < sibling->n; ++i) {
+                child->keys[child->n + 1 + i] = sibling->keys[i];
+            }
+            for (int i = 0; i <= sibling->n; ++i) {
+                child->C[child->n + 1 + i] = sibling->C[i];
+            }
+            child->n += sibling->n + 1;
         }
 
-        // Move the keys of x to the right
+        // Close the gap left in x by the separator and the sibling pointer
+        for (int i = idx + 1; i < x->n; ++i) {
+            x->keys[i - 1] = x->keys[i];
+        }
+        for (int i = idx + 2; i <= x->n; ++i) {
+            x->C[i - 1] = x->C[i];
+        }
         x->n--;
 
-        // Move the child pointers of x to the right
+        destroyNode(sibling);
     }
-}
-
-void merge(BPlusTreeNode<T>* x, BPlusTreeNode<T>* sibling) {
-    // Find the parent of x
-    BPlusTreeNode<T>* parent = findParent(root, x);
 
-    // Find the index of x in the parent's child array
-    int i;
-    for (i = 0; i < parent->n; i++) {
-        if (parent->C[i] == x) {
-            break;
+    // Give child C[idx] at least t keys by borrowing from a sibling or merging with one
+    void fill(BPlusTreeNode<T>* x, int idx) {
+        if (idx != 0 && x->C[idx - 1]->n >= t) {
+            borrowFromPrev(x, idx);
+        } else if (idx != x->n && x->C[idx + 1]->n >= t) {
+            borrowFromNext(x, idx);
+        } else if (idx != x->n) {
+            merge(x, idx);
+        } else {
+            merge(x, idx - 1);
         }
     }
 
-    // If x is the leftmost child, merge it with the right sibling
-    if (i == 0) {
-        // Move the parent's key to the right sibling
-        sibling->keys[sibling->n] = parent->keys[i];
-        sibling->n++;
-
-        // Move the keys of x to the right sibling
-        for (int j = 0; j < x->n; j++) {
-            sibling->keys[sibling->n + j] = x->keys[j];
+public:
+    /**
+     * @brief A cursor on one key of the leaf chain
+     *
+     * ++ and -- follow the leaf links, so stepping costs O(1) amortized. Moving past either end gives end(). Any
+     * insert() or remove() invalidates every iterator.
+    */
+    class Iterator {
+    private:
+        BPlusTreeNode<T>* leaf; // nullptr for end()
+        int index;
+
+    public:
+        Iterator(BPlusTreeNode<T>* leaf = nullptr, int index = 0) : leaf(leaf), index(index) {}
+
+        const T& operator*() const {
+            return leaf->keys[index];
         }
-        sibling->n += x->n;
 
-        // Adjust the child pointers of the right sibling
-        if (!sibling->leaf) {
-            for (int j = 0; j < x->n + 1; j++) {
-                sibling->C[sibling->n + j] = x->C[j];
-            }
+        const T* operator->() const {
+            return leaf->keys + index;
         }
 
-        // Remove the parent's key and pointer
-        for (int j = i; j < parent->n - 1; j++) {
-            parent->keys[j] = parent->keys[j + 1];
+        bool operator==(const Iterator& other) const {
+            return leaf == other.leaf && index == other.index;
         }
-        for (int j = i + 1; j < parent->n; j++) {
-            parent->C[j] = parent->C[j + 1];
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
         }
-        parent->n--;
-    } else {
-        // If x is the rightmost child, merge it with the left sibling
-        // Move the parent's key to x
-        x->keys[x->n] = parent->keys[i - 1];
-        x->n++;
 
-        // Move the keys of the right sibling to x
-        for (int j = 0; j < sibling->n; j++) {
-            x->keys[x->n + j] = sibling->keys[j];
+        Iterator& operator++() {
+            if (leaf != nullptr && ++index == leaf->n) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
         }
-        x->n += sibling->n;
 
-        // Adjust the child pointers of x
-        if (!sibling->leaf) {
-            for (int j = 0; j < sibling->n + 1; j++) {
-                x->C[x->n + j] = sibling->C[j];
+        Iterator& operator--() {
+            if (leaf == nullptr) {
+                return *this;
             }
+            if (index > 0) {
+                index--;
+            } else {
+                leaf = leaf->prev;
+                index = leaf != nullptr ? leaf->n - 1 : 0;
+            }
+            return *this;
         }
 
-        // Remove the parent's key and pointer
-        for (int j = i - 1; j < parent->n - 1; j++) {
-            parent->keys[j] = parent->keys[j + 1];
+        /**
+         * @brief Check if the iterator is on a key (not end())
+        */
+        bool valid() const {
+            return leaf != nullptr;
         }
-        for (int j = i; j < parent->n; j++) {
-            parent->C[j] = parent->C[j + 1];
+    };
+
+    /**
+     * @brief The keys between two iterators, for use in a range based for loop
+    */
+    class Range {
+    private:
+        Iterator first;
+        Iterator last;
+
+    public:
+        Range(const Iterator& first, const Iterator& last) : first(first), last(last) {}
+
+        Iterator begin() const {
+            return first;
+        }
+
+        Iterator end() const {
+            return last;
         }
-        parent->n--;
-    }
-}
 
+        bool isEmpty() const {
+            return first == last;
+        }
+    };
 
-public:
     BPlusTree(int _t) {
-        root = nullptr; 
+        root = nullptr;
+        t = _t;
+        block = nullptr;
+        blockBytes = 0;
+    }
+
+    /**
+     * @brief Construct a tree of minimum degree _t from count keys in ascending order
+     * @see buildFromSorted
+    */
+    template <typename Iterator>
+    BPlusTree(int _t, Iterator first, size_t count) {
+        root = nullptr;
         t = _t;
+        block = nullptr;
+        blockBytes = 0;
+        buildFromSorted(first, count);
+    }
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    ~BPlusTree() {
+        clear();
+    }
+
+    void clear() {
+        if (root != nullptr) {
+            destroySubtree(root);
+        }
+        root = nullptr;
+        ::operator delete(static_cast<void*>(block));
+        block = nullptr;
+        blockBytes = 0;
+    }
+
+    /**
+     * @brief Replace the contents with count keys read from first, which must be in strictly ascending order
+     *
+     * Builds the tree bottom up: the keys are spread evenly over as few leaves as hold them, read once front to back
+     * and chained, then each level of internal nodes is built over the one below with the children spread evenly.
+     * All nodes come from one allocation and nothing is compared or split, so this is O(n). The order is not checked.
+     *
+     * @param first - an iterator (or pointer) to the first key
+     * @param count - the number of keys
+     * @return bool - false if the nodes could not be allocated (the tree is left empty)
+    */
+    template <typename Iterator>
+    bool buildFromSorted(Iterator first, size_t count) {
+        clear();
+        if (count == 0) {
+            return true;
+        }
+        size_t leaves = (count + 2 * t - 2) / (2 * t - 1);
+        size_t innerNodes = 0;
+        for (size_t level = leaves; level > 1; ) {
+            level = (level + 2 * t - 1) / (2 * t);
+            innerNodes += level;
+        }
+        size_t bytes = leaves * nodeBytes(true) + innerNodes * nodeBytes(false);
+        block = static_cast<unsigned char*>(::operator new(bytes));
+        if (block == nullptr) {
+            return false;
+        }
+        blockBytes = bytes;
+
+        // Leaves
+        unsigned char* memory = block;
+        BPlusTreeNode<T>* previous = nullptr;
+        for (size_t j = 0; j < leaves; j++) {
+            BPlusTreeNode<T>* leaf = initNode(memory, true);
+            memory += nodeBytes(true);
+            leaf->n = count / leaves + (j < count % leaves ? 1 : 0);
+            for (int i = 0; i < leaf->n; i++, ++first) {
+                leaf->keys[i] = *first;
+            }
+            leaf->prev = previous;
+            if (previous != nullptr) {
+                previous->next = leaf;
+            }
+            previous = leaf;
+        }
+
+        // Internal levels, each over the nodes of the level below (which are consecutive in the block)
+        unsigned char* level = block;
+        size_t levelCount = leaves;
+        size_t stride = nodeBytes(true);
+        while (levelCount > 1) {
+            size_t nodes = (levelCount + 2 * t - 1) / (2 * t);
+            unsigned char* nextLevel = memory;
+            size_t child = 0;
+            for (size_t j = 0; j < nodes; j++) {
+                BPlusTreeNode<T>* node = initNode(memory, false);
+                memory += nodeBytes(false);
+                size_t children = levelCount / nodes + (j < levelCount % nodes ? 1 : 0);
+                for (size_t c = 0; c < children; c++, child++) {
+                    node->C[c] = reinterpret_cast<BPlusTreeNode<T>*>(level + child * stride);
+                    if (c > 0) {
+                        node->keys[c - 1] = leftmostLeaf(node->C[c])->keys[0];
+                    }
+                }
+                node->n = children - 1;
+            }
+            level = nextLevel;
+            levelCount = nodes;
+            stride = nodeBytes(false);
+        }
+        root = reinterpret_cast<BPlusTreeNode<T>*>(level);
+        return true;
     }
 
     BPlusTreeNode<T>* getRoot() {
         return root;
     }
+
     // A utility function to insert a new key in the subtree rooted with
     // this node. The assumption is, the node must be non-full when this
     // function is called
-    void insertNonFull(BPlusTreeNode<T>* x, T k);
+    void insertNonFull(BPlusTreeNode<T>* x, T k) {
+        // Walk down, splitting any full child before entering it
+        while (!x->leaf) {
+            int i = childIndex(x, k);
+            if (x->C[i]->n == 2 * t - 1) {
+                splitChild(i, x->C[i], x);
+
+                // Keys equal to the new separator belong to the right half
+                if (!(k < x->keys[i])) {
+                    i++;
+                }
+            }
+            x = x->C[i];
+        }
 
-    // A utility function to split the child y of this node. i is index of y in
-    // child array C[].  The Child y must be full when this function is called
-    void splitChild(int i, BPlusTreeNode<T>* y, BPlusTreeNode<T>* x);
+        int i = keyIndex(x, k);
+        if (i < x->n && !(k < x->keys[i])) {
+            return; // already present
+        }
+        for (int j = x->n; j > i; j--) {
+            x->keys[j] = x->keys[j - 1];
+        }
+        x->keys[i] = k;
+        x->n = x->n + 1;
+    }
 
     // Inserts a new key k
-    void insert(T k);
+    void insert(T k) {
+        if (root == nullptr) {
+            root = createNode(true);
+            root->keys[0] = k;
+            root->n = 1;
+            return;
+        }
 
-    // Function to traverse all nodes in a subtree rooted with this node
-    void traverse(BPlusTreeNode<T>* x);
+        // If root is full, then tree grows in height
+        if (root->n == 2 * t - 1) {
+            BPlusTreeNode<T>* s = createNode(false);
+            s->C[0] = root;
+            splitChild(0, root, s);
+            root = s;
+        }
+        insertNonFull(root, k);
+    }
 
-    // Function to search key k in subtree rooted with this node
-    BPlusTreeNode<T>* search(BPlusTreeNode<T>* x, T k);
+    // Function to print the keys in the subtree rooted with this node, in order, by walking its leaves
+    void traverse(BPlusTreeNode<T>* x) {
+        if (x == nullptr) {
+            return;
+        }
+        BPlusTreeNode<T>* last = rightmostLeaf(x);
+        for (BPlusTreeNode<T>* leaf = leftmostLeaf(x); leaf != nullptr; leaf = leaf->next) {
+            for (int i = 0; i < leaf->n; i++) {
+                Serial.print(leaf->keys[i]);
+                Serial.print(" ");
+            }
+            if (leaf == last) {
+                break;
+            }
+        }
+    }
 
+    // Function to traverse the tree
+    void traverse() {
+        traverse(root);
+    }
+
+    // Function to search key k in subtree rooted with this node; returns the leaf holding k, or nullptr
+    BPlusTreeNode<T>* search(BPlusTreeNode<T>* x, T k) {
+        if (x == nullptr) {
+            return nullptr;
+        }
+        while (!x->leaf) {
+            x = x->C[childIndex(x, k)];
+        }
+        int i = keyIndex(x, k);
+        return (i < x->n && !(k < x->keys[i])) ? x : nullptr;
+    }
+
+    // Function to search a key in this tree
+    BPlusTreeNode<T>* search(T k) {
+        return search(root, k);
+    }
+
+    // Function to remove the key k from the tree.
+    // Every child the descent enters is first given at least t keys, so removing
+    // from the leaf at the end never leaves a node below t - 1 keys.
     void remove(T k) {
         if (!root) {
             Serial.println("The tree is empty\n");
             return;
         }
 
-        // Call the remove function for root
-        root->remove(k);
+        BPlusTreeNode<T>* x = root;
+        while (!x->leaf) {
+            int idx = childIndex(x, k);
+            if (x->C[idx]->n < t) {
+                fill(x, idx);
+                idx = childIndex(x, k); // a merge may have moved the key range to C[idx - 1]
+            }
+            x = x->C[idx];
+        }
+
+        int i = keyIndex(x, k);
+        if (i < x->n && !(k < x->keys[i])) {
+            for (int j = i + 1; j < x->n; j++) {
+                x->keys[j - 1] = x->keys[j];
+            }
+            x->n--;
+        } else {
+            Serial.println("The key does not exist in the tree");
+        }
 
         // If the root node has 0 keys, make its first child as the new root
         // if it has a child, otherwise set root as NULL
-        if (root->n==0) {
+        if (root->n == 0) {
             BPlusTreeNode<T> *tmp = root;
             if (root->leaf)
-                root = NULL;
+                root = nullptr;
             else
                 root = root->C[0];
 
             // Free the old root
-            delete tmp;
+            destroyNode(tmp);
+        }
+    }
+
+    /**
+     * @brief Get an iterator on the smallest key
+    */
+    Iterator begin() const {
+        if (root == nullptr) {
+            return end();
+        }
+        return Iterator(leftmostLeaf(root), 0);
+    }
+
+    Iterator end() const {
+        return Iterator();
+    }
+
+    /**
+     * @brief Get an iterator on the largest key (end() if the tree is empty)
+    */
+    Iterator last() const {
+        if (root == nullptr) {
+            return end();
+        }
+        BPlusTreeNode<T>* leaf = rightmostLeaf(root);
+        return Iterator(leaf, leaf->n - 1);
+    }
+
+    /**
+     * @brief Get a cursor on the first key not less than k
+     *
+     * @return Iterator - end() if every key is less than k
+    */
+    Iterator lowerBound(const T& k) const {
+        BPlusTreeNode<T>* leaf = findLeaf(k);
+        if (leaf == nullptr) {
+            return end();
+        }
+        int i = keyIndex(leaf, k);
+        if (i == leaf->n) {
+            // Every key in this leaf is smaller; the answer is the first key of the next leaf
+            return Iterator(leaf->next, 0);
+        }
+        return Iterator(leaf, i);
+    }
+
+    /**
+     * @brief Get a cursor on the first key greater than k
+     *
+     * @return Iterator - end() if no key is greater than k
+    */
+    Iterator upperBound(const T& k) const {
+        Iterator it = lowerBound(k);
+        if (it.valid() && !(k < *it)) {
+            ++it;
+        }
+        return it;
+    }
+
+    /**
+     * @brief Get the keys from lo to hi, both included, in order
+     *
+     * Two descents find the ends of the range; iterating it walks the leaf chain. Usage:
+     * for (const T& key : tree.rangeScan(lo, hi)) { ... }
+    */
+    Range rangeScan(const T& lo, const T& hi) const {
+        if (hi < lo) {
+            return Range(end(), end());
         }
-        return;
+        return Range(lowerBound(lo), upperBound(hi));
     }
 };
-#endif // B_PLUS_TREE_h
\ No newline at end of file
+#endif // B_PLUS_TREE_h
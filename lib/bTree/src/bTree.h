@@ -2,196 +2,242 @@
 #define BTREE_H
 
 #include <Arduino.h>
+#include <new>
 
 template <typename T>
 struct BTreeNode {
-    T *keys;
+    T *keys;       // 2t - 1 key slots, stored in the same allocation as the node
     int t;      // Minimum degree (defines the range for number of keys)
-    BTreeNode **C; // Array of child pointers
+    BTreeNode **C; // Array of 2t child pointers, stored right after the keys
     int n;     // Current number of keys
     bool leaf; // Is true when node is leaf. Otherwise false
 };
 
+/**
+ * @brief A B-Tree of minimum degree t
+ *
+ * Insertion splits full nodes and deletion fills thin nodes on the way down (the single pass algorithm from CLRS), so
+ * neither needs to find a parent again afterwards: every fix-up uses the node the descent is currently in. Both walk
+ * down in a loop, and nodes are searched with binary search, so insert, remove and search cost O(t + log n) key
+ * comparisons plus O(t) key moves per level.
+ *
+ * Each node is one allocation: the node header, then the 2t - 1 keys, then the 2t child pointers.
+*/
 template <typename T>
 class BTree {
 private:
     BTreeNode<T> *root; // Pointer to root node
     int t;  // Minimum degree
+    unsigned char *block; // Nodes of the last buildFromSorted(), allocated together
+    size_t blockBytes;
 
-    void balance(BTreeNode<T>* x) {
-        if (x->n < t - 1) {
-            // If x has fewer than t-1 keys, we need to balance it
-            // Find the sibling node
-            BTreeNode<T>* sibling = getSibling(x);
-
-            if (sibling->n > t - 1) {
-                // If the sibling has more than t-1 keys, borrow a key from it
-                borrowKey(x, sibling);
-            } else {
-                // If the sibling has t-1 keys, merge x and the sibling
-                merge(x, sibling);
-            }
-        }
+    static size_t alignUp(size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
     }
 
-    BTreeNode<T>* getSibling(BTreeNode<T>* x) {
-        // Find the parent of x
-        BTreeNode<T>* parent = findParent(root, x);
-
-        // Find the index of x in the parent's child array
-        int i;
-        for (i = 0; i < parent->n; i++) {
-            if (parent->C[i] == x) {
-                break;
-            }
-        }
+    size_t keysOffset() const {
+        return alignUp(sizeof(BTreeNode<T>), alignof(T));
+    }
 
-        // If x is the leftmost child, return the right sibling
-        if (i == 0) {
-            return parent->C[i + 1];
-        }
+    size_t childrenOffset() const {
+        return alignUp(keysOffset() + (2 * t - 1) * sizeof(T), alignof(BTreeNode<T>*));
+    }
 
-        // If x is the rightmost child, return the left sibling
-        if (i == parent->n) {
-            return parent->C[i - 1];
-        }
+    // Bytes of a node with its keys and child pointers; also the distance between nodes in a block
+    size_t nodeBytes() const {
+        size_t alignment = alignof(BTreeNode<T>) > alignof(T) ? alignof(BTreeNode<T>) : alignof(T);
+        return alignUp(childrenOffset() + 2 * t * sizeof(BTreeNode<T>*), alignment);
+    }
 
-        // If x is in the middle, return the left sibling
-        return parent->C[i - 1];
+    // Construct a node, its keys and its child pointers in memory of nodeBytes()
+    BTreeNode<T>* initNode(unsigned char* memory, bool leaf) {
+        BTreeNode<T>* node = new (memory) BTreeNode<T>();
+        node->keys = reinterpret_cast<T*>(memory + keysOffset());
+        for (int i = 0; i < 2 * t - 1; i++) {
+            new (node->keys + i) T();
+        }
+        node->C = reinterpret_cast<BTreeNode<T>**>(memory + childrenOffset());
+        node->t = t;
+        node->n = 0;
+        node->leaf = leaf;
+        return node;
     }
 
-    BTreeNode<T>* findParent(BTreeNode<T>* x, BTreeNode<T>* child) {
-        // If the root is the parent, return the root
-        if (x->C[0]->leaf) {
-            return x;
-        }
+    BTreeNode<T>* createNode(bool leaf) {
+        return initNode(static_cast<unsigned char*>(::operator new(nodeBytes())), leaf);
+    }
 
-        // If the child is in the child array of x, return x
-        for (int i = 0; i < x->n; i++) {
-            if (x->C[i] == child) {
-                return x;
-            }
+    // Nodes from the block are only destroyed here; their memory goes back when the tree is cleared
+    void destroyNode(BTreeNode<T>* node) {
+        for (int i = 0; i < 2 * t - 1; i++) {
+            node->keys[i].~T();
         }
-
-        // If the child is not in the child array of x, search the children of x
-        for (int i = 0; i < x->n; i++) {
-            BTreeNode<T>* parent = findParent(x->C[i], child);
-            if (parent != nullptr) {
-                return parent;
-            }
+        node->~BTreeNode<T>();
+        unsigned char* memory = reinterpret_cast<unsigned char*>(node);
+        if (memory < block || memory >= block + blockBytes) {
+            ::operator delete(static_cast<void*>(node));
         }
-
-        return nullptr;
     }
 
-    void borrowKey(BTreeNode<T>* x, BTreeNode<T>* sibling) {
-        // Find the parent of x
-        BTreeNode<T>* parent = findParent(root, x);
-
-        // Find the index of x in the parent's child array
-        int i;
-        for (i = 0; i < parent->n; i++) {
-            if (parent->C[i] == x) {
-                break;
+    // Keys in a full subtree of the given height (0 for a leaf): (2t)^(height + 1) - 1, saturating at SIZE_MAX
+    size_t maxKeys(int height) const {
+        const size_t limit = (size_t)-1;
+        size_t keys = 2 * t - 1;
+        for (int h = 0; h < height; h++) {
+            if (keys > (limit - (2 * t - 1)) / (2 * t)) {
+                return limit;
             }
+            keys = keys * 2 * t + 2 * t - 1;
         }
+        return keys;
+    }
 
-        // If x is the leftmost child, borrow a key from the right sibling
-        if (i == 0) {
-            // Move the key from the parent to the left child
-            x->keys[x->n] = parent->keys[i];
-            x->n++;
-
-            // Move the key from the right sibling to the parent
-            parent->keys[i] = sibling->keys[0];
-
-            // Move the child from the right sibling to the left sibling
-            x->C[x->n] = sibling->C[0];
-            for (int j = 0; j < sibling->n - 1; j++) {
-                sibling->keys[j] = sibling->keys[j + 1];
-                sibling->C[j] = sibling->C[j + 1];
-            }
-            sibling->n--;
-        } else {
-            // Move the key from the parent to the right child
-            x->keys[x->n] = parent->keys[i - 1];
-            x->n++;
-
-            // Move the key from the left sibling to the parent
-            parent->keys[i - 1] = sibling->keys[sibling->n - 1];
-
-            // Move the child from the left sibling to the right sibling
-            x->C[x->n] = sibling->C[sibling->n];
-            sibling->n--;
+    // Children of an internal node over count keys: as few as hold them, but at least t below the root
+    size_t childCount(size_t count, int height, bool isRoot) const {
+        size_t span = maxKeys(height - 1);
+        size_t children = count / (span + 1) + 1; // ceil((count + 1) / (span + 1))
+        if (!isRoot && children < (size_t)t) {
+            children = t;
         }
+        return children;
     }
 
-    void merge(BTreeNode<T>* x, BTreeNode<T>* sibling) {
-        // Find the parent of x
-        BTreeNode<T>* parent = findParent(root, x);
+    // Keys given to child j: the count - (children - 1) keys left after the separators, spread evenly
+    static size_t childKeys(size_t count, size_t children, size_t j) {
+        size_t keys = count - (children - 1);
+        return keys / children + (j < keys % children ? 1 : 0);
+    }
 
-        // Find the index of x in the parent's child array
-        int i;
-        for (i = 0; i < parent->n; i++) {
-            if (parent->C[i] == x) {
-                break;
-            }
+    size_t countNodes(size_t count, int height, bool isRoot) const {
+        if (height == 0) {
+            return 1;
         }
+        size_t children = childCount(count, height, isRoot);
+        size_t nodes = 1;
+        for (size_t j = 0; j < children; j++) {
+            nodes += countNodes(childKeys(count, children, j), height - 1, false);
+        }
+        return nodes;
+    }
 
-        // If x is the leftmost child, merge x and the right sibling
-        if (i == 0) {
-            // Move the key from the parent to the right sibling
-            sibling->keys[sibling->n] = parent->keys[i];
-
-            // Move the keys and children from the right sibling to x
-            for (int j = 0; j < x->n; j++) {
-                sibling->keys[sibling->n + 1 + j] = x->keys[j];
-                sibling->C[sibling->n + 1 + j] = x->C[j];
+    // Build a subtree of count keys read in order from next, taking nodes from memory. Recursion depth is the height.
+    template <typename Iterator>
+    BTreeNode<T>* buildSubtree(Iterator& next, size_t count, int height, bool isRoot, unsigned char*& memory) {
+        BTreeNode<T>* node = initNode(memory, height == 0);
+        memory += nodeBytes();
+        if (height == 0) {
+            for (size_t i = 0; i < count; i++, ++next) {
+                node->keys[i] = *next;
             }
-            sibling->C[sibling->n + 1 + x->n] = x->C[x->n];
-
-            // Update the number of keys in the right sibling
-            sibling->n += x->n + 1;
-
-            // Delete x from the parent
-            for (int j = i; j < parent->n - 1; j++) {
-                parent->keys[j] = parent->keys[j + 1];
-                parent->C[j] = parent->C[j + 1];
+            node->n = count;
+            return node;
+        }
+        size_t children = childCount(count, height, isRoot);
+        for (size_t j = 0; j < children; j++) {
+            node->C[j] = buildSubtree(next, childKeys(count, children, j), height - 1, false, memory);
+            if (j + 1 < children) {
+                node->keys[j] = *next;
+                ++next;
             }
-            parent->n--;
-        } else {
-            // Move the key from the parent to x
-            x->keys[x->n] = parent->keys[i - 1];
+        }
+        node->n = children - 1;
+        return node;
+    }
 
-            // Move the keys and children from x to the left sibling
-            for (int j = 0; j < x->n; j++) {
-                sibling->keys[sibling->n + 1 + j] = x->keys[j];
-                sibling->C[sibling->n + 1 + j] = x->C[j];
+    // Recursion depth is the height of the tree, log_t(n)
+    void destroySubtree(BTreeNode<T>* node) {
+        if (!node->leaf) {
+            for (int i = 0; i <= node->n; i++) {
+                destroySubtree(node->C[i]);
             }
-            sibling->C[sibling->n + 1 + x->n] = x->C[x->n];
-
-            // Update the number of keys in the left sibling
-            sibling->n += x->n + 1;
+        }
+        destroyNode(node);
+    }
 
-            // Delete x from the parent
-            for (int j = i - 1; j < parent->n - 1; j++) {
-                parent->keys[j] = parent->keys[j + 1];
-                parent->C[j] = parent->C[j + 1];
+    // Index of the first key greater than k (binary search)
+    int upperBound(BTreeNode<T>* x, const T& k) const {
+        int low = 0;
+        int high = x->n;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (k < x->keys[mid]) {
+                high = mid;
+            } else {
+                low = mid + 1;
             }
-            parent->n--;
         }
+        return low;
     }
 
-    
 public:
     BTree(int _t) {
         root = nullptr; 
         t = _t;
+        block = nullptr;
+        blockBytes = 0;
+    }
+
+    /**
+     * @brief Construct a tree of minimum degree _t from count keys in ascending order
+     * @see buildFromSorted
+    */
+    template <typename Iterator>
+    BTree(int _t, Iterator first, size_t count) {
+        root = nullptr;
+        t = _t;
+        block = nullptr;
+        blockBytes = 0;
+        buildFromSorted(first, count);
+    }
+
+    BTree(const BTree&) = delete;
+    BTree& operator=(const BTree&) = delete;
+
+    ~BTree() {
+        clear();
     }
 
     void clear(){
-        delete root;
+        if (root != nullptr) {
+            destroySubtree(root);
+        }
         root = nullptr;
+        ::operator delete(static_cast<void*>(block));
+        block = nullptr;
+        blockBytes = 0;
+    }
+
+    /**
+     * @brief Replace the contents with count keys read from first, which must be in ascending order
+     *
+     * Builds the tree top down by key counts instead of by insertion: the height is the smallest that holds count
+     * keys, every node gets as few children as hold its keys (at least t below the root) and the keys are spread
+     * evenly, so all leaves are on one level and nodes are nearly full. The keys are read once, front to back, into
+     * nodes taken from one allocation, in O(n) without comparisons or splits. The order is not checked.
+     *
+     * @param first - an iterator (or pointer) to the first key
+     * @param count - the number of keys
+     * @return bool - false if the nodes could not be allocated (the tree is left empty)
+    */
+    template <typename Iterator>
+    bool buildFromSorted(Iterator first, size_t count) {
+        clear();
+        if (count == 0) {
+            return true;
+        }
+        int height = 0;
+        while (maxKeys(height) < count) {
+            height++;
+        }
+        size_t bytes = countNodes(count, height, true) * nodeBytes();
+        block = static_cast<unsigned char*>(::operator new(bytes));
+        if (block == nullptr) {
+            return false;
+        }
+        blockBytes = bytes;
+        unsigned char* memory = block;
+        root = buildSubtree(first, count, height, true, memory);
+        return true;
     }
 
     BTreeNode<T>* getRoot() {
@@ -201,42 +247,34 @@ public:
     // this node. The assumption is, the node must be non-full when this
     // function is called
     void insertNonFull(BTreeNode<T>* x, T k){
-        // Initialize index as index of rightmost element
-        int i = x->n - 1;
-
-        // If this is a leaf node
-        if (x->leaf == true){
-            // The following loop does two things
-            // a) Finds the location of new key to be inserted
-            // b) Moves all greater keys to one place ahead
-            while (i >= 0 && x->keys[i] > k){
-                x->keys[i + 1] = x->keys[i];
-                i--;
-            }
-
-            // Insert the new key at found location
-            x->keys[i + 1] = k;
-            x->n = x->n + 1;
-        } else { // If this node is not leaf
+        // Walk down, splitting any full child before entering it, so the
+        // leaf reached at the end has room for the key
+        while (!x->leaf){
             // Find the child which is going to have the new key
-            while (i >= 0 && x->keys[i] > k){
-                i--;
-            }
+            int i = upperBound(x, k);
 
             // See if the found child is full
-            if (x->C[i + 1]->n == 2 * t - 1){
+            if (x->C[i]->n == 2 * t - 1){
                 // If the child is full, then split it
-                splitChild(i + 1, x->C[i + 1], x);
+                splitChild(i, x->C[i], x);
 
                 // After split, the middle key of C[i] goes up and
                 // C[i] is split into two.  See which of the two is going to
                 // have the new key
-                if (x->keys[i + 1] < k){
+                if (x->keys[i] < k){
                     i++;
                 }
             }
-            insertNonFull(x->C[i + 1], k);
+            x = x->C[i];
+        }
+
+        // Move all greater keys one place ahead and insert the new key
+        int i = upperBound(x, k);
+        for (int j = x->n; j > i; j--){
+            x->keys[j] = x->keys[j - 1];
         }
+        x->keys[i] = k;
+        x->n = x->n + 1;
     }
 
     // A utility function to split the child y of this node. i is index of y in
@@ -244,9 +282,8 @@ public:
     void splitChild(int i, BTreeNode<T>* y, BTreeNode<T>* x){
         // Create a new node which is going to store (t-1) keys
         // of y
-        BTreeNode<T>* z = new BTreeNode<T>;
+        BTreeNode<T>* z = createNode(y->leaf);
         z->n = t - 1;
-        z->leaf = y->leaf;
 
         // Copy the last (t-1) keys of y to z
         for (int j = 0; j < t - 1; j++){
@@ -290,22 +327,14 @@ public:
         // If tree is empty
         if (root == nullptr){
             // Allocate memory for root
-            root = new BTreeNode<T>;
-            root->keys = new T[2 * t - 1];
-            root->C = new BTreeNode<T>*[2 * t];
-            root->leaf = true;
-            root->n = 0;
+            root = createNode(true);
             root->keys[0] = k;
             root->n = 1;
         } else { // If tree is not empty
             // If root is full, then tree grows in height
             if (root->n == 2 * t - 1){
                 // Allocate memory for new root
-                BTreeNode<T>* s = new BTreeNode<T>;
-                s->keys = new T[2 * t - 1];
-                s->C = new BTreeNode<T>*[2 * t];
-                s->leaf = false;
-                s->n = 0;
+                BTreeNode<T>* s = createNode(false);
                 s->C[0] = root;
 
                 // Split the old root and move 1 key to the new root
@@ -351,47 +380,67 @@ public:
 
     // Function to search key k in subtree rooted with this node
     BTreeNode<T>* search(BTreeNode<T>* x, T k){
-        // Find the first key greater than or equal to k
-        int i = 0;
-        while (i < x->n && k > x->keys[i]){
-            i++;
-        }
+        while (x != nullptr){
+            // Find the first key greater than or equal to k
+            int i = findKey(x, k);
 
-        // If the found key is equal to k, return this node
-        if (i < x->n && k == x->keys[i]){
-            return x;
-        }
+            // If the found key is equal to k, return this node
+            if (i < x->n && !(k < x->keys[i])){
+                return x;
+            }
 
-        // If the key is not found here and this is a leaf node
-        if (x->leaf == true){
-            return nullptr;
-        }
+            // If the key is not found here and this is a leaf node
+            if (x->leaf == true){
+                return nullptr;
+            }
 
-        // Go to the appropriate child
-        return search(x->C[i], k);
+            // Go to the appropriate child
+            x = x->C[i];
+        }
+        return nullptr;
     }
 
-    // Function to remove the key k from the subtree rooted with this node
+    // Function to remove the key k from the subtree rooted with this node.
+    // Every child the descent enters is first given at least t keys (by
+    // borrowing from a sibling or merging with one), so removing from the
+    // leaf at the end never leaves a node below t - 1 keys and nothing has
+    // to be fixed on the way back up.
     void remove(BTreeNode<T>* x, T k){
-        int idx = findKey(x, k);
-
-        // The key to be removed is present in this node
-        if (idx < x->n && x->keys[idx] == k){
-            // If the node is a leaf node - removeFromLeaf is called
-            if (x->leaf){
-                removeFromLeaf(x, idx);
-            } else {
-                // If the node is not a leaf node - removeFromNonLeaf is called
-                removeFromNonLeaf(x, idx);
+        while (true){
+            int idx = findKey(x, k);
+
+            // The key to be removed is present in this node
+            if (idx < x->n && !(k < x->keys[idx])){
+                if (x->leaf){
+                    removeFromLeaf(x, idx);
+                    return;
+                }
+                // Replace the key by its predecessor or successor and go on to
+                // delete that one from the child, or merge the two children
+                // around the key and delete it from the merged child
+                if (x->C[idx]->n >= t){
+                    T pred = getPred(x, idx);
+                    x->keys[idx] = pred;
+                    x = x->C[idx];
+                    k = pred;
+                } else if (x->C[idx + 1]->n >= t){
+                    T succ = getSucc(x, idx);
+                    x->keys[idx] = succ;
+                    x = x->C[idx + 1];
+                    k = succ;
+                } else {
+                    merge(x, idx);
+                    x = x->C[idx];
+                }
+                continue;
             }
-        } else {
+
             // If this node is a leaf node, then the key is not present in tree
             if (x->leaf){
                 Serial.println("The key is does not exist in the tree");
                 return;
             }
 
-            // The key to be removed is present in the sub-tree rooted with this node
             // The flag indicates whether the key is present in the sub-tree rooted
             // with the last child of this node
             bool flag = (idx == x->n);
@@ -403,12 +452,12 @@ public:
             }
 
             // If the last child has been merged, it must have merged with the previous
-            // child and so we recurse on the (idx-1)th child. Else, we recurse on the
+            // child and so we continue in the (idx-1)th child. Else, we continue in the
             // (idx)th child which now has at least t keys
             if (flag && idx > x->n){
-                remove(x->C[idx - 1], k);
+                x = x->C[idx - 1];
             } else {
-                remove(x->C[idx], k);
+                x = x->C[idx];
             }
         }
     }
@@ -424,32 +473,6 @@ public:
         x->n--;
     }
 
-    // Function to remove the key present in idx-th position in this node which is a non-leaf node
-    void removeFromNonLeaf(BTreeNode<T>* x, int idx){
-        T k = x->keys[idx];
-
-        // If the child that precedes k (C[idx]) has at least t keys, then find the
-        // predecessor 'pred' of k in the subtree rooted at C[idx]. Replace k by pred.
-        // Recursively delete pred in C[idx]
-        if (x->C[idx]->n >= t){
-            T pred = getPred(x, idx);
-            x->keys[idx] = pred;
-            remove(x->C[idx], pred);
-        } else if (x->C[idx + 1]->n >= t) {
-            // If the child C[idx] has less that t keys, examine C[idx+1]. If C[idx+1] has
-            // at least t keys, then find the successor 'succ' of k in the subtree rooted at
-            // C[idx+1]. Replace k by succ. Recursively delete succ in C[idx+1]
-            T succ = getSucc(x, idx);
-            x->keys[idx] = succ;
-            remove(x->C[idx + 1], succ);
-        } else {
-            // If both C[idx] and C[idx+1] have less that t keys, then merge k and all of C[idx+1]
-            // into C[idx], then free C[idx+1] and recursively delete k from C[idx]
-            merge(x, idx);
-            remove(x->C[idx], k);
-        }
-    }
-
     // Function to get predecessor of keys[idx]
     T getPred(BTreeNode<T>* x, int idx){
         // Keep moving to the right most node until we reach a leaf
@@ -598,16 +621,22 @@ public:
         x->n--;
 
         // Freeing the memory occupied by sibling
-        delete(sibling);
+        destroyNode(sibling);
     }
 
-    // A function to find the key k in the subtree rooted with this node
+    // Index of the first key in x that is not less than k (binary search)
     int findKey(BTreeNode<T>* x, T k){
-        int idx = 0;
-        while (idx < x->n && x->keys[idx] < k){
-            ++idx;
+        int low = 0;
+        int high = x->n;
+        while (low < high){
+            int mid = (low + high) / 2;
+            if (x->keys[mid] < k){
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
         }
-        return idx;
+        return low;
     }
 
     // Function to remove the key k from the tree
@@ -630,7 +659,7 @@ public:
             }
 
             // Free the old root
-            delete(tmp);
+            destroyNode(tmp);
         }
     }
 
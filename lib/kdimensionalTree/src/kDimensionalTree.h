@@ -3,14 +3,22 @@
 
 #include <Arduino.h>
 #include <SimpleVector.h>
+#include <SmallVector.h>
+
+// Coordinates a node stores without a heap allocation; higher dimensional points spill to the heap.
+#ifndef KDTREE_INLINE_DIMENSIONS
+#define KDTREE_INLINE_DIMENSIONS 3
+#endif
 #include <MathLib.h>
 
 template <typename T>
 
 class KDimensionalTree {
     private:
+    typedef SmallVector<T, KDTREE_INLINE_DIMENSIONS> NodePoint;
+
     struct KDimensionalNode {
-        SimpleVector<T> point;
+        NodePoint point;
         KDimensionalNode *left, *right;
     };
     KDimensionalNode *root;
@@ -19,7 +27,7 @@ class KDimensionalTree {
     KDimensionalNode *insert(KDimensionalNode *node, const SimpleVector<T>& point, int depth){
         if(node == nullptr){
             KDimensionalNode *newNode = new KDimensionalNode;
-            newNode->point = point;
+            newNode->point = NodePoint(point);
             newNode->left = NULL;
             newNode->right = NULL;
             return newNode;
@@ -33,14 +41,15 @@ class KDimensionalTree {
         return node;
     }
 
-    bool search(KDimensionalNode* node, const SimpleVector<int>& point, int depth) {
+    template <typename P>
+    bool search(KDimensionalNode* node, const P& point, int depth) {
         // If node is null, the point was not found
         if (node == nullptr) {
             return false;
         }
 
         // If the point is found at node
-        if (node->point == point) {
+        if (samePoint(node->point, point)) {
             return true;
         }
 
@@ -56,7 +65,8 @@ class KDimensionalTree {
         }
     }
 
-    KDimensionalNode *remove(KDimensionalNode *node, const SimpleVector<T>& point, int depth){
+    template <typename P>
+    KDimensionalNode *remove(KDimensionalNode *node, const P& point, int depth){
         if(node == nullptr){
             return node;
         }
@@ -82,7 +92,8 @@ class KDimensionalTree {
         return node;
     }
 
-    KDimensionalNode* nearestNeighbor(KDimensionalNode* node, const SimpleVector<T>& point, int depth){
+    template <typename P>
+    KDimensionalNode* nearestNeighbor(KDimensionalNode* node, const P& point, int depth){
         if(node == nullptr){
             return nullptr;
         }
@@ -101,18 +112,17 @@ class KDimensionalTree {
 
         KDimensionalNode* temp = nearestNeighbor(nextNode, point, depth + 1);
 
-        KDimensionalNode* best = nullptr;
-        if(!temp){
-            best = node;
-        } else if(distance(point, node->point) < distance(point, best->point)){
+        // Keep whichever of this node and the nearest point below it is closer
+        KDimensionalNode* best = node;
+        if(temp && squaredDistance(point, temp->point) < squaredDistance(point, node->point)){
             best = temp;
-        } else {
-            best = node;
         }
 
-        if(distance(best ->point,point) > abs(point[currentDimension] - node->point[currentDimension])){
+        // The other side can only hold a closer point if the splitting plane is nearer than the best so far
+        double planeDistance = (double)point[currentDimension] - (double)node->point[currentDimension];
+        if(squaredDistance(best->point, point) > planeDistance * planeDistance){
             temp = nearestNeighbor(otherNode, point, depth + 1);
-            if(temp && distance(temp->point, point) < distance(best->point, point)){
+            if(temp && squaredDistance(temp->point, point) < squaredDistance(best->point, point)){
                 best = temp;
             }
         }
@@ -126,7 +136,7 @@ class KDimensionalTree {
         int currentDimension = depth % dimension;
 
         if(inRange(node ->point, lower, upper)){
-            points.push_back(node->point);
+            points.push_back(toSimpleVector(node->point));
         }
 
         if(node ->left && lower[currentDimension] <= node->point[currentDimension]){
@@ -138,7 +148,7 @@ class KDimensionalTree {
         }
     }
 
-    bool inRange(const SimpleVector<T>& point, const SimpleVector<T>& lower, const SimpleVector<T>& upper){
+    bool inRange(const NodePoint& point, const SimpleVector<T>& lower, const SimpleVector<T>& upper){
         for(int i = 0; i < dimension; i++){
             if(point[i] < lower[i] || point[i] > upper[i]){
                 return false;
@@ -147,12 +157,34 @@ class KDimensionalTree {
         return true;
     }
 
-    double distance(const SimpleVector<T>& point1, const SimpleVector<T>& point2){
+    // Node points and caller points are different vector types; both index the same way. Nearest neighbour only
+    // compares distances, so the square root is never taken (MathLib's Sqrt(0) is not a number, which broke exact matches).
+    template <typename P, typename Q>
+    double squaredDistance(const P& point1, const Q& point2){
         double sum = 0;
         for(int i = 0; i < dimension; i++){
-            sum += (point1[i] - point2[i]) * (point1[i] - point2[i]);
+            double difference = (double)point1[i] - (double)point2[i];
+            sum += difference * difference;
+        }
+        return sum;
+    }
+
+    template <typename P>
+    bool samePoint(const NodePoint& point1, const P& point2){
+        for(int i = 0; i < dimension; i++){
+            if(point1[i] != point2[i]){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static SimpleVector<T> toSimpleVector(const NodePoint& point){
+        SimpleVector<T> result(point.elements());
+        for(unsigned int i = 0; i < point.elements(); i++){
+            result.put(point[i]);
         }
-        return Sqrt(sum);
+        return result;
     }
 
     public:
@@ -186,9 +218,9 @@ class KDimensionalTree {
         root = nullptr;
     }
     
-    SimpleVector<T>& nearestNeighbour(SimpleVector<T>& point){
-        KDimensionalNode* nearest = nearestNeighbour(root, point, 0);
-        return nearest ? nearest->point : SimpleVector<T>();
+    SimpleVector<T> nearestNeighbour(SimpleVector<T>& point){
+        KDimensionalNode* nearest = nearestNeighbor(root, point, 0);
+        return nearest ? toSimpleVector(nearest->point) : SimpleVector<T>();
     }
 
     SimpleVector<SimpleVector<T>> rangeSearch(SimpleVector<T>& lower, SimpleVector<T>& upper){
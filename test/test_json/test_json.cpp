@@ -0,0 +1,238 @@
+/*
+ * JSON document tests. A document is read from memory, written back out and read again, checking that numbers,
+ * literals, strings and empty containers keep their kind through the round trip. Also checks that set(), the Writer
+ * and the Reader agree on the deepest nesting they accept, and that set() adds array elements only at the end.
+*/
+#include <Arduino.h>
+#include <unity.h>
+#include <JSON.h>
+
+// Stream over a fixed text for reading, and a Print that collects the written document
+class TextStream : public Stream {
+    public:
+        TextStream(const char* text) : text(text), position(0) {}
+
+        int available() {
+            return text[position] != '\0' ? 1 : 0;
+        }
+
+        int read() {
+            return text[position] != '\0' ? (unsigned char)text[position++] : -1;
+        }
+
+        int peek() {
+            return text[position] != '\0' ? (unsigned char)text[position] : -1;
+        }
+
+        size_t write(uint8_t) {
+            return 0;
+        }
+
+    private:
+        const char* text;
+        size_t position;
+};
+
+class TextPrint : public Print {
+    public:
+        char text[1024];
+        size_t length;
+
+        TextPrint() : length(0) {
+            text[0] = '\0';
+        }
+
+        size_t write(uint8_t c) {
+            if (length + 1 >= sizeof(text)) {
+                return 0;
+            }
+            text[length++] = (char)c;
+            text[length] = '\0';
+            return 1;
+        }
+};
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_roundTripKeepsValueKinds(void) {
+    TextStream in("{\"b\":1,\"t\":true,\"n\":null,\"f\":-2.5,\"s\":\"1\",\"o\":{},\"a\":[],\"l\":[1,\"x\",false]}");
+    JSON document;
+    TEST_ASSERT_TRUE(document.readFrom(in));
+    TEST_ASSERT_EQUAL_STRING("1", document.get("b"));
+    TEST_ASSERT_EQUAL_STRING("x", document.get("l.1"));
+
+    TextPrint out;
+    document.writeTo(out);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\n"
+        "  \"b\": 1,\n"
+        "  \"t\": true,\n"
+        "  \"n\": null,\n"
+        "  \"f\": -2.5,\n"
+        "  \"s\": \"1\",\n"
+        "  \"o\": {},\n"
+        "  \"a\": [],\n"
+        "  \"l\": [\n"
+        "    1,\n"
+        "    \"x\",\n"
+        "    false\n"
+        "  ]\n"
+        "}\n", out.text);
+
+    // Reading the written document back gives the same text again
+    TextStream again(out.text);
+    JSON copy;
+    TEST_ASSERT_TRUE(copy.readFrom(again));
+    TextPrint rewritten;
+    copy.writeTo(rewritten);
+    TEST_ASSERT_EQUAL_STRING(out.text, rewritten.text);
+
+    // A copied document keeps the kinds as well
+    JSON assigned;
+    assigned = copy;
+    TextPrint copied;
+    assigned.writeTo(copied);
+    TEST_ASSERT_EQUAL_STRING(out.text, copied.text);
+}
+
+void test_setStoresStrings(void) {
+    TextStream in("{\"b\":1}");
+    JSON document;
+    TEST_ASSERT_TRUE(document.readFrom(in));
+    document.set("b", "2");
+    document.set("c.d", "3");
+    TextPrint out;
+    document.writeTo(out);
+    TEST_ASSERT_EQUAL_STRING("{\n  \"b\": \"2\",\n  \"c\": {\n    \"d\": \"3\"\n  }\n}\n", out.text);
+}
+
+void test_pathIndexCollision(void) {
+    // These two paths have the same FNV-1a hash, so the index has to tell them apart by their segments
+    TEST_ASSERT_TRUE(JSON::hashKey("k32728.x", 8) == JSON::hashKey("k261234.x", 9));
+    JSON document;
+    document.enablePathIndex();
+    document.set("k32728.x", "A");
+    document.set("k261234.x", "B");
+    for (int round = 0; round < 2; round++) {
+        TEST_ASSERT_EQUAL_STRING("A", document.get("k32728.x"));
+        TEST_ASSERT_EQUAL_STRING("B", document.get("k261234.x"));
+        TEST_ASSERT_EQUAL_STRING("", document.get("k32728"));
+    }
+}
+
+void test_depthLimitRoundTrip(void) {
+    // "a.a. ... .a" with MAX_DEPTH segments: the outer braces plus MAX_DEPTH - 1 nested objects
+    char path[2 * JSON::MAX_DEPTH + 2];
+    unsigned int length = 0;
+    for (unsigned int i = 0; i < JSON::MAX_DEPTH; i++) {
+        path[length++] = 'a';
+        path[length++] = '.';
+    }
+    path[length - 1] = '\0';
+
+    JSON document;
+    TEST_ASSERT_TRUE(document.set(path, "deep"));
+    TextPrint out;
+    TEST_ASSERT_TRUE(document.writeTo(out));
+
+    TextStream in(out.text);
+    JSON copy;
+    TEST_ASSERT_TRUE(copy.readFrom(in));
+    TEST_ASSERT_EQUAL_STRING("deep", copy.get(path));
+    TextPrint rewritten;
+    TEST_ASSERT_TRUE(copy.writeTo(rewritten));
+    TEST_ASSERT_EQUAL_STRING(out.text, rewritten.text);
+
+    // One segment more would need a level the Reader refuses, so set() refuses it and stores nothing
+    path[length - 1] = '.';
+    path[length] = 'a';
+    path[length + 1] = '\0';
+    TEST_ASSERT_FALSE(document.set(path, "deeper"));
+    TEST_ASSERT_EQUAL_STRING("", document.get(path));
+    TextPrint unchanged;
+    TEST_ASSERT_TRUE(document.writeTo(unchanged));
+    TEST_ASSERT_EQUAL_STRING(out.text, unchanged.text);
+
+    // Written by hand, that document is refused by the Writer and by readFrom()
+    TextPrint tooDeep;
+    {
+        JSON::Writer writer(tooDeep);
+        for (unsigned int i = 0; i <= JSON::MAX_DEPTH; i++) {
+            writer.beginObject();
+            writer.key("a");
+        }
+        TEST_ASSERT_FALSE(writer.ok());
+    }
+    char text[5 * (JSON::MAX_DEPTH + 1) + 2];
+    length = 0;
+    for (unsigned int i = 0; i <= JSON::MAX_DEPTH; i++) {
+        memcpy(text + length, "{\"a\":", 5);
+        length += 5;
+    }
+    memcpy(text + length, "1", 2);
+    TextStream deeper(text);
+    TEST_ASSERT_FALSE(copy.readFrom(deeper));
+}
+
+void test_setArrayIndex(void) {
+    TextStream in("{\"arr\":[\"a\",\"b\"]}");
+    JSON document;
+    TEST_ASSERT_TRUE(document.readFrom(in));
+
+    // An index past the end is refused instead of being stored under the next index
+    TEST_ASSERT_FALSE(document.set("arr.5", "x"));
+    TEST_ASSERT_FALSE(document.set("arr.5.k", "x"));
+    TEST_ASSERT_FALSE(document.set("arr.02", "x"));
+    TEST_ASSERT_EQUAL_STRING("", document.get("arr.5"));
+    TEST_ASSERT_EQUAL_STRING("", document.get("arr.2"));
+
+    // Existing elements are overwritten and the next index appends
+    TEST_ASSERT_TRUE(document.set("arr.1", "B"));
+    TEST_ASSERT_TRUE(document.set("arr.2", "c"));
+    TEST_ASSERT_TRUE(document.set("arr.3.k", "d"));
+    TEST_ASSERT_EQUAL_STRING("B", document.get("arr.1"));
+    TEST_ASSERT_EQUAL_STRING("c", document.get("arr.2"));
+    TEST_ASSERT_EQUAL_STRING("d", document.get("arr.3.k"));
+    TextPrint out;
+    document.writeTo(out);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\n"
+        "  \"arr\": [\n"
+        "    \"a\",\n"
+        "    \"B\",\n"
+        "    \"c\",\n"
+        "    {\n"
+        "      \"k\": \"d\"\n"
+        "    }\n"
+        "  ]\n"
+        "}\n", out.text);
+}
+
+void runTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_roundTripKeepsValueKinds);
+    RUN_TEST(test_setStoresStrings);
+    RUN_TEST(test_pathIndexCollision);
+    RUN_TEST(test_depthLimitRoundTrip);
+    RUN_TEST(test_setArrayIndex);
+    UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    delay(2000); // wait for the serial monitor before the test output starts
+    runTests();
+}
+
+void loop() {
+}
+#else
+int main(void) {
+    runTests();
+    return 0;
+}
+#endif
@@ -0,0 +1,87 @@
+/*
+ * KDimensionalTree nearest neighbour tests. The points are chosen so the search has to descend both sides of a
+ * splitting plane: the nearest point sits across the plane from the branch the query descends first.
+*/
+#include <unity.h>
+#include <kDimensionalTree.h>
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static SimpleVector<int> point2(int x, int y) {
+    SimpleVector<int> point;
+    point.push_back(x);
+    point.push_back(y);
+    return point;
+}
+
+static void assertPoint(int x, int y, SimpleVector<int> point) {
+    TEST_ASSERT_EQUAL(2, (int)point.size());
+    TEST_ASSERT_EQUAL(x, point[0]);
+    TEST_ASSERT_EQUAL(y, point[1]);
+}
+
+void test_nearestSingleNode(void) {
+    KDimensionalTree<int> tree(2);
+    tree.insert(point2(3, 4));
+    SimpleVector<int> query = point2(0, 0);
+    assertPoint(3, 4, tree.nearestNeighbour(query));
+}
+
+void test_nearestDescendsBothBranches(void) {
+    KDimensionalTree<int> tree(2);
+    tree.insert(point2(5, 5));  // root splits on x
+    tree.insert(point2(2, 8));  // left subtree, splits on y
+    tree.insert(point2(8, 1));  // right subtree, splits on y
+    tree.insert(point2(1, 2));  // below (2, 8)
+    tree.insert(point2(9, 9));  // above (8, 1)
+    tree.insert(point2(6, 7));  // below (9, 9)
+
+    // Goes left of the root first, but (6, 7) on the right is nearest
+    SimpleVector<int> query = point2(4, 7);
+    assertPoint(6, 7, tree.nearestNeighbour(query));
+
+    // Goes right first and finds (8, 1) on that side
+    query = point2(7, 2);
+    assertPoint(8, 1, tree.nearestNeighbour(query));
+
+    // Deep on the left
+    query = point2(0, 1);
+    assertPoint(1, 2, tree.nearestNeighbour(query));
+
+    // An exact match is its own nearest neighbour
+    query = point2(9, 9);
+    assertPoint(9, 9, tree.nearestNeighbour(query));
+}
+
+void test_nearestEmptyTree(void) {
+    KDimensionalTree<int> tree(2);
+    SimpleVector<int> query = point2(1, 1);
+    TEST_ASSERT_EQUAL(0, (int)tree.nearestNeighbour(query).size());
+}
+
+void runTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_nearestSingleNode);
+    RUN_TEST(test_nearestDescendsBothBranches);
+    RUN_TEST(test_nearestEmptyTree);
+    UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    delay(2000); // wait for the serial monitor before the test output starts
+    runTests();
+}
+
+void loop() {
+}
+#else
+int main(void) {
+    runTests();
+    return 0;
+}
+#endif
@@ -0,0 +1,133 @@
+/*
+ * SPSCQueue tests. On a board they check ordering, full/empty behaviour and index wrap around. In the native
+ * environment (pio test -e native) they also run a stress test: a producer thread pushes a counting sequence in
+ * random batches while the consumer drains it with pop() and popN() and checks that nothing is lost, duplicated
+ * or reordered.
+*/
+#include <unity.h>
+#include <SPSCQueue.h>
+
+#ifndef ARDUINO
+#include <thread>
+#endif
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_pushPopOrder(void) {
+    SPSCQueue<int, 8> queue;
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(queue.push(i));
+    }
+    TEST_ASSERT_TRUE(queue.isFull());
+    TEST_ASSERT_FALSE(queue.push(8));
+    int value = -1;
+    TEST_ASSERT_TRUE(queue.peek(value));
+    TEST_ASSERT_EQUAL(0, value);
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(queue.pop(value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+    TEST_ASSERT_FALSE(queue.pop(value));
+}
+
+void test_batchWrapAround(void) {
+    SPSCQueue<uint16_t, 16> queue;
+    uint16_t next = 0;
+    uint16_t expected = 0;
+    uint16_t in[7];
+    uint16_t out[5];
+    // 1000 rounds wrap the free-running indices many times, including byte indices on AVR
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 7; i++) {
+            in[i] = next + i;
+        }
+        next += queue.pushN(in, 7);
+        size_t got = queue.popN(out, 5);
+        for (size_t i = 0; i < got; i++) {
+            TEST_ASSERT_EQUAL(expected++, out[i]);
+        }
+        TEST_ASSERT_TRUE(queue.count() <= queue.capacity());
+    }
+    TEST_ASSERT_EQUAL((size_t)(uint16_t)(next - expected), queue.count());
+}
+
+#ifndef ARDUINO
+void test_threadStress(void) {
+    static SPSCQueue<uint32_t, 64> queue;
+    const uint32_t total = 200000;
+
+    std::thread producer([&]() {
+        uint32_t next = 0;
+        uint32_t batch[16];
+        unsigned int seed = 1;
+        while (next < total) {
+            seed = seed * 1103515245u + 12345u;
+            size_t n = (seed >> 16) % 16 + 1;
+            if (n > total - next) {
+                n = total - next;
+            }
+            if (n == 1) {
+                if (queue.push(next)) {
+                    next++;
+                }
+                continue;
+            }
+            for (size_t i = 0; i < n; i++) {
+                batch[i] = next + i;
+            }
+            next += queue.pushN(batch, n);
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    uint32_t batch[16];
+    while (expected < total) {
+        if (expected & 1) {
+            uint32_t value;
+            if (queue.pop(value)) {
+                errors += value != expected++;
+            }
+        } else {
+            size_t got = queue.popN(batch, 16);
+            for (size_t i = 0; i < got; i++) {
+                errors += batch[i] != expected++;
+            }
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, errors);
+    TEST_ASSERT_TRUE(queue.isEmpty());
+}
+#endif
+
+void runTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pushPopOrder);
+    RUN_TEST(test_batchWrapAround);
+#ifndef ARDUINO
+    RUN_TEST(test_threadStress);
+#endif
+    UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    delay(2000); // wait for the serial monitor before the test output starts
+    runTests();
+}
+
+void loop() {
+}
+#else
+int main(void) {
+    runTests();
+    return 0;
+}
+#endif